@@ -64,6 +64,11 @@
 #define DB_FEATURE_COFFEE		1
 #endif /* DB_FEATURE_COFFEE */
 
+/* Support B+-tree indexes. */
+#ifndef DB_FEATURE_BTREE
+#define DB_FEATURE_BTREE		0
+#endif /* DB_FEATURE_BTREE */
+
 /* Enable basic data integrity checks. */
 #ifndef DB_FEATURE_INTEGRITY
 #define DB_FEATURE_INTEGRITY		0
@@ -110,6 +115,14 @@
 #define DB_VM_BYTECODE_SIZE		128
 #endif /* DB_VM_BYTECODE_SIZE */
 
+/* The number of tuples that a selection without an index reads at
+   once and evaluates the predicate for, one attribute column at a time.
+   The scan buffers and the stack use of the LVM grow linearly with it.
+   1 processes each tuple on its own. */
+#ifndef DB_SCAN_BATCH_SIZE
+#define DB_SCAN_BATCH_SIZE		1
+#endif /* DB_SCAN_BATCH_SIZE */
+
 /*----------------------------------------------------------------------------*/
 
 /* Language options. */
@@ -206,6 +219,29 @@
 #define DB_HEAP_CACHE_LIMIT		1
 #endif /* DB_HEAP_CACHE_LIMIT */
 
+/* The maximum number of B+-tree indexes. */
+#ifndef DB_BTREE_INDEX_LIMIT
+#define DB_BTREE_INDEX_LIMIT		1
+#endif /* DB_BTREE_INDEX_LIMIT */
+
+/* The number of B+-tree nodes cached in RAM, shared by all B+-trees.
+   The least recently used node is written back when the cache is full. */
+#ifndef DB_BTREE_CACHE_SIZE
+#define DB_BTREE_CACHE_SIZE		4
+#endif /* DB_BTREE_CACHE_SIZE */
+
+/* The size of a B+-tree node in storage. Preferably the page size
+   of the flash memory that Coffee uses. */
+#ifndef DB_BTREE_NODE_SIZE
+#define DB_BTREE_NODE_SIZE		256
+#endif /* DB_BTREE_NODE_SIZE */
+
+/* The maximum number of nodes in a B+-tree, which sets the size of
+   the file reserved for it. */
+#ifndef DB_BTREE_NODE_LIMIT
+#define DB_BTREE_NODE_LIMIT		512
+#endif /* DB_BTREE_NODE_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /* LVM options. */
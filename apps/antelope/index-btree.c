@@ -0,0 +1,818 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *     A B+-tree index for flash memory.
+ *
+ *     The tree is stored in a single file of fixed-size nodes, where
+ *     node N is located at offset N * DB_BTREE_NODE_SIZE. Node 0 holds
+ *     the header of the tree. With the node size set to the flash page
+ *     size, every node update rewrites at most one page, and Coffee
+ *     logs node rewrites as single records.
+ *
+ *     Leaves hold (key, tuple id) pairs in key order and are linked
+ *     from left to right, so a range search descends once to the
+ *     first key of the range and then follows the leaves. An internal
+ *     node holds (lower bound, child) pairs; the bound of its first
+ *     child is never used. Nodes are read through a small LRU cache,
+ *     whose modified nodes are written back when they are evicted or
+ *     when the index is released.
+ *
+ *     When a key is appended to the rightmost leaf, as with timestamps,
+ *     a full node is split by moving only the new entry to a new node,
+ *     so that sequentially filled nodes stay full. Deletions remove
+ *     entries from the leaves without merging nodes.
+ *
+ *     An insertion checks that there are enough free nodes for its
+ *     splits before it changes anything. If a node still cannot be
+ *     read or written back in the middle of a split, the tree is
+ *     marked invalid by setting its root to 0: further operations on
+ *     it fail, and it can no longer be loaded.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "lib/memb.h"
+
+#include "db-options.h"
+#include "index.h"
+#include "result.h"
+#include "storage.h"
+
+#define DEBUG DEBUG_NONE
+#include "net/ip/uip-debug.h"
+
+#if DB_FEATURE_BTREE
+
+typedef int32_t btree_key_t;
+typedef uint32_t btree_value_t;
+typedef uint16_t btree_node_id_t;
+
+/* A node header, and a key and a value per entry. */
+#define NODE_HEADER_SIZE	4
+#define NODE_ENTRY_SIZE		8
+#define NODE_ORDER		((DB_BTREE_NODE_SIZE - NODE_HEADER_SIZE) / \
+				 NODE_ENTRY_SIZE)
+#define MAX_DEPTH		10
+#define ROOT_NODE		1
+/* The number of node rewrites that Coffee logs before merging. */
+#define LOG_RECORDS		8
+
+#if NODE_ORDER < 4 || NODE_ORDER > 255
+#error "DB_BTREE_NODE_SIZE must be at least 36 bytes and at most 2044 bytes."
+#endif
+
+struct btree_node {
+  uint8_t leaf;
+  uint8_t count;
+  /* The right sibling of a leaf, or 0. */
+  btree_node_id_t next;
+  btree_key_t keys[NODE_ORDER];
+  /* Tuple ids in leaves, node ids of the children in internal nodes. */
+  btree_value_t values[NODE_ORDER];
+};
+
+/* Stored in node 0. */
+struct btree_header {
+  btree_node_id_t root;
+  btree_node_id_t node_count;
+};
+
+struct btree {
+  db_storage_id_t fd;
+  struct btree_header header;
+  uint8_t header_dirty;
+};
+typedef struct btree btree_t;
+
+struct node_cache {
+  btree_t *tree;
+  btree_node_id_t id;
+  uint8_t dirty;
+  uint16_t last_use;
+  struct btree_node node;
+};
+
+static struct node_cache node_cache[DB_BTREE_CACHE_SIZE];
+static uint16_t cache_clock;
+MEMB(btrees, btree_t, DB_BTREE_INDEX_LIMIT);
+
+static db_result_t create(index_t *);
+static db_result_t destroy(index_t *);
+static db_result_t load(index_t *);
+static db_result_t release(index_t *);
+static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t delete(index_t *, attribute_value_t *);
+static tuple_id_t get_next(index_iterator_t *);
+
+index_api_t index_btree = {
+  INDEX_BTREE,
+  INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES,
+  create,
+  destroy,
+  load,
+  release,
+  insert,
+  delete,
+  get_next
+};
+
+static int
+node_write(btree_t *tree, btree_node_id_t id, void *data, unsigned size)
+{
+  if(DB_ERROR(storage_write(tree->fd, data,
+                            (unsigned long)id * DB_BTREE_NODE_SIZE, size))) {
+    PRINTF("DB: Failed to write B+-tree node %u\n", (unsigned)id);
+    return 0;
+  }
+  return 1;
+}
+
+static int
+cache_flush(btree_t *tree)
+{
+  int i;
+  int ok;
+
+  ok = 1;
+  for(i = 0; i < DB_BTREE_CACHE_SIZE; i++) {
+    if(node_cache[i].tree == tree && node_cache[i].dirty) {
+      if(node_write(tree, node_cache[i].id, &node_cache[i].node,
+                    sizeof(node_cache[i].node))) {
+        node_cache[i].dirty = 0;
+      } else {
+        ok = 0;
+      }
+    }
+  }
+
+  if(tree->header_dirty) {
+    if(node_write(tree, 0, &tree->header, sizeof(tree->header))) {
+      tree->header_dirty = 0;
+    } else {
+      ok = 0;
+    }
+  }
+
+  return ok;
+}
+
+static void
+cache_invalidate(btree_t *tree)
+{
+  int i;
+
+  for(i = 0; i < DB_BTREE_CACHE_SIZE; i++) {
+    if(node_cache[i].tree == tree) {
+      node_cache[i].tree = NULL;
+    }
+  }
+}
+
+/* Find a cache entry for a node. The least recently used entry is
+   written back and taken if the node is not cached. */
+static struct node_cache *
+cache_get(btree_t *tree, btree_node_id_t id, int *hit)
+{
+  struct node_cache *entry;
+  struct node_cache *victim;
+  int i;
+
+  victim = &node_cache[0];
+  for(i = 0; i < DB_BTREE_CACHE_SIZE; i++) {
+    entry = &node_cache[i];
+    if(entry->tree == tree && entry->id == id) {
+      entry->last_use = ++cache_clock;
+      *hit = 1;
+      return entry;
+    }
+    if(entry->tree == NULL) {
+      victim = entry;
+    } else if(victim->tree != NULL &&
+              (uint16_t)(cache_clock - entry->last_use) >
+              (uint16_t)(cache_clock - victim->last_use)) {
+      victim = entry;
+    }
+  }
+
+  if(victim->tree != NULL && victim->dirty) {
+    if(!node_write(victim->tree, victim->id, &victim->node,
+                   sizeof(victim->node))) {
+      return NULL;
+    }
+  }
+
+  victim->tree = tree;
+  victim->id = id;
+  victim->dirty = 0;
+  victim->last_use = ++cache_clock;
+  *hit = 0;
+  return victim;
+}
+
+static struct node_cache *
+cache_load(btree_t *tree, btree_node_id_t id)
+{
+  struct node_cache *entry;
+  int hit;
+
+  entry = cache_get(tree, id, &hit);
+  if(entry == NULL) {
+    return NULL;
+  }
+
+  if(!hit && DB_ERROR(storage_read(tree->fd, &entry->node,
+                                   (unsigned long)id * DB_BTREE_NODE_SIZE,
+                                   sizeof(entry->node)))) {
+    PRINTF("DB: Failed to read B+-tree node %u\n", (unsigned)id);
+    entry->tree = NULL;
+    return NULL;
+  }
+
+  return entry;
+}
+
+/* Get a node for reading. The pointer is valid until the next call
+   to node_get(), node_modify() or node_new(). */
+static struct btree_node *
+node_get(btree_t *tree, btree_node_id_t id)
+{
+  struct node_cache *entry;
+
+  entry = cache_load(tree, id);
+  return entry == NULL ? NULL : &entry->node;
+}
+
+/* Get a node for modification. */
+static struct btree_node *
+node_modify(btree_t *tree, btree_node_id_t id)
+{
+  struct node_cache *entry;
+
+  entry = cache_load(tree, id);
+  if(entry == NULL) {
+    return NULL;
+  }
+  entry->dirty = 1;
+  return &entry->node;
+}
+
+static void
+tree_invalidate(btree_t *tree)
+{
+  PRINTF("DB: A B+-tree split failed, the index is invalid\n");
+  tree->header.root = 0;
+  tree->header_dirty = 1;
+}
+
+/* Allocate a new, empty node. */
+static struct btree_node *
+node_new(btree_t *tree, btree_node_id_t *id)
+{
+  struct node_cache *entry;
+  int hit;
+
+  if(tree->header.node_count >= DB_BTREE_NODE_LIMIT) {
+    PRINTF("DB: The B+-tree is full\n");
+    return NULL;
+  }
+
+  entry = cache_get(tree, tree->header.node_count, &hit);
+  if(entry == NULL) {
+    return NULL;
+  }
+
+  *id = tree->header.node_count++;
+  tree->header_dirty = 1;
+
+  memset(&entry->node, 0, sizeof(entry->node));
+  entry->dirty = 1;
+  return &entry->node;
+}
+
+/* The position of the first key in a leaf that is not less than key. */
+static int
+leaf_lower_bound(struct btree_node *node, long key)
+{
+  int low, high, middle;
+
+  low = 0;
+  high = node->count;
+  while(low < high) {
+    middle = (low + high) / 2;
+    if(node->keys[middle] < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+/* The position of the first key in a leaf that is greater than key. */
+static int
+leaf_upper_bound(struct btree_node *node, long key)
+{
+  int low, high, middle;
+
+  low = 0;
+  high = node->count;
+  while(low < high) {
+    middle = (low + high) / 2;
+    if(node->keys[middle] <= key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+/* The child of an internal node to descend into. The lower bounds are
+   compared with < when searching for the first occurrence of a key,
+   which may be in a left sibling if a run of equal keys was split. */
+static int
+child_position(struct btree_node *node, long key, int inclusive)
+{
+  int low, high, middle;
+
+  /* The first child is never compared. */
+  low = 1;
+  high = node->count;
+  while(low < high) {
+    middle = (low + high) / 2;
+    if(node->keys[middle] < key || (inclusive && node->keys[middle] == key)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low - 1;
+}
+
+/* Find the leaf where the first key not less than key may be. */
+static btree_node_id_t
+find_leaf(btree_t *tree, long key)
+{
+  struct btree_node *node;
+  btree_node_id_t id;
+  int depth;
+
+  id = tree->header.root;
+  for(depth = 0; depth < MAX_DEPTH; depth++) {
+    node = node_get(tree, id);
+    if(node == NULL) {
+      return 0;
+    }
+    if(node->leaf) {
+      return id;
+    }
+    id = node->values[child_position(node, key, 0)];
+  }
+  return 0;
+}
+
+/* Insert (key, value) at position pos of node id, splitting the node
+   if it is full. On a split, the id of the new right node and its
+   lowest key are stored in new_id and new_key. A failure after the
+   node has been changed invalidates the tree. */
+static int
+node_insert(btree_t *tree, btree_node_id_t id, int pos, int append,
+            btree_key_t key, btree_value_t value,
+            btree_node_id_t *new_id, btree_key_t *new_key)
+{
+  struct btree_node *node;
+  btree_key_t keys[NODE_ORDER + 1];
+  btree_value_t values[NODE_ORDER + 1];
+  btree_node_id_t next;
+  uint8_t leaf;
+  int count;
+  int split;
+
+  *new_id = 0;
+
+  node = node_modify(tree, id);
+  if(node == NULL) {
+    return 0;
+  }
+
+  if(node->count < NODE_ORDER) {
+    memmove(&node->keys[pos + 1], &node->keys[pos],
+            (node->count - pos) * sizeof(node->keys[0]));
+    memmove(&node->values[pos + 1], &node->values[pos],
+            (node->count - pos) * sizeof(node->values[0]));
+    node->keys[pos] = key;
+    node->values[pos] = value;
+    node->count++;
+    return 1;
+  }
+
+  /* Split the full node, with the new entry in place. */
+  count = node->count;
+  memcpy(keys, node->keys, pos * sizeof(keys[0]));
+  memcpy(values, node->values, pos * sizeof(values[0]));
+  keys[pos] = key;
+  values[pos] = value;
+  memcpy(&keys[pos + 1], &node->keys[pos], (count - pos) * sizeof(keys[0]));
+  memcpy(&values[pos + 1], &node->values[pos],
+         (count - pos) * sizeof(values[0]));
+  count++;
+  leaf = node->leaf;
+  next = node->next;
+
+  split = append && pos == count - 1 ? count - 1 : count / 2;
+
+  node->count = split;
+  memcpy(node->keys, keys, split * sizeof(keys[0]));
+  memcpy(node->values, values, split * sizeof(values[0]));
+
+  node = node_new(tree, new_id);
+  if(node == NULL) {
+    tree_invalidate(tree);
+    return 0;
+  }
+
+  node->leaf = leaf;
+  node->next = next;
+  node->count = count - split;
+  memcpy(node->keys, &keys[split], node->count * sizeof(keys[0]));
+  memcpy(node->values, &values[split], node->count * sizeof(values[0]));
+  *new_key = keys[split];
+
+  if(leaf) {
+    node = node_modify(tree, id);
+    if(node == NULL) {
+      tree_invalidate(tree);
+      return 0;
+    }
+    node->next = *new_id;
+  }
+
+  return 1;
+}
+
+static int
+insert_item(btree_t *tree, btree_key_t key, btree_value_t value)
+{
+  struct btree_node *node;
+  btree_node_id_t path[MAX_DEPTH];
+  uint8_t positions[MAX_DEPTH];
+  btree_node_id_t id;
+  btree_node_id_t new_id;
+  btree_key_t new_key;
+  btree_node_id_t old_root;
+  int append;
+  int depth;
+  int pos;
+  int splits;
+
+  /* Descend to the leaf, remembering the path and counting the full
+     nodes above it, which the insertion splits. */
+  append = 1;
+  splits = 0;
+  id = tree->header.root;
+  for(depth = 0;; depth++) {
+    node = node_get(tree, id);
+    if(node == NULL) {
+      return 0;
+    }
+    splits = node->count < NODE_ORDER ? 0 : splits + 1;
+    if(node->leaf) {
+      break;
+    }
+    if(depth == MAX_DEPTH - 1) {
+      PRINTF("DB: The B+-tree is too deep\n");
+      return 0;
+    }
+    pos = child_position(node, key, 1);
+    append = append && pos == node->count - 1;
+    path[depth] = id;
+    positions[depth] = pos;
+    id = node->values[pos];
+  }
+
+  /* A split of the root also makes a new root. */
+  if(splits > depth) {
+    splits++;
+  }
+  if(tree->header.node_count + splits > DB_BTREE_NODE_LIMIT) {
+    PRINTF("DB: The B+-tree is full\n");
+    return 0;
+  }
+
+  pos = leaf_upper_bound(node, key);
+  append = append && node->next == 0;
+  if(!node_insert(tree, id, pos, append, key, value, &new_id, &new_key)) {
+    return 0;
+  }
+
+  /* Insert the new nodes of splits into their parents. */
+  while(new_id != 0 && depth > 0) {
+    depth--;
+    id = path[depth];
+    pos = positions[depth] + 1;
+    if(!node_insert(tree, id, pos, append, new_key, new_id,
+                    &new_id, &new_key)) {
+      /* The new node has no parent. */
+      tree_invalidate(tree);
+      return 0;
+    }
+  }
+
+  if(new_id != 0) {
+    /* The root was split. */
+    old_root = tree->header.root;
+    node = node_new(tree, &id);
+    if(node == NULL) {
+      tree_invalidate(tree);
+      return 0;
+    }
+    node->leaf = 0;
+    node->count = 2;
+    node->keys[0] = 0;
+    node->values[0] = old_root;
+    node->keys[1] = new_key;
+    node->values[1] = new_id;
+    tree->header.root = id;
+  }
+
+  return 1;
+}
+
+static btree_t *
+tree_open(index_t *index)
+{
+  btree_t *tree;
+
+  tree = memb_alloc(&btrees);
+  if(tree == NULL) {
+    PRINTF("DB: Failed to allocate a B+-tree\n");
+    return NULL;
+  }
+
+  /* Nodes are rewritten in place, so the file is not opened through
+     storage_open(), which tells Coffee that it is never rewritten. */
+  tree->fd = cfs_open(index->descriptor_file, CFS_READ | CFS_WRITE);
+  if(tree->fd < 0) {
+    memb_free(&btrees, tree);
+    return NULL;
+  }
+  tree->header_dirty = 0;
+  index->opaque_data = tree;
+
+  return tree;
+}
+
+static void
+tree_close(btree_t *tree)
+{
+  cache_invalidate(tree);
+  storage_close(tree->fd);
+  memb_free(&btrees, tree);
+}
+
+static db_result_t
+create(index_t *index)
+{
+  char *filename;
+  btree_t *tree;
+  struct btree_node *root;
+  btree_node_id_t id;
+
+  filename = storage_generate_file("btree",
+                                   (unsigned long)DB_BTREE_NODE_LIMIT *
+                                   DB_BTREE_NODE_SIZE);
+  if(filename == NULL) {
+    PRINTF("DB: Failed to generate a B+-tree file\n");
+    return DB_INDEX_ERROR;
+  }
+  memcpy(index->descriptor_file, filename, sizeof(index->descriptor_file));
+
+#if DB_FEATURE_COFFEE
+  /* Make each node rewrite a single log record. */
+  cfs_coffee_configure_log(index->descriptor_file,
+                           LOG_RECORDS * DB_BTREE_NODE_SIZE,
+                           DB_BTREE_NODE_SIZE);
+#endif /* DB_FEATURE_COFFEE */
+
+  tree = tree_open(index);
+  if(tree == NULL) {
+    goto error;
+  }
+
+  tree->header.node_count = ROOT_NODE;
+  root = node_new(tree, &id);
+  if(root == NULL) {
+    tree_close(tree);
+    goto error;
+  }
+  root->leaf = 1;
+  tree->header.root = id;
+
+  if(!cache_flush(tree)) {
+    tree_close(tree);
+    goto error;
+  }
+
+  PRINTF("DB: Created a B+-tree index in %s, %u entries per node\n",
+         index->descriptor_file, (unsigned)NODE_ORDER);
+  return DB_OK;
+
+error:
+  cfs_remove(index->descriptor_file);
+  index->descriptor_file[0] = '\0';
+  return DB_INDEX_ERROR;
+}
+
+static db_result_t
+destroy(index_t *index)
+{
+  /* The index has already been released. */
+  cfs_remove(index->descriptor_file);
+  return DB_OK;
+}
+
+static db_result_t
+load(index_t *index)
+{
+  btree_t *tree;
+
+  tree = tree_open(index);
+  if(tree == NULL) {
+    return DB_STORAGE_ERROR;
+  }
+
+  if(DB_ERROR(storage_read(tree->fd, &tree->header, 0,
+                           sizeof(tree->header))) ||
+     tree->header.root < ROOT_NODE ||
+     tree->header.root >= tree->header.node_count) {
+    PRINTF("DB: Invalid B+-tree header in %s\n", index->descriptor_file);
+    tree_close(tree);
+    return DB_STORAGE_ERROR;
+  }
+
+  PRINTF("DB: Loaded a B+-tree index from %s with %u nodes\n",
+         index->descriptor_file, (unsigned)tree->header.node_count);
+  return DB_OK;
+}
+
+static db_result_t
+release(index_t *index)
+{
+  btree_t *tree;
+  db_result_t result;
+
+  tree = index->opaque_data;
+  result = cache_flush(tree) ? DB_OK : DB_STORAGE_ERROR;
+  tree_close(tree);
+  index->opaque_data = NULL;
+
+  return result;
+}
+
+static db_result_t
+insert(index_t *index, attribute_value_t *key, tuple_id_t value)
+{
+  long long_key;
+
+  if(((btree_t *)index->opaque_data)->header.root == 0) {
+    return DB_INDEX_ERROR;
+  }
+
+  long_key = db_value_to_long(key);
+  if(!insert_item((btree_t *)index->opaque_data, (btree_key_t)long_key,
+                  (btree_value_t)value)) {
+    PRINTF("DB: Failed to insert key %ld into a B+-tree index\n", long_key);
+    return DB_INDEX_ERROR;
+  }
+  return DB_OK;
+}
+
+static db_result_t
+delete(index_t *index, attribute_value_t *value)
+{
+  btree_t *tree;
+  struct btree_node *node;
+  btree_node_id_t id;
+  long key;
+  int pos;
+  int end;
+
+  tree = (btree_t *)index->opaque_data;
+  if(tree->header.root == 0) {
+    return DB_INDEX_ERROR;
+  }
+  key = db_value_to_long(value);
+
+  /* Remove every entry with the key, leaving underfull leaves. */
+  for(id = find_leaf(tree, key); id != 0; id = node->next) {
+    node = node_get(tree, id);
+    if(node == NULL) {
+      return DB_INDEX_ERROR;
+    }
+    pos = leaf_lower_bound(node, key);
+    end = leaf_upper_bound(node, key);
+    if(end > pos) {
+      node = node_modify(tree, id);
+      if(node == NULL) {
+        return DB_INDEX_ERROR;
+      }
+      memmove(&node->keys[pos], &node->keys[end],
+              (node->count - end) * sizeof(node->keys[0]));
+      memmove(&node->values[pos], &node->values[end],
+              (node->count - end) * sizeof(node->values[0]));
+      node->count -= end - pos;
+    }
+    if(pos < node->count) {
+      break;
+    }
+  }
+
+  return DB_OK;
+}
+
+/* The position of the iteration is kept in the iterator, so that
+   several iterators can be used at the same time. A node of 0 means
+   that the iteration has ended. */
+static tuple_id_t
+get_next(index_iterator_t *iterator)
+{
+  btree_t *tree;
+  struct btree_node *node;
+  long min;
+  long max;
+
+  tree = (btree_t *)iterator->index->opaque_data;
+  if(tree->header.root == 0) {
+    return INVALID_TUPLE;
+  }
+  min = db_value_to_long(&iterator->min_value);
+  max = db_value_to_long(&iterator->max_value);
+
+  if(iterator->next_item_no == 0) {
+    iterator->btree_node = find_leaf(tree, min);
+    if(iterator->btree_node == 0) {
+      return INVALID_TUPLE;
+    }
+    node = node_get(tree, iterator->btree_node);
+    if(node == NULL) {
+      return INVALID_TUPLE;
+    }
+    iterator->btree_pos = leaf_lower_bound(node, min);
+  }
+
+  while(iterator->btree_node != 0) {
+    node = node_get(tree, iterator->btree_node);
+    if(node == NULL) {
+      return INVALID_TUPLE;
+    }
+    if(iterator->btree_pos >= node->count) {
+      iterator->btree_node = node->next;
+      iterator->btree_pos = 0;
+      continue;
+    }
+    if(node->keys[iterator->btree_pos] > max) {
+      break;
+    }
+    iterator->next_item_no++;
+    return (tuple_id_t)node->values[iterator->btree_pos++];
+  }
+
+  iterator->btree_node = 0;
+  return INVALID_TUPLE;
+}
+
+#endif /* DB_FEATURE_BTREE */
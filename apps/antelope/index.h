@@ -43,7 +43,8 @@ typedef enum {
   INDEX_NONE = 0,
   INDEX_INLINE = 1,
   INDEX_MEMHASH = 2,
-  INDEX_MAXHEAP = 3
+  INDEX_MAXHEAP = 3,
+  INDEX_BTREE = 4
 } index_type_t;
 
 #define INDEX_READY		0x00
@@ -77,6 +78,11 @@ struct index_iterator {
   attribute_value_t max_value;
   tuple_id_t next_item_no;
   tuple_id_t found_items;
+#if DB_FEATURE_BTREE
+  /* The leaf and the position in it where a B+-tree iteration resumes. */
+  uint16_t btree_node;
+  uint8_t btree_pos;
+#endif /* DB_FEATURE_BTREE */
 };
 typedef struct index_iterator index_iterator_t;
 
@@ -97,6 +103,7 @@ typedef struct index_api index_api_t;
 extern index_api_t index_inline;
 extern index_api_t index_maxheap;
 extern index_api_t index_memhash;
+extern index_api_t index_btree;
 
 void index_init(void);
 db_result_t index_create(index_type_t, relation_t *, attribute_t *);
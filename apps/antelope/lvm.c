@@ -69,6 +69,9 @@
 struct variable {
   operand_type_t type;
   operand_value_t value;
+#if DB_SCAN_BATCH_SIZE > 1
+  long *column;
+#endif
   char name[LVM_MAX_NAME_LENGTH + 1];
 };
 typedef struct variable variable_t;
@@ -297,6 +300,193 @@ eval_logic(lvm_instance_t *p, operator_t *op)
   return EXECUTION_ERROR;
 }
 
+#if DB_SCAN_BATCH_SIZE > 1
+/*
+ * The batch evaluator computes the same expressions as eval_expr() and
+ * eval_logic(), but for count tuples at once. Variables bound to a column
+ * take one value per tuple; other operands are the same for all tuples.
+ */
+static void
+operand_to_column(operand_t *operand, long *column, unsigned count)
+{
+  unsigned i;
+  long l;
+
+  if(operand->type == LVM_VARIABLE &&
+     variables[operand->value.id].column != NULL) {
+    memcpy(column, variables[operand->value.id].column,
+           count * sizeof(column[0]));
+    return;
+  }
+
+  l = operand_to_long(operand);
+  for(i = 0; i < count; i++) {
+    column[i] = l;
+  }
+}
+
+static lvm_status_t
+eval_expr_batch(lvm_instance_t *p, operator_t op, long *result,
+                unsigned count)
+{
+  int i;
+  unsigned j;
+  node_type_t type;
+  operator_t *operator;
+  operand_t operand;
+  long value[2][DB_SCAN_BATCH_SIZE];
+  lvm_status_t r;
+
+  for(i = 0; i < 2; i++) {
+    type = get_type(p);
+    switch(type) {
+    case LVM_ARITH_OP:
+      operator = get_operator(p);
+      r = eval_expr_batch(p, *operator, value[i], count);
+      if(LVM_ERROR(r)) {
+	return r;
+      }
+      break;
+    case LVM_OPERAND:
+      get_operand(p, &operand);
+      operand_to_column(&operand, value[i], count);
+      break;
+    default:
+      return SEMANTIC_ERROR;
+    }
+  }
+
+  switch(op) {
+  case LVM_ADD:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] + value[1][j];
+    }
+    break;
+  case LVM_SUB:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] - value[1][j];
+    }
+    break;
+  case LVM_MUL:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] * value[1][j];
+    }
+    break;
+  case LVM_DIV:
+    for(j = 0; j < count; j++) {
+      if(value[1][j] == 0) {
+        return MATH_ERROR;
+      }
+    }
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] / value[1][j];
+    }
+    break;
+  default:
+    return EXECUTION_ERROR;
+  }
+
+  return TRUE;
+}
+
+static lvm_status_t
+eval_logic_batch(lvm_instance_t *p, operator_t *op, uint8_t *result,
+                 unsigned count)
+{
+  int i;
+  unsigned j;
+  lvm_status_t r;
+  operand_t operand;
+  node_type_t type;
+  operator_t *operator;
+  long value[2][DB_SCAN_BATCH_SIZE];
+  uint8_t logic_result[2][DB_SCAN_BATCH_SIZE];
+  unsigned arguments;
+
+  if(IS_CONNECTIVE(*op)) {
+    arguments = *op == LVM_NOT ? 1 : 2;
+    for(i = 0; i < arguments; i++) {
+      type = get_type(p);
+      if(type != LVM_CMP_OP) {
+	return SEMANTIC_ERROR;
+      }
+      operator = get_operator(p);
+      r = eval_logic_batch(p, operator, logic_result[i], count);
+      if(LVM_ERROR(r)) {
+	return r;
+      }
+    }
+
+    for(j = 0; j < count; j++) {
+      if(*op == LVM_NOT) {
+        result[j] = !logic_result[0][j];
+      } else if(*op == LVM_AND) {
+        result[j] = logic_result[0][j] && logic_result[1][j];
+      } else {
+        result[j] = logic_result[0][j] || logic_result[1][j];
+      }
+    }
+    return TRUE;
+  }
+
+  for(i = 0; i < 2; i++) {
+    type = get_type(p);
+    switch(type) {
+    case LVM_ARITH_OP:
+      operator = get_operator(p);
+      r = eval_expr_batch(p, *operator, value[i], count);
+      if(LVM_ERROR(r)) {
+	return r;
+      }
+      break;
+    case LVM_OPERAND:
+      get_operand(p, &operand);
+      operand_to_column(&operand, value[i], count);
+      break;
+    default:
+      return SEMANTIC_ERROR;
+    }
+  }
+
+  switch(*op) {
+  case LVM_EQ:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] == value[1][j];
+    }
+    break;
+  case LVM_NEQ:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] != value[1][j];
+    }
+    break;
+  case LVM_GE:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] > value[1][j];
+    }
+    break;
+  case LVM_GEQ:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] >= value[1][j];
+    }
+    break;
+  case LVM_LE:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] < value[1][j];
+    }
+    break;
+  case LVM_LEQ:
+    for(j = 0; j < count; j++) {
+      result[j] = value[0][j] <= value[1][j];
+    }
+    break;
+  default:
+    return EXECUTION_ERROR;
+  }
+
+  return TRUE;
+}
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
 void
 lvm_reset(lvm_instance_t *p, unsigned char *code, lvm_ip_t size)
 {
@@ -403,6 +593,33 @@ lvm_execute(lvm_instance_t *p)
   return status;
 }
 
+#if DB_SCAN_BATCH_SIZE > 1
+/* Evaluate the predicate for count tuples, whose variable values are
+   taken from the columns set with lvm_set_variable_column(). The truth
+   value for each tuple is stored in result. On an error, such as a
+   division by zero, nothing tells which tuple caused it, so the caller
+   has to evaluate the tuples one by one with lvm_execute(). */
+lvm_status_t
+lvm_execute_batch(lvm_instance_t *p, uint8_t *result, unsigned count)
+{
+  node_type_t type;
+  operator_t *operator;
+
+  if(count > DB_SCAN_BATCH_SIZE) {
+    return EXECUTION_ERROR;
+  }
+
+  p->ip = 0;
+  type = get_type(p);
+  if(type != LVM_CMP_OP) {
+    PRINTF("Error: The code must start with a relational operator\n");
+    return EXECUTION_ERROR;
+  }
+  operator = get_operator(p);
+  return eval_logic_batch(p, operator, result, count);
+}
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
 void
 lvm_set_op(lvm_instance_t *p, operator_t op)
 {
@@ -472,6 +689,21 @@ lvm_set_variable_value(char *name, operand_value_t value)
   return TRUE;
 }
 
+#if DB_SCAN_BATCH_SIZE > 1
+lvm_status_t
+lvm_set_variable_column(char *name, long *column)
+{
+  variable_id_t id;
+
+  id = lookup(name);
+  if(id == LVM_MAX_VARIABLE_ID) {
+    return INVALID_IDENTIFIER;
+  }
+  variables[id].column = column;
+  return TRUE;
+}
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
 void
 lvm_set_variable(lvm_instance_t *p, char *name)
 {
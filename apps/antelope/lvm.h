@@ -130,6 +130,11 @@ void lvm_print_derivations(lvm_instance_t *p);
 lvm_status_t lvm_execute(lvm_instance_t *p);
 lvm_status_t lvm_register_variable(char *name, operand_type_t type);
 lvm_status_t lvm_set_variable_value(char *name, operand_value_t value);
+#if DB_SCAN_BATCH_SIZE > 1
+lvm_status_t lvm_set_variable_column(char *name, long *column);
+lvm_status_t lvm_execute_batch(lvm_instance_t *p, uint8_t *result,
+                               unsigned count);
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
 void lvm_print_code(lvm_instance_t *p);
 lvm_ip_t lvm_jump_to_operand(lvm_instance_t *p);
 lvm_ip_t lvm_shift_for_operator(lvm_instance_t *p, lvm_ip_t end);
@@ -88,6 +88,23 @@ static unsigned char * const left_row = row;
 static unsigned char * const right_row = extra_row;
 static unsigned char * const join_row = result_row;
 
+/* The number of tuples aggregated so far, for computing means. */
+static unsigned long aggregated_tuples;
+
+#if DB_SCAN_BATCH_SIZE > 1
+/*
+ * A selection without an index reads DB_SCAN_BATCH_SIZE rows at a time.
+ * The integer attributes of the batch are decoded into one column per
+ * entry of attr_map, over which the predicate and the aggregators are
+ * evaluated for all tuples at once.
+ */
+static unsigned char batch_rows[DB_SCAN_BATCH_SIZE * sizeof(row)];
+static long batch_columns[AQL_ATTRIBUTE_LIMIT][DB_SCAN_BATCH_SIZE];
+static uint8_t batch_selected[DB_SCAN_BATCH_SIZE];
+static unsigned batch_count;
+static unsigned batch_next;
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
 LIST(relations);
 MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
 MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
@@ -568,9 +585,8 @@ aggregate(attribute_t *attr, attribute_value_t *value)
     attr->aggregation_value++;
     break;
   case AQL_SUM:
-    attr->aggregation_value += long_value;
-    break;
   case AQL_MEAN:
+    attr->aggregation_value += long_value;
     break;
   case AQL_MEDIAN:
     break;
@@ -589,6 +605,46 @@ aggregate(attribute_t *attr, attribute_value_t *value)
   }
 }
 
+#if DB_SCAN_BATCH_SIZE > 1
+static void
+aggregate_column(attribute_t *attr, long *column, unsigned count)
+{
+  unsigned i;
+
+  switch(attr->aggregator) {
+  case AQL_COUNT:
+    for(i = 0; i < count; i++) {
+      attr->aggregation_value += batch_selected[i];
+    }
+    break;
+  case AQL_SUM:
+  case AQL_MEAN:
+    for(i = 0; i < count; i++) {
+      if(batch_selected[i]) {
+        attr->aggregation_value += column[i];
+      }
+    }
+    break;
+  case AQL_MAX:
+    for(i = 0; i < count; i++) {
+      if(batch_selected[i] && column[i] > attr->aggregation_value) {
+        attr->aggregation_value = column[i];
+      }
+    }
+    break;
+  case AQL_MIN:
+    for(i = 0; i < count; i++) {
+      if(batch_selected[i] && column[i] < attr->aggregation_value) {
+        attr->aggregation_value = column[i];
+      }
+    }
+    break;
+  default:
+    break;
+  }
+}
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
 static db_result_t
 generate_attribute_map(struct source_dest_map *attr_map, unsigned attribute_count,
                        relation_t *from_rel, relation_t *to_rel, 
@@ -655,7 +711,7 @@ select_index(db_handle_t *handle, lvm_instance_t *lvm_instance)
 
       if(range <= min_range) {
         index = attr->index;
-        av_min.domain = av_max.domain = DOMAIN_INT;
+        av_min.domain = av_max.domain = DOMAIN_LONG;
         VALUE_LONG(&av_min) = min.l;
         VALUE_LONG(&av_max) = max.l;
       }
@@ -677,12 +733,16 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
   relation_t *result_rel;
   unsigned attribute_count;
   attribute_t *attr;
+#if DB_SCAN_BATCH_SIZE > 1
+  unsigned i;
+#endif
 
   result_rel = handle->result_rel;
 
   handle->current_row = 0;
   handle->ncolumns = 0;
   handle->tuple_id = 0;
+  aggregated_tuples = 0;
   for(attr = list_head(result_rel->attributes); attr != NULL; attr = attr->next) {
     if(attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
       continue;
@@ -696,6 +756,16 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
     return DB_IMPLEMENTATION_ERROR;
   }
 
+#if DB_SCAN_BATCH_SIZE > 1
+  batch_count = batch_next = 0;
+  for(i = 0; i < attribute_count; i++) {
+    attr = attr_map[i].to_attr;
+    if(attr->domain == DOMAIN_INT || attr->domain == DOMAIN_LONG) {
+      lvm_set_variable_column(attr->name, batch_columns[i]);
+    }
+  }
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
   if(adt->lvm_instance != NULL) {
     /* Try to establish acceptable ranges for the attribute values. */
     if(!LVM_ERROR(lvm_derive(adt->lvm_instance))) {
@@ -708,6 +778,139 @@ generate_selection_result(db_handle_t *handle, relation_t *rel, aql_adt_t *adt)
   return DB_OK;
 }
 
+#if DB_SCAN_BATCH_SIZE > 1
+static db_result_t
+process_select_batch(db_handle_t *handle, aql_adt_t *adt)
+{
+  db_result_t result;
+  unsigned count;
+  unsigned i;
+  unsigned column;
+  struct source_dest_map *attr_map_ptr, *attr_map_end;
+  attribute_t *result_attr;
+  unsigned char *from_ptr;
+  size_t row_length;
+  operand_value_t operand_value;
+  lvm_status_t wanted_result;
+
+  attr_map_end = attr_map + handle->result_rel->attribute_count;
+  row_length = handle->rel->row_length;
+
+  if(batch_next >= batch_count) {
+    count = DB_SCAN_BATCH_SIZE;
+    result = storage_get_rows(handle->rel, &handle->tuple_id, batch_rows,
+                              &count);
+    if(DB_ERROR(result)) {
+      PRINTF("DB: Failed to get rows in relation %s!\n", handle->rel->name);
+      return result;
+    } else if(result == DB_FINISHED) {
+      return DB_FINISHED;
+    }
+    handle->tuple_id += count;
+    batch_count = count;
+    batch_next = 0;
+
+    /* Decode the integer attributes column by column. */
+    for(attr_map_ptr = attr_map, column = 0;
+        attr_map_ptr < attr_map_end;
+        attr_map_ptr++, column++) {
+      from_ptr = batch_rows + attr_map_ptr->from_offset;
+      result_attr = attr_map_ptr->to_attr;
+      if(result_attr->domain == DOMAIN_INT) {
+        for(i = 0; i < count; i++, from_ptr += row_length) {
+          batch_columns[column][i] = from_ptr[0] << 8 | from_ptr[1];
+        }
+      } else if(result_attr->domain == DOMAIN_LONG) {
+        for(i = 0; i < count; i++, from_ptr += row_length) {
+          batch_columns[column][i] = (uint32_t)from_ptr[0] << 24 |
+                                     (uint32_t)from_ptr[1] << 16 |
+                                     (uint32_t)from_ptr[2] << 8 |
+                                     from_ptr[3];
+        }
+      }
+    }
+
+    wanted_result = TRUE;
+    if(AQL_GET_FLAGS(adt) & AQL_FLAG_INVERSE_LOGIC) {
+      wanted_result = FALSE;
+    }
+
+    if(adt->lvm_instance == NULL) {
+      memset(batch_selected, 1, count);
+    } else if(!LVM_ERROR(lvm_execute_batch(adt->lvm_instance,
+                                           batch_selected, count))) {
+      for(i = 0; i < count; i++) {
+        batch_selected[i] = batch_selected[i] == wanted_result;
+      }
+    } else {
+      /* Some tuple makes the predicate fail. Evaluate the tuples one by
+         one, so that only that tuple is left out, as in a normal scan. */
+      for(i = 0; i < count; i++) {
+        for(attr_map_ptr = attr_map, column = 0;
+            attr_map_ptr < attr_map_end;
+            attr_map_ptr++, column++) {
+          result_attr = attr_map_ptr->to_attr;
+          if(result_attr->domain == DOMAIN_INT ||
+             result_attr->domain == DOMAIN_LONG) {
+            operand_value.l = batch_columns[column][i];
+            lvm_set_variable_value(result_attr->name, operand_value);
+          }
+        }
+        batch_selected[i] = lvm_execute(adt->lvm_instance) == wanted_result;
+      }
+    }
+
+    if(AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
+      for(attr_map_ptr = attr_map, column = 0;
+          attr_map_ptr < attr_map_end;
+          attr_map_ptr++, column++) {
+        result_attr = attr_map_ptr->to_attr;
+        if(result_attr->domain == DOMAIN_INT ||
+           result_attr->domain == DOMAIN_LONG) {
+          aggregate_column(result_attr, batch_columns[column], count);
+        } else if(result_attr->domain != DOMAIN_STRING &&
+                  memchr(batch_selected, 1, count) != NULL) {
+          return DB_TYPE_ERROR;
+        }
+      }
+      for(i = 0; i < count; i++) {
+        aggregated_tuples += batch_selected[i];
+      }
+      batch_next = batch_count;
+      return DB_OK;
+    }
+  }
+
+  /* Hand out the selected tuples of the batch one at a time. */
+  while(batch_next < batch_count) {
+    i = batch_next++;
+    if(!batch_selected[i]) {
+      continue;
+    }
+
+    for(attr_map_ptr = attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+      if(attr_map_ptr->to_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+        continue;
+      }
+      memcpy(result_row + attr_map_ptr->to_offset,
+             batch_rows + i * row_length + attr_map_ptr->from_offset,
+             attr_map_ptr->to_attr->element_size);
+    }
+
+    if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
+      if(DB_ERROR(storage_put_row(handle->result_rel, result_row))) {
+        PRINTF("DB: Failed to store a row in the result relation!\n");
+        return DB_STORAGE_ERROR;
+      }
+    }
+    handle->current_row++;
+    return DB_GOT_ROW;
+  }
+
+  return DB_OK;
+}
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
 #if DB_FEATURE_REMOVE
 db_result_t
 relation_process_remove(void *handle_ptr)
@@ -768,6 +971,15 @@ relation_process_select(void *handle_ptr)
       return DB_FINISHED;
     }
   }
+#if DB_SCAN_BATCH_SIZE > 1
+  else {
+    result = process_select_batch(handle, adt);
+    if(result == DB_FINISHED && (AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE)) {
+      goto end_aggregation;
+    }
+    return result;
+  }
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
 
   /* Put the tuples fulfilling the given condition into a new relation.
      The tuples may be projected. */
@@ -830,6 +1042,7 @@ relation_process_select(void *handle_ptr)
         }
         aggregate(attr_map_ptr->to_attr, &value);
       }
+      aggregated_tuples++;
     } else {
       if(AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
         if(DB_ERROR(storage_put_row(handle->result_rel, result_row))) {
@@ -850,6 +1063,9 @@ end_aggregation:
     result_attr = attr_map_ptr->to_attr;
     to_ptr = result_row + attr_map_ptr->to_offset;
 
+    if(result_attr->aggregator == AQL_MEAN && aggregated_tuples > 0) {
+      result_attr->aggregation_value /= (long)aggregated_tuples;
+    }
     intbuf[0] = result_attr->aggregation_value >> 8;
     intbuf[1] = result_attr->aggregation_value & 0xff;
     from_ptr = intbuf;
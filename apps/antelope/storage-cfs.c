@@ -437,6 +437,56 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
   return DB_OK;
 }
 
+#if DB_SCAN_BATCH_SIZE > 1
+/* Read up to *count consecutive rows, starting at *tuple_id, with a
+   single read call. *count is set to the number of rows read. */
+db_result_t
+storage_get_rows(relation_t *rel, tuple_id_t *tuple_id, storage_row_t rows,
+                 unsigned *count)
+{
+  int r;
+  unsigned i;
+  tuple_id_t nrows;
+
+  if(DB_ERROR(storage_get_row_amount(rel, &nrows))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  if(*tuple_id >= nrows) {
+    return DB_FINISHED;
+  }
+
+  if(*count > nrows - *tuple_id) {
+    *count = nrows - *tuple_id;
+  }
+
+  if(cfs_seek(rel->tuple_storage, *tuple_id * rel->row_length, CFS_SEEK_SET) ==
+              (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+  r = cfs_read(rel->tuple_storage, rows, *count * rel->row_length);
+  if(r < 0) {
+    PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
+    return DB_STORAGE_ERROR;
+  } else if(r == 0) {
+    return DB_FINISHED;
+  } else if(r % rel->row_length != 0) {
+    PRINTF("DB: Incomplete record: %d bytes\n", r);
+    return DB_STORAGE_ERROR;
+  }
+
+  *count = r / rel->row_length;
+  for(i = 1; i <= *count; i++) {
+    rows[i * rel->row_length - 1] ^= ROW_XOR;
+  }
+
+  PRINTF("DB: Read %u rows from relation %s\n", *count, rel->name);
+
+  return DB_OK;
+}
+#endif /* DB_SCAN_BATCH_SIZE > 1 */
+
 db_result_t
 storage_put_row(relation_t *rel, storage_row_t row)
 {
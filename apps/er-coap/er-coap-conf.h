@@ -53,6 +53,13 @@
 #define COAP_MAX_OPEN_TRANSACTIONS     4
 #endif /* COAP_MAX_OPEN_TRANSACTIONS */
 
+/* Answer NON GET requests from a static buffer instead of a transaction, as
+   their responses are never retransmitted. They then neither wait for nor
+   take one of the transaction buffers. */
+#ifndef COAP_NON_GET_FAST_PATH
+#define COAP_NON_GET_FAST_PATH         0
+#endif /* COAP_NON_GET_FAST_PATH */
+
 /* Maximum number of failed request attempts before action */
 #ifndef COAP_MAX_ATTEMPTS
 #define COAP_MAX_ATTEMPTS              4
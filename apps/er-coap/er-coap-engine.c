@@ -60,6 +60,9 @@ PROCESS(coap_engine, "CoAP Engine");
 /*- Variables ---------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 static service_callback_t service_cbk = NULL;
+#if COAP_NON_GET_FAST_PATH
+static uint8_t non_response[COAP_MAX_PACKET_SIZE + 1];
+#endif /* COAP_NON_GET_FAST_PATH */
 
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
@@ -76,6 +79,8 @@ coap_receive(void)
   static coap_packet_t message[1]; /* this way the packet can be treated as pointer as usual */
   static coap_packet_t response[1];
   static coap_transaction_t *transaction = NULL;
+  uint8_t *packet = NULL;
+  uint16_t packet_len = 0;
 
   if(uip_newdata()) {
 
@@ -99,10 +104,21 @@ coap_receive(void)
       /* handle requests */
       if(message->code >= COAP_GET && message->code <= COAP_DELETE) {
 
+#if COAP_NON_GET_FAST_PATH
+        if(message->type == COAP_TYPE_NON && message->code == COAP_GET) {
+          /* the response is sent once, directly from the static buffer */
+          transaction = NULL;
+          packet = non_response;
+        } else
+#endif /* COAP_NON_GET_FAST_PATH */
         /* use transaction buffer for response to confirmable request */
         if((transaction =
               coap_new_transaction(message->mid, &UIP_IP_BUF->srcipaddr,
                                    UIP_UDP_BUF->srcport))) {
+          packet = transaction->packet;
+        }
+
+        if(packet != NULL) {
           uint32_t block_num = 0;
           uint16_t block_size = COAP_MAX_BLOCK_SIZE;
           uint32_t block_offset = 0;
@@ -135,7 +151,7 @@ coap_receive(void)
 
             /* call REST framework and check if found and allowed */
             if(service_cbk
-                 (message, response, transaction->packet + COAP_MAX_HEADER_SIZE,
+                 (message, response, packet + COAP_MAX_HEADER_SIZE,
                  block_size, &new_offset)) {
 
               if(erbium_status_code == NO_ERROR) {
@@ -208,11 +224,10 @@ coap_receive(void)
                 /* serialize response */
             }
             if(erbium_status_code == NO_ERROR) {
-              if((transaction->packet_len = coap_serialize_message(response,
-                                                                   transaction->
-                                                                   packet)) ==
-                 0) {
+              if((packet_len = coap_serialize_message(response, packet)) == 0) {
                 erbium_status_code = PACKET_SERIALIZATION_ERROR;
+              } else if(transaction) {
+                transaction->packet_len = packet_len;
               }
             }
           } else {
@@ -271,6 +286,9 @@ coap_receive(void)
     if(erbium_status_code == NO_ERROR) {
       if(transaction) {
         coap_send_transaction(transaction);
+      } else if(packet_len > 0) {
+        coap_send_message(&UIP_IP_BUF->srcipaddr, UIP_UDP_BUF->srcport,
+                          packet, packet_len);
       }
     } else if(erbium_status_code == MANUAL_RESPONSE) {
       PRINTF("Clearing transaction for manual response");
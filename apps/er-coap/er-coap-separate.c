@@ -92,7 +92,9 @@ coap_separate_accept(void *request, coap_separate_t *separate_store)
 
   PRINTF("Separate ACCEPT: /%.*s MID %u\n", coap_req->uri_path_len,
          coap_req->uri_path, coap_req->mid);
-  if(t) {
+  /* NON GETs may be answered without a transaction, see
+     COAP_NON_GET_FAST_PATH; their sender is still in the IP buffer */
+  if(t || coap_req->type == COAP_TYPE_NON) {
     /* send separate ACK for CON */
     if(coap_req->type == COAP_TYPE_CON) {
       coap_packet_t ack[1];
@@ -106,8 +108,13 @@ coap_separate_accept(void *request, coap_separate_t *separate_store)
     }
 
     /* store remote address */
-    uip_ipaddr_copy(&separate_store->addr, &t->addr);
-    separate_store->port = t->port;
+    if(t) {
+      uip_ipaddr_copy(&separate_store->addr, &t->addr);
+      separate_store->port = t->port;
+    } else {
+      uip_ipaddr_copy(&separate_store->addr, &UIP_IP_BUF->srcipaddr);
+      separate_store->port = UIP_UDP_BUF->srcport;
+    }
 
     /* store correct response type */
     separate_store->type =
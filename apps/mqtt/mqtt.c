@@ -191,6 +191,10 @@ static void tcp_event(struct tcp_socket *s, void *ptr,
                       tcp_socket_event_t event);
 
 static void reset_packet(struct mqtt_in_packet *packet);
+#if MQTT_PUBLISH_QUEUE_SIZE
+static void publish_queue_reset(struct mqtt_connection *conn);
+static void publish_expire(struct mqtt_connection *conn);
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 /*---------------------------------------------------------------------------*/
 LIST(mqtt_conn_list);
 /*---------------------------------------------------------------------------*/
@@ -214,6 +218,9 @@ reset_defaults(struct mqtt_connection *conn)
 
   reset_packet(&conn->in_packet);
   conn->out_buffer_sent = 0;
+#if MQTT_PUBLISH_QUEUE_SIZE
+  publish_queue_reset(conn);
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -224,6 +231,9 @@ abort_connection(struct mqtt_connection *conn)
 
   /* Reset outgoing packet */
   memset(&conn->out_packet, 0, sizeof(conn->out_packet));
+#if MQTT_PUBLISH_QUEUE_SIZE
+  publish_queue_reset(conn);
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 
   tcp_socket_close(&conn->socket);
   tcp_socket_unregister(&conn->socket);
@@ -371,6 +381,9 @@ keep_alive_callback(void *ptr)
   }
 
   process_post(&mqtt_process, mqtt_do_pingreq_event, conn);
+#if MQTT_PUBLISH_QUEUE_SIZE
+  publish_expire(conn);
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -628,6 +641,279 @@ PT_THREAD(unsubscribe_pt(struct pt *pt, struct mqtt_connection *conn))
   PT_END(pt);
 }
 /*---------------------------------------------------------------------------*/
+#if MQTT_PUBLISH_QUEUE_SIZE
+#define OUT_BUFFER_SPACE(conn) \
+  (&(conn)->out_buffer[MQTT_TCP_OUTPUT_BUFF_SIZE] - (conn)->out_buffer_ptr)
+/*---------------------------------------------------------------------------*/
+static void
+publish_queue_reset(struct mqtt_connection *conn)
+{
+  uint8_t i;
+
+  LIST_STRUCT_INIT(conn, publish_queue);
+  for(i = 0; i < MQTT_PUBLISH_QUEUE_SIZE; i++) {
+    conn->publish_slots[i].state = MQTT_PUBLISH_SLOT_FREE;
+  }
+  conn->out_slot = NULL;
+  conn->publish_in_flight = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+publish_slot_free(struct mqtt_connection *conn,
+                  struct mqtt_publish_slot *slot)
+{
+  if(slot->state == MQTT_PUBLISH_SLOT_IN_FLIGHT) {
+    conn->publish_in_flight--;
+  }
+  slot->state = MQTT_PUBLISH_SLOT_FREE;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Gives up on QoS 1 messages whose PUBACK did not arrive in time, so that
+ * they do not hold on to the window forever. The application is told with
+ * MQTT_EVENT_PUBACK_TIMEOUT_ERROR and may publish them again.
+ */
+static void
+publish_expire(struct mqtt_connection *conn)
+{
+  uint8_t i;
+  uint8_t expired;
+  uint16_t mid;
+  struct mqtt_publish_slot *slot;
+
+  expired = 0;
+  for(i = 0; i < MQTT_PUBLISH_QUEUE_SIZE; i++) {
+    slot = &conn->publish_slots[i];
+    if(slot->state == MQTT_PUBLISH_SLOT_IN_FLIGHT &&
+       clock_time() - slot->sent >= RESPONSE_WAIT_TIMEOUT) {
+      DBG("MQTT - Timeout waiting for PUBACK %u\n", slot->mid);
+      mid = slot->mid;
+      publish_slot_free(conn, slot);
+      expired = 1;
+      call_event(conn, MQTT_EVENT_PUBACK_TIMEOUT_ERROR, &mid);
+    }
+  }
+
+  /* The window has moved, resume sending if messages were held back */
+  if(expired && list_head(conn->publish_queue) != NULL) {
+    process_post(&mqtt_process, mqtt_do_publish_event, conn);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Returns the next message to send: the head of the queue, unless it needs
+ * a PUBACK and the window is full.
+ */
+static struct mqtt_publish_slot *
+publish_next(struct mqtt_connection *conn)
+{
+  struct mqtt_publish_slot *slot;
+
+  slot = list_head(conn->publish_queue);
+  if(slot != NULL && slot->qos == MQTT_QOS_LEVEL_1 &&
+     conn->publish_in_flight >= MQTT_PUBLISH_WINDOW) {
+    return NULL;
+  }
+  return slot;
+}
+/*---------------------------------------------------------------------------*/
+static mqtt_status_t
+publish_enqueue(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+                void *payload, mqtt_payload_iterator_t iterator,
+                uint32_t payload_size, mqtt_qos_level_t qos_level,
+                mqtt_retain_t retain)
+{
+  uint8_t i;
+  struct mqtt_publish_slot *slot;
+
+  if(conn->state != MQTT_CONN_STATE_CONNECTED_TO_BROKER) {
+    return MQTT_STATUS_NOT_CONNECTED_ERROR;
+  }
+
+  DBG("MQTT - Call to mqtt_publish...\n");
+
+  publish_expire(conn);
+
+  slot = NULL;
+  for(i = 0; i < MQTT_PUBLISH_QUEUE_SIZE; i++) {
+    if(conn->publish_slots[i].state == MQTT_PUBLISH_SLOT_FREE) {
+      slot = &conn->publish_slots[i];
+      break;
+    }
+  }
+  if(slot == NULL) {
+    DBG("MQTT - Not accepted!\n");
+    return MQTT_STATUS_OUT_QUEUE_FULL;
+  }
+  DBG("MQTT - Accepted!\n");
+
+  slot->mid = INCREMENT_MID(conn);
+  slot->retain = retain;
+  slot->topic = topic;
+  slot->topic_length = strlen(topic);
+  slot->payload = payload;
+  slot->iterator = iterator;
+  slot->payload_size = payload_size;
+  slot->qos = qos_level;
+  slot->state = MQTT_PUBLISH_SLOT_QUEUED;
+  if(mid != NULL) {
+    *mid = slot->mid;
+  }
+
+  /*
+   * Messages queued behind this one are picked up by the same run of
+   * publish_pt, so only an empty queue needs the event.
+   */
+  if(list_head(conn->publish_queue) == NULL) {
+    process_post(&mqtt_process, mqtt_do_publish_event, conn);
+  }
+  list_add(conn->publish_queue, slot);
+
+  return MQTT_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Sends queued PUBLISH messages. Messages are appended to the output buffer
+ * as long as they fit, so that consecutive small messages leave in a single
+ * TCP segment; the buffer is only flushed when the next message does not fit
+ * or the queue has been drained.
+ */
+static
+PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
+{
+  uint16_t len;
+  uint16_t mid;
+  uint32_t written;
+  tcp_socket_event_t event;
+
+  PT_BEGIN(pt);
+
+  while((conn->out_slot = publish_next(conn)) != NULL) {
+    list_remove(conn->publish_queue, conn->out_slot);
+
+    DBG("MQTT - Sending publish message! topic %s topic_length %i\n",
+        conn->out_slot->topic,
+        conn->out_slot->topic_length);
+
+    /* Set up FHDR */
+    conn->out_packet.fhdr = MQTT_FHDR_MSG_TYPE_PUBLISH |
+      conn->out_slot->qos << 1;
+    if(conn->out_slot->retain == MQTT_RETAIN_ON) {
+      conn->out_packet.fhdr |= MQTT_FHDR_RETAIN_FLAG;
+    }
+    conn->out_packet.remaining_length = MQTT_STRING_LEN_SIZE +
+      conn->out_slot->topic_length +
+      conn->out_slot->payload_size;
+    if(conn->out_slot->qos > MQTT_QOS_LEVEL_0) {
+      conn->out_packet.remaining_length += MQTT_MID_SIZE;
+    }
+    encode_remaining_length(conn->out_packet.remaining_length_enc,
+                            &conn->out_packet.remaining_length_enc_bytes,
+                            conn->out_packet.remaining_length);
+    if(conn->out_packet.remaining_length_enc_bytes > 4) {
+      call_event(conn, MQTT_EVENT_PROTOCOL_ERROR, NULL);
+      PRINTF("MQTT - Error, remaining length > 4 bytes\n");
+      publish_slot_free(conn, conn->out_slot);
+      continue;
+    }
+
+    /* Flush what has been batched so far if this message does not fit */
+    if(conn->out_buffer_ptr != conn->out_buffer &&
+       MQTT_FHDR_SIZE + conn->out_packet.remaining_length_enc_bytes +
+       conn->out_packet.remaining_length > OUT_BUFFER_SPACE(conn)) {
+      send_out_buffer(conn);
+      PT_WAIT_UNTIL(pt, conn->out_buffer_sent);
+    }
+
+    /* Write Fixed Header */
+    PT_MQTT_WRITE_BYTE(conn, conn->out_packet.fhdr);
+    PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->out_packet.remaining_length_enc,
+                        conn->out_packet.remaining_length_enc_bytes);
+    /* Write Variable Header */
+    PT_MQTT_WRITE_BYTE(conn, (conn->out_slot->topic_length >> 8));
+    PT_MQTT_WRITE_BYTE(conn, (conn->out_slot->topic_length & 0x00FF));
+    PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->out_slot->topic,
+                        conn->out_slot->topic_length);
+    if(conn->out_slot->qos > MQTT_QOS_LEVEL_0) {
+      PT_MQTT_WRITE_BYTE(conn, (conn->out_slot->mid >> 8));
+      PT_MQTT_WRITE_BYTE(conn, (conn->out_slot->mid & 0x00FF));
+    }
+    /* Write Payload */
+    if(conn->out_slot->iterator != NULL) {
+      /* Have the iterator fill whatever room is left in the output buffer */
+      conn->out_write_pos = 0;
+      while(conn->out_write_pos < conn->out_slot->payload_size) {
+        if(OUT_BUFFER_SPACE(conn) == 0) {
+          send_out_buffer(conn);
+          PT_WAIT_UNTIL(pt, conn->out_buffer_sent);
+        }
+        len = MIN((uint16_t)OUT_BUFFER_SPACE(conn),
+                  conn->out_slot->payload_size - conn->out_write_pos);
+        if(conn->out_slot->iterator(conn->out_slot->payload,
+                                    conn->out_write_pos,
+                                    conn->out_buffer_ptr, len) != len) {
+          break;
+        }
+        conn->out_buffer_ptr += len;
+        conn->out_write_pos += len;
+      }
+      if(conn->out_write_pos < conn->out_slot->payload_size) {
+        DBG("MQTT - Payload iterator failed for %u\n", conn->out_slot->mid);
+        written = MQTT_FHDR_SIZE +
+          conn->out_packet.remaining_length_enc_bytes +
+          conn->out_packet.remaining_length -
+          conn->out_slot->payload_size + conn->out_write_pos;
+        conn->out_write_pos = 0;
+        mid = conn->out_slot->mid;
+        publish_slot_free(conn, conn->out_slot);
+        call_event(conn, MQTT_EVENT_PAYLOAD_ERROR, &mid);
+        if(conn->out_buffer_ptr - conn->out_buffer >= written) {
+          /* Nothing of the message has left yet, take it back */
+          conn->out_buffer_ptr -= written;
+          continue;
+        }
+        /*
+         * The broker got part of the message, the stream is lost: drop the
+         * connection as tcp_event() does when TCP aborts it
+         */
+        conn->out_slot = NULL;
+        event = TCP_SOCKET_ABORTED;
+        ctimer_stop(&conn->keep_alive_timer);
+        call_event(conn, MQTT_EVENT_DISCONNECTED, &event);
+        abort_connection(conn);
+        if(conn->auto_reconnect == 1) {
+          connect_tcp(conn);
+        }
+        PT_EXIT(pt);
+      }
+      conn->out_write_pos = 0;
+    } else {
+      PT_MQTT_WRITE_BYTES(conn, (uint8_t *)conn->out_slot->payload,
+                          conn->out_slot->payload_size);
+    }
+
+    if(conn->out_slot->qos == MQTT_QOS_LEVEL_1) {
+      conn->out_slot->state = MQTT_PUBLISH_SLOT_IN_FLIGHT;
+      conn->out_slot->sent = clock_time();
+      conn->publish_in_flight++;
+    } else {
+      /* QoS 2 is not implemented, it is sent but not acknowledged */
+      publish_slot_free(conn, conn->out_slot);
+    }
+  }
+  conn->out_slot = NULL;
+
+  send_out_buffer(conn);
+
+  /* Notify the app that there is room in the queue again */
+  process_post(conn->app_process, mqtt_update_event, NULL);
+
+  DBG("MQTT - Publish queue drained\n");
+
+  PT_END(pt);
+}
+/*---------------------------------------------------------------------------*/
+#else /* MQTT_PUBLISH_QUEUE_SIZE */
 static
 PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
 {
@@ -715,6 +1001,7 @@ PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
 
   PT_END(pt);
 }
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 /*---------------------------------------------------------------------------*/
 static
 PT_THREAD(pingreq_pt(struct pt *pt, struct mqtt_connection *conn))
@@ -825,12 +1112,34 @@ handle_unsuback(struct mqtt_connection *conn)
 static void
 handle_puback(struct mqtt_connection *conn)
 {
+#if MQTT_PUBLISH_QUEUE_SIZE
+  uint8_t i;
+  struct mqtt_publish_slot *slot;
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
+
   DBG("MQTT - Got PUBACK\n");
 
-  conn->out_packet.qos_state = MQTT_QOS_STATE_GOT_ACK;
   conn->in_packet.mid = (conn->in_packet.payload[0] << 8) |
     (conn->in_packet.payload[1]);
 
+#if MQTT_PUBLISH_QUEUE_SIZE
+  for(i = 0; i < MQTT_PUBLISH_QUEUE_SIZE; i++) {
+    slot = &conn->publish_slots[i];
+    if(slot->state == MQTT_PUBLISH_SLOT_IN_FLIGHT &&
+       slot->mid == conn->in_packet.mid) {
+      publish_slot_free(conn, slot);
+      break;
+    }
+  }
+
+  /* The window has moved, resume sending if messages were held back */
+  if(list_head(conn->publish_queue) != NULL) {
+    process_post(&mqtt_process, mqtt_do_publish_event, conn);
+  }
+#else /* MQTT_PUBLISH_QUEUE_SIZE */
+  conn->out_packet.qos_state = MQTT_QOS_STATE_GOT_ACK;
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
+
   call_event(conn, MQTT_EVENT_PUBACK, &conn->in_packet.mid);
 }
 /*---------------------------------------------------------------------------*/
@@ -1138,6 +1447,12 @@ tcp_event(struct tcp_socket *s, void *ptr, tcp_socket_event_t event)
     if(conn->socket.output_data_len == 0) {
       conn->out_buffer_sent = 1;
       conn->out_buffer_ptr = conn->out_buffer;
+#if MQTT_PUBLISH_QUEUE_SIZE
+      /* Messages queued while the buffer was busy can go now */
+      if(list_head(conn->publish_queue) != NULL) {
+        process_post(&mqtt_process, mqtt_do_publish_event, conn);
+      }
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
     }
 
     ctimer_restart(&conn->keep_alive_timer);
@@ -1247,6 +1562,12 @@ PROCESS_THREAD(mqtt_process, ev, data)
       conn = data;
       DBG("MQTT - Got mqtt_do_publish_mqtt_event!\n");
 
+#if MQTT_PUBLISH_QUEUE_SIZE
+      publish_expire(conn);
+      if(publish_next(conn) == NULL) {
+        continue;
+      }
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
       if(conn->out_buffer_sent == 1 &&
          conn->state == MQTT_CONN_STATE_CONNECTED_TO_BROKER) {
         PT_INIT(&conn->out_proto_thread);
@@ -1424,6 +1745,10 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
              uint8_t *payload, uint32_t payload_size,
              mqtt_qos_level_t qos_level, mqtt_retain_t retain)
 {
+#if MQTT_PUBLISH_QUEUE_SIZE
+  return publish_enqueue(conn, mid, topic, payload, NULL, payload_size,
+                         qos_level, retain);
+#else /* MQTT_PUBLISH_QUEUE_SIZE */
   if(conn->state != MQTT_CONN_STATE_CONNECTED_TO_BROKER) {
     return MQTT_STATUS_NOT_CONNECTED_ERROR;
   }
@@ -1449,8 +1774,24 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
 
   process_post(&mqtt_process, mqtt_do_publish_event, conn);
   return MQTT_STATUS_OK;
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
+}
+/*----------------------------------------------------------------------------*/
+#if MQTT_PUBLISH_QUEUE_SIZE
+mqtt_status_t
+mqtt_publish_iter(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+                  mqtt_payload_iterator_t iterator, void *ptr,
+                  uint32_t payload_size, mqtt_qos_level_t qos_level,
+                  mqtt_retain_t retain)
+{
+  if(iterator == NULL) {
+    return MQTT_STATUS_INVALID_ARGS_ERROR;
+  }
+  return publish_enqueue(conn, mid, topic, ptr, iterator, payload_size,
+                         qos_level, retain);
 }
 /*----------------------------------------------------------------------------*/
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 void
 mqtt_set_username_password(struct mqtt_connection *conn, char *username,
                            char *password)
@@ -117,6 +117,28 @@
 #define MQTT_PROTOCOL_VERSION 3
 #define MQTT_PROTOCOL_NAME "MQIsdp"
 #define MQTT_TOPIC_MAX_LENGTH 128
+
+/*
+ * Number of PUBLISH messages that can be queued on a connection. With a
+ * queue, mqtt_publish() does not wait for the previous message: queued
+ * messages are coalesced into the TCP output buffer and flushed together,
+ * and up to MQTT_PUBLISH_WINDOW QoS 1 messages can await their PUBACK at
+ * the same time. 0 keeps the one-message-at-a-time behaviour.
+ */
+#ifdef MQTT_CONF_PUBLISH_QUEUE_SIZE
+#define MQTT_PUBLISH_QUEUE_SIZE MQTT_CONF_PUBLISH_QUEUE_SIZE
+#else
+#define MQTT_PUBLISH_QUEUE_SIZE 0
+#endif
+
+/* Maximum number of QoS 1 messages awaiting a PUBACK */
+#ifdef MQTT_CONF_PUBLISH_WINDOW
+#define MQTT_PUBLISH_WINDOW MQTT_CONF_PUBLISH_WINDOW
+#elif MQTT_PUBLISH_QUEUE_SIZE < 4
+#define MQTT_PUBLISH_WINDOW MQTT_PUBLISH_QUEUE_SIZE
+#else
+#define MQTT_PUBLISH_WINDOW 4
+#endif
 /*---------------------------------------------------------------------------*/
 /*
  * Debug configuration, this is similar but not exactly like the Debugging
@@ -158,6 +180,10 @@ typedef enum {
   MQTT_EVENT_CONNECTION_REFUSED_ERROR,
   MQTT_EVENT_DNS_ERROR,
   MQTT_EVENT_NOT_IMPLEMENTED_ERROR,
+  /* A queued QoS 1 PUBLISH got no PUBACK in time, data is its mid */
+  MQTT_EVENT_PUBACK_TIMEOUT_ERROR,
+  /* The payload iterator of a queued PUBLISH failed, data is its mid */
+  MQTT_EVENT_PAYLOAD_ERROR,
   /* Add more */
 } mqtt_event_t;
 
@@ -283,6 +309,51 @@ struct mqtt_out_packet {
   mqtt_qos_state_t qos_state;
   mqtt_retain_t retain;
 };
+
+#if MQTT_PUBLISH_QUEUE_SIZE
+/**
+ * \brief        Payload iterator for mqtt_publish_iter()
+ * \param ptr    The pointer given to mqtt_publish_iter()
+ * \param offset Offset in the payload of the first byte to produce
+ * \param buf    Where to write the payload bytes
+ * \param len    Number of bytes to write
+ * \return       The number of bytes written, which must be len
+ *
+ * The iterator writes straight into the TCP output buffer and is called as
+ * many times as it takes to send the whole payload, so the payload never
+ * needs to be held in memory at once.
+ *
+ * If it returns anything other than len, the message is dropped and the
+ * application gets MQTT_EVENT_PAYLOAD_ERROR. Should part of the message
+ * have been sent already, the connection is aborted too, with
+ * MQTT_EVENT_DISCONNECTED.
+ */
+typedef uint16_t (*mqtt_payload_iterator_t)(void *ptr, uint32_t offset,
+                                            uint8_t *buf, uint16_t len);
+
+typedef enum {
+  MQTT_PUBLISH_SLOT_FREE,
+  MQTT_PUBLISH_SLOT_QUEUED,
+  MQTT_PUBLISH_SLOT_IN_FLIGHT,
+} mqtt_publish_slot_state_t;
+
+/* A queued PUBLISH, or a QoS 1 PUBLISH awaiting its PUBACK */
+struct mqtt_publish_slot {
+  /* Used by the list interface, must be first in the struct. */
+  struct mqtt_publish_slot *next;
+  char *topic;
+  /* The payload, or the pointer passed to the iterator if there is one */
+  void *payload;
+  mqtt_payload_iterator_t iterator;
+  uint32_t payload_size;
+  clock_time_t sent;
+  uint16_t topic_length;
+  uint16_t mid;
+  uint8_t qos;
+  uint8_t retain;
+  uint8_t state;
+};
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 /*---------------------------------------------------------------------------*/
 /**
  * \brief           MQTT event callback function
@@ -348,6 +419,14 @@ struct mqtt_connection {
   uint32_t out_write_pos;
   uint16_t max_segment_size;
 
+#if MQTT_PUBLISH_QUEUE_SIZE
+  /* Publish queue, in the order the messages were handed to us */
+  struct mqtt_publish_slot publish_slots[MQTT_PUBLISH_QUEUE_SIZE];
+  LIST_STRUCT(publish_queue);
+  struct mqtt_publish_slot *out_slot;
+  uint8_t publish_in_flight;
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
+
   /* Incoming data related */
   uint8_t in_buffer[MQTT_TCP_INPUT_BUFF_SIZE];
   struct mqtt_in_packet in_packet;
@@ -450,6 +529,11 @@ mqtt_status_t mqtt_unsubscribe(struct mqtt_connection *conn,
  * \return MQTT_STATUS_OK or some error status
  *
  * This function publishes to a topic on a MQTT broker.
+ *
+ * With MQTT_CONF_PUBLISH_QUEUE_SIZE set, the message is queued and
+ * MQTT_STATUS_OUT_QUEUE_FULL is only returned when the queue is full. The
+ * topic and payload must then remain valid until the message has been sent
+ * and, for QoS 1, until MQTT_EVENT_PUBACK.
  */
 mqtt_status_t mqtt_publish(struct mqtt_connection *conn,
                            uint16_t *mid,
@@ -458,6 +542,34 @@ mqtt_status_t mqtt_publish(struct mqtt_connection *conn,
                            uint32_t payload_size,
                            mqtt_qos_level_t qos_level,
                            mqtt_retain_t retain);
+#if MQTT_PUBLISH_QUEUE_SIZE
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Publish to a MQTT topic, with the payload produced on demand.
+ * \param conn A pointer to the MQTT connection.
+ * \param mid A pointer to message ID, set if not NULL.
+ * \param topic A pointer to the topic to publish to.
+ * \param iterator The function producing the payload.
+ * \param ptr A pointer passed to the iterator.
+ * \param payload_size Payload size.
+ * \param qos_level Quality Of Service level to use. Currently supports 0, 1.
+ * \param retain The RETAIN flag, as for mqtt_publish().
+ * \return MQTT_STATUS_OK or some error status
+ *
+ * This function queues a PUBLISH whose payload is streamed from the
+ * iterator into the TCP output buffer when the message is sent. The topic
+ * and whatever the iterator reads must remain valid until then, and, for
+ * QoS 1, until MQTT_EVENT_PUBACK.
+ */
+mqtt_status_t mqtt_publish_iter(struct mqtt_connection *conn,
+                                uint16_t *mid,
+                                char *topic,
+                                mqtt_payload_iterator_t iterator,
+                                void *ptr,
+                                uint32_t payload_size,
+                                mqtt_qos_level_t qos_level,
+                                mqtt_retain_t retain);
+#endif /* MQTT_PUBLISH_QUEUE_SIZE */
 /*---------------------------------------------------------------------------*/
 /**
  * \brief Set the user name and password for a MQTT client.
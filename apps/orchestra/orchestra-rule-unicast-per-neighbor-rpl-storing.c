@@ -598,6 +598,7 @@ remove_tx_sf_after_expired(void *linkaddr) //After rm_timer expired
 static void
 child_added(const linkaddr_t *linkaddr)  //child means next-hop
 {
+  tsch_schedule_begin();
 #if TESLA
   add_tx_sf(linkaddr); //sf_size was in DAO
 #else
@@ -608,6 +609,7 @@ child_added(const linkaddr_t *linkaddr)  //child means next-hop
 
   add_uc_link(linkaddr);
 #endif
+  tsch_schedule_commit();
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -615,6 +617,7 @@ child_removed(const linkaddr_t *linkaddr) //child means next-hop
 {
 
 struct tsch_neighbor * nbr = tsch_queue_get_nbr(linkaddr);
+    tsch_schedule_begin();
     //uint8_t locked= tsch_is_locked();
 #if TESLA
 
@@ -701,6 +704,7 @@ struct tsch_neighbor * nbr = tsch_queue_get_nbr(linkaddr);
     
 
 #endif
+    tsch_schedule_commit();
 
 }
 
@@ -801,7 +805,7 @@ select_packet(uint16_t *slotframe, uint16_t *timeslot)
 
       if(tx_sf!=NULL)
       {
-        struct tsch_link *l = list_head(tx_sf->links_list);
+        struct tsch_link *l = tsch_schedule_get_link_head(tx_sf);
         /* Loop over all items. Assume there is max one link per timeslot */
         while(l != NULL) {
           if(l->slotframe_handle == tx_sf_handle) {
@@ -883,6 +887,7 @@ new_time_source(const struct tsch_neighbor *old, const struct tsch_neighbor *new
 
     //uint8_t locked= tsch_is_locked();
 
+    tsch_schedule_begin();
 #if TESLA
     if(old_addr!=NULL){
       //ctimer_set(&rm_timer, 5 * CLOCK_SECOND, remove_tx_sf_void, (void*)ptr_temp_old_addr);
@@ -1018,6 +1023,7 @@ new_time_source(const struct tsch_neighbor *old, const struct tsch_neighbor *new
 
     add_uc_link(new_addr);
 #endif
+    tsch_schedule_commit();
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -1171,8 +1177,10 @@ change_attr_in_tx_queue(const linkaddr_t * dest, uint8_t is_adjust_tx_sf_size, u
       {
         index=j;  
       }
-      set_queuebuf_attr(n1->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME, sf_handle);
-      set_queuebuf_attr(n1->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT, timeslot);
+      if(!set_queuebuf_attr(n1->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME, sf_handle)
+         || !set_queuebuf_attr(n1->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT, timeslot)) {
+        printf("ERROR: link selector not set (change_attr_in_tx_queue)\n");
+      }
       #if PRINT_SELECT_1
       //printf("index: %u, %u %u\n",j,queuebuf_attr(n1->tx_array[index]->qb,PACKETBUF_ATTR_TSCH_SLOTFRAME),queuebuf_attr(n1->tx_array[index]->qb,PACKETBUF_ATTR_TSCH_TIMESLOT));
       #endif
@@ -1207,6 +1215,7 @@ adjust_sf_size(void)
     return ;
   }
 
+  tsch_schedule_begin();
   if(tsch_schedule_change_slotframe_link_handle(sf_unicast,TEMP_SF_HANDLE)==0)
   {
     printf("ERROR: Handle change fail in temp sf\n");
@@ -1224,6 +1233,7 @@ adjust_sf_size(void)
   sf_unicast = tsch_schedule_add_slotframe(slotframe_handle, my_sf_size);
 
   add_rx_link(my_sf_size); 
+  tsch_schedule_commit();
 
 }
 /*---------------------------------------------------------------------------*/
@@ -135,6 +135,7 @@ uint8_t is_routing_nbr(uip_ds6_nbr_t *nbr);
 void print_nbr(void);
 void remove_tx(uint16_t id);
 void remove_rx(uint16_t id);
+void reset_t_offset_occupancy(void);
 void change_queue_select_packet(uint16_t id, uint16_t handle, uint16_t timeslot);
 void change_queue_N_update(uint16_t nbr_id, uint16_t updated_N);
 uint8_t get_todo_no_resource();
@@ -59,6 +59,32 @@ PROCESS(rest_engine_process, "REST Engine");
 LIST(restful_services);
 LIST(restful_periodic_services);
 /*---------------------------------------------------------------------------*/
+#if REST_ENGINE_TRIE
+/* A node of the dispatch trie stands for one path segment. Its children are
+   the segments that can follow it. Its resource is the first one activated
+   with the path ending at this segment, and its parent the first of those
+   that has sub-resources, which may be a later one. */
+struct trie_node {
+  struct trie_node *next;
+  struct trie_node *child;
+  resource_t *resource;
+  resource_t *parent;
+  const char *segment;
+  uint16_t order;
+  uint16_t parent_order;
+  uint8_t segment_len;
+};
+
+MEMB(trie_nodes, struct trie_node, REST_ENGINE_TRIE_NODES);
+
+static struct trie_node *trie_root;
+/* Activation order of the resources, the first matching one is served */
+static uint16_t num_activated;
+/* Resources that could not be inserted into the trie. As long as there is
+   one, requests are dispatched through the resource list. */
+static uint16_t num_unindexed;
+#endif /* REST_ENGINE_TRIE */
+/*---------------------------------------------------------------------------*/
 /*- REST Engine API ---------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 /**
@@ -80,6 +106,10 @@ rest_init_engine(void)
   initialized = 1;
 
   list_init(restful_services);
+#if REST_ENGINE_TRIE
+  memb_init(&trie_nodes);
+  trie_root = NULL;
+#endif /* REST_ENGINE_TRIE */
 
   REST.set_service_callback(rest_invoke_restful_service);
 
@@ -90,6 +120,146 @@ rest_init_engine(void)
   process_start(&rest_engine_process, NULL);
 }
 /*---------------------------------------------------------------------------*/
+#if REST_ENGINE_TRIE
+static int
+segment_length(const char *path, int len)
+{
+  int i;
+
+  for(i = 0; i < len && path[i] != '/'; i++);
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trie_insert(resource_t *resource)
+{
+  struct trie_node **link;
+  struct trie_node *n;
+  const char *path;
+  int len, seg_len;
+
+  path = resource->url;
+  len = strlen(path);
+  link = &trie_root;
+  for(;;) {
+    seg_len = segment_length(path, len);
+    if(seg_len > 255) {
+      return 0;
+    }
+    for(n = *link; n != NULL; n = n->next) {
+      if(n->segment_len == seg_len && memcmp(n->segment, path, seg_len) == 0) {
+        break;
+      }
+    }
+    if(n == NULL) {
+      n = memb_alloc(&trie_nodes);
+      if(n == NULL) {
+        return 0;
+      }
+      n->child = NULL;
+      n->resource = NULL;
+      n->parent = NULL;
+      n->segment = path;
+      n->segment_len = seg_len;
+      n->next = *link;
+      *link = n;
+    }
+
+    path += seg_len;
+    len -= seg_len;
+    if(len == 0) {
+      break;
+    }
+    /* Skip the slash */
+    path++;
+    len--;
+    link = &n->child;
+  }
+
+  /* A resource activated earlier under the same path stays in place */
+  if(n->resource == NULL) {
+    n->resource = resource;
+    n->order = num_activated;
+  }
+  if(n->parent == NULL && (resource->flags & HAS_SUB_RESOURCES)) {
+    n->parent = resource;
+    n->parent_order = num_activated;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static resource_t *
+trie_lookup(const char *url, int url_len)
+{
+  struct trie_node *n;
+  resource_t *match;
+  uint16_t order;
+  int seg_len;
+
+  match = NULL;
+  order = 0;
+  n = trie_root;
+  for(;;) {
+    seg_len = segment_length(url, url_len);
+    for(; n != NULL; n = n->next) {
+      if(n->segment_len == seg_len && memcmp(n->segment, url, seg_len) == 0) {
+        break;
+      }
+    }
+    if(n == NULL) {
+      break;
+    }
+
+    url += seg_len;
+    url_len -= seg_len;
+    if(url_len == 0) {
+      /* The whole URL matched */
+      if(n->resource != NULL && (match == NULL || n->order < order)) {
+        match = n->resource;
+      }
+      break;
+    }
+    /* A parent of the requested sub-resource */
+    if(n->parent != NULL && (match == NULL || n->parent_order < order)) {
+      match = n->parent;
+      order = n->parent_order;
+    }
+    url++;
+    url_len--;
+    n = n->child;
+  }
+  return match;
+}
+#endif /* REST_ENGINE_TRIE */
+/*---------------------------------------------------------------------------*/
+static resource_t *
+find_resource(const char *url, int url_len)
+{
+  resource_t *resource;
+  int res_url_len;
+
+#if REST_ENGINE_TRIE
+  if(num_unindexed == 0) {
+    return trie_lookup(url, url_len);
+  }
+#endif /* REST_ENGINE_TRIE */
+
+  for(resource = (resource_t *)list_head(restful_services);
+      resource; resource = resource->next) {
+
+    /* if the web service handles that kind of requests and urls matches */
+    res_url_len = strlen(resource->url);
+    if((url_len == res_url_len
+        || (url_len > res_url_len
+            && (resource->flags & HAS_SUB_RESOURCES)
+            && url[res_url_len] == '/'))
+       && strncmp(resource->url, url, res_url_len) == 0) {
+      return resource;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
 /**
  * \brief Makes a resource available under the given URI path
  * \param resource A pointer to a resource implementation
@@ -104,6 +274,13 @@ rest_activate_resource(resource_t *resource, char *path)
 {
   resource->url = path;
   list_add(restful_services, resource);
+#if REST_ENGINE_TRIE
+  if(!trie_insert(resource)) {
+    PRINTF("No trie node left for %s\n", resource->url);
+    num_unindexed++;
+  }
+  num_activated++;
+#endif /* REST_ENGINE_TRIE */
 
   PRINTF("Activating: %s\n", resource->url);
 
@@ -141,44 +318,34 @@ rest_invoke_restful_service(void *request, void *response, uint8_t *buffer,
 
   resource_t *resource = NULL;
   const char *url = NULL;
-  int url_len, res_url_len;
+  int url_len;
 
   url_len = REST.get_url(request, &url);
-  for(resource = (resource_t *)list_head(restful_services);
-      resource; resource = resource->next) {
+  resource = find_resource(url, url_len);
+  if(resource != NULL) {
+    found = 1;
+    rest_resource_flags_t method = REST.get_method_type(request);
 
-    /* if the web service handles that kind of requests and urls matches */
-    res_url_len = strlen(resource->url);
-    if((url_len == res_url_len
-        || (url_len > res_url_len
-            && (resource->flags & HAS_SUB_RESOURCES)
-            && url[res_url_len] == '/'))
-       && strncmp(resource->url, url, res_url_len) == 0) {
-      found = 1;
-      rest_resource_flags_t method = REST.get_method_type(request);
-
-      PRINTF("/%s, method %u, resource->flags %u\n", resource->url,
-             (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+    PRINTF("/%s, method %u, resource->flags %u\n", resource->url,
+           (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        REST.set_response_status(response, REST.status.METHOD_NOT_ALLOWED);
-      }
-      break;
+    } else {
+      allowed = 0;
+      REST.set_response_status(response, REST.status.METHOD_NOT_ALLOWED);
     }
   }
   if(!found) {
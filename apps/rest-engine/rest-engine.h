@@ -62,6 +62,27 @@
 #define REST_MAX_CHUNK_SIZE     64
 #endif
 
+/*
+ * Dispatch requests through a trie of the URI path segments of the activated
+ * resources, built in rest_activate_resource(), instead of comparing the URI
+ * with the path of every resource.
+ */
+#ifdef REST_ENGINE_CONF_TRIE
+#define REST_ENGINE_TRIE REST_ENGINE_CONF_TRIE
+#else
+#define REST_ENGINE_TRIE 0
+#endif
+
+/*
+ * Number of trie nodes, one per distinct path segment prefix. Resources that
+ * do not fit are still served, through the comparison with every resource.
+ */
+#ifdef REST_ENGINE_CONF_TRIE_NODES
+#define REST_ENGINE_TRIE_NODES REST_ENGINE_CONF_TRIE_NODES
+#else
+#define REST_ENGINE_TRIE_NODES 32
+#endif
+
 struct resource_s;
 struct periodic_resource_s;
 
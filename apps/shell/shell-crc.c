@@ -194,7 +194,6 @@ PROCESS_THREAD(shell_hex2bin_process, ev, data)
 PROCESS_THREAD(shell_crc_process, ev, data)
 {
   struct shell_input *input;
-  int i;
   uint16_t crc;
   char *buf;
 
@@ -211,13 +210,8 @@ PROCESS_THREAD(shell_crc_process, ev, data)
     }
 
     /* calculate crc */
-    crc = 0;
-    for(i = 0; i < input->len1; i++) {
-      crc = crc16_add(((char*)(input->data1))[i], crc);
-    }
-    for(i = 0; i < input->len2; i++) {
-      crc = crc16_add(((char*)(input->data2))[i], crc);
-    }
+    crc = crc16_data((unsigned char *)input->data1, input->len1, 0);
+    crc = crc16_data((unsigned char *)input->data2, input->len2, crc);
 
     /* input + 16-bit CRC */
     buf = alloca(input->len2+2);
@@ -236,7 +230,6 @@ PROCESS_THREAD(shell_crc_process, ev, data)
 PROCESS_THREAD(shell_crcvalidate_process, ev, data)
 {
   struct shell_input *input;
-  int i;
   char crc1, crc2;
   uint16_t crc, crc_footer;
 
@@ -275,13 +268,8 @@ PROCESS_THREAD(shell_crcvalidate_process, ev, data)
     }
 
     /* recalculate crc */
-    crc = 0;
-    for(i = 0; i < input->len1; i++) {
-      crc = crc16_add(((char*)(input->data1))[i], crc);
-    }
-    for(i = 0; i < input->len2; i++) {
-      crc = crc16_add(((char*)(input->data2))[i], crc);
-    }
+    crc = crc16_data((unsigned char *)input->data1, input->len1, 0);
+    crc = crc16_data((unsigned char *)input->data2, input->len2, crc);
 
     /* compare with input crc */
     crc_footer = ((0xff&crc2)<<8) | (0xff&crc1);
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Shell command for TSCH radio-on time accounting
+ */
+
+#include "contiki.h"
+#include "shell-tsch.h"
+#include "net/mac/tsch/tsch-energest.h"
+
+#include <stdio.h>
+
+#if TSCH_ENERGEST_ENABLED
+#include "net/mac/tsch/tsch-log.h"
+
+static struct tsch_energest_snapshot snapshot;
+
+static const char *link_type_names[TSCH_ENERGEST_LINK_TYPES] = {
+  "eb", "shared", "unicast", "ssq"
+};
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_tsch_energy_process, "tsch-energy");
+SHELL_COMMAND(tsch_energy_command,
+	      "tsch-energy",
+	      "tsch-energy: print radio-on time (ms) per TSCH link type, slotframe and neighbor",
+	      &shell_tsch_energy_process);
+/*---------------------------------------------------------------------------*/
+static unsigned long
+ticks_to_ms(uint32_t ticks)
+{
+  return (ticks / RTIMER_SECOND) * 1000UL +
+    ((ticks % RTIMER_SECOND) * 1000UL) / RTIMER_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+static void
+output(const char *name, unsigned id, const struct tsch_energest *e)
+{
+  char buf[64];
+
+  if(e->slots == 0) {
+    return;
+  }
+  snprintf(buf, sizeof(buf), "%s %u tx %lu rx %lu slots %lu",
+           name, id, ticks_to_ms(e->tx), ticks_to_ms(e->rx),
+           (unsigned long)e->slots);
+  shell_output_str(&tsch_energy_command, buf, "");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_tsch_energy_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  tsch_energest_snapshot(&snapshot);
+
+  for(i = 0; i < TSCH_ENERGEST_LINK_TYPES; i++) {
+    output(link_type_names[i], i, &snapshot.link_types[i]);
+  }
+  for(i = 0; i < TSCH_ENERGEST_SLOTFRAMES; i++) {
+    output("sf", i, &snapshot.slotframes[i]);
+  }
+  for(i = 0; i < TSCH_QUEUE_MAX_NEIGHBOR_QUEUES; i++) {
+    output("nbr", TSCH_LOG_ID_FROM_LINKADDR(&snapshot.neighbors[i].addr),
+           &snapshot.neighbors[i].energest);
+  }
+
+  PROCESS_END();
+}
+#endif /* TSCH_ENERGEST_ENABLED */
+/*---------------------------------------------------------------------------*/
+void
+shell_tsch_init(void)
+{
+#if TSCH_ENERGEST_ENABLED
+  shell_register_command(&tsch_energy_command);
+#endif /* TSCH_ENERGEST_ENABLED */
+}
+/*---------------------------------------------------------------------------*/
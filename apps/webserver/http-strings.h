@@ -34,3 +34,8 @@ extern const char http_jpg[5];
 extern const char http_text[6];
 extern const char http_txt[5];
 extern const char http_redirect[19];
+extern const char http_header_304[95];
+extern const char http_header_406[97];
+extern const char http_if_none_match[15];
+extern const char http_accept_encoding[17];
+extern const char http_gzip[5];
@@ -37,10 +37,23 @@
 #include "httpd-fs.h"
 #include "httpd-fsdata.h"
 
+#ifdef HTTPD_FS_CONF_FSDATA
+#include HTTPD_FS_CONF_FSDATA
+#else /* HTTPD_FS_CONF_FSDATA */
 #include "httpd-fsdata.c"
+#endif /* HTTPD_FS_CONF_FSDATA */
+
+#if HTTPD_FS_INDEX && !defined(HTTPD_FS_HASH_SIZE)
+#error "HTTPD_FS_CONF_INDEX requires httpd-fsdata.c generated with makefsdata -H"
+#endif
 
 #if HTTPD_FS_STATISTICS
-static uint16_t count[HTTPD_FS_NUMFILES];
+#if HTTPD_FS_INDEX
+#define HTTPD_FS_SLOTS HTTPD_FS_HASH_SIZE
+#else /* HTTPD_FS_INDEX */
+#define HTTPD_FS_SLOTS HTTPD_FS_NUMFILES
+#endif /* HTTPD_FS_INDEX */
+static uint16_t count[HTTPD_FS_SLOTS];
 #endif /* HTTPD_FS_STATISTICS */
 
 /*-----------------------------------------------------------------------------------*/
@@ -65,6 +78,50 @@ loop:
   goto loop;
 }
 /*-----------------------------------------------------------------------------------*/
+#if HTTPD_FS_INDEX
+/* Returns the index slot of name, or -1. The hash must match the one
+   computed by tools/makefsdata. */
+static int
+httpd_fs_lookup(const char *name)
+{
+  const char *p;
+  uint32_t h;
+  uint16_t slot;
+
+  h = HTTPD_FS_HASH_SEED;
+  for(p = name; *p != 0 && *p != '\r' && *p != '\n'; p++) {
+    h = (h * 33) ^ (uint8_t)*p;
+  }
+  slot = h & (HTTPD_FS_HASH_SIZE - 1);
+  if(httpd_fsdata_index[slot].file == NULL ||
+     httpd_fs_strcmp(name, httpd_fsdata_index[slot].file->name) != 0) {
+    return -1;
+  }
+  return slot;
+}
+/*-----------------------------------------------------------------------------------*/
+int
+httpd_fs_open(const char *name, struct httpd_fs_file *file)
+{
+  const struct httpd_fsdata_index *e;
+  int slot;
+
+  slot = httpd_fs_lookup(name);
+  if(slot < 0) {
+    return 0;
+  }
+  e = &httpd_fsdata_index[slot];
+  file->data = (char *)e->file->data;
+  file->len = e->file->len;
+  file->etag = e->etag;
+  file->header_len = e->header_len;
+  file->gzip = e->gzip;
+#if HTTPD_FS_STATISTICS
+  ++count[slot];
+#endif /* HTTPD_FS_STATISTICS */
+  return 1;
+}
+#else /* HTTPD_FS_INDEX */
 int
 httpd_fs_open(const char *name, struct httpd_fs_file *file)
 {
@@ -92,13 +149,14 @@ httpd_fs_open(const char *name, struct httpd_fs_file *file)
   }
   return 0;
 }
+#endif /* HTTPD_FS_INDEX */
 /*-----------------------------------------------------------------------------------*/
 void
 httpd_fs_init(void)
 {
 #if HTTPD_FS_STATISTICS
   uint16_t i;
-  for(i = 0; i < HTTPD_FS_NUMFILES; i++) {
+  for(i = 0; i < HTTPD_FS_SLOTS; i++) {
     count[i] = 0;
   }
 #endif /* HTTPD_FS_STATISTICS */
@@ -108,6 +166,12 @@ httpd_fs_init(void)
 uint16_t
 httpd_fs_count(char *name)
 {
+#if HTTPD_FS_INDEX
+  int slot;
+
+  slot = httpd_fs_lookup(name);
+  return slot < 0 ? 0 : count[slot];
+#else /* HTTPD_FS_INDEX */
   struct httpd_fsdata_file_noconst *f;
   uint16_t i;
 
@@ -122,6 +186,7 @@ httpd_fs_count(char *name)
     ++i;
   }
   return 0;
+#endif /* HTTPD_FS_INDEX */
 }
 #endif /* HTTPD_FS_STATISTICS */
 /*-----------------------------------------------------------------------------------*/
@@ -38,9 +38,23 @@
 
 #define HTTPD_FS_STATISTICS 1
 
+/* Look files up through the hash index and serve their precomputed
+   headers. Requires httpd-fsdata.c to be generated with makefsdata -H. */
+#ifdef HTTPD_FS_CONF_INDEX
+#define HTTPD_FS_INDEX HTTPD_FS_CONF_INDEX
+#else /* HTTPD_FS_CONF_INDEX */
+#define HTTPD_FS_INDEX 0
+#endif /* HTTPD_FS_CONF_INDEX */
+
 struct httpd_fs_file {
   char *data;
   int len;
+#if HTTPD_FS_INDEX
+  uint32_t etag;
+  /* Length of the HTTP header stored right before data, 0 if none. */
+  uint16_t header_len;
+  uint8_t gzip;
+#endif /* HTTPD_FS_INDEX */
 };
 
 /* file must be allocated by caller and will be filled in
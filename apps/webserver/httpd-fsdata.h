@@ -60,4 +60,13 @@ struct httpd_fsdata_file_noconst {
 #endif /* HTTPD_FS_STATISTICS */
 };
 
+/* Perfect hash index of the files, emitted by makefsdata -H. Each
+   file is stored as name, precomputed HTTP header, body. */
+struct httpd_fsdata_index {
+  const struct httpd_fsdata_file *file;
+  uint32_t etag;
+  uint16_t header_len;
+  uint8_t gzip;
+};
+
 #endif /* HTTPD_FSDATA_H_ */
@@ -58,8 +58,10 @@
 MEMB(conns, struct httpd_state, CONNS);
 
 #define ISO_nl      0x0a
+#define ISO_cr      0x0d
 #define ISO_space   0x20
 #define ISO_bang    0x21
+#define ISO_quote   0x22
 #define ISO_percent 0x25
 #define ISO_period  0x2e
 #define ISO_slash   0x2f
@@ -105,6 +107,21 @@ PT_THREAD(send_part_of_file(struct httpd_state *s))
   PSOCK_END(&s->sout);
 }
 /*---------------------------------------------------------------------------*/
+#if HTTPD_FS_INDEX
+static
+PT_THREAD(send_file_with_header(struct httpd_state *s))
+{
+  PSOCK_BEGIN(&s->sout);
+
+  /* The header is stored right before the body, so both go out from
+     the file system data in a single send. */
+  PSOCK_SEND(&s->sout, (uint8_t *)s->file.data - s->file.header_len,
+             s->file.header_len + s->file.len);
+
+  PSOCK_END(&s->sout);
+}
+#endif /* HTTPD_FS_INDEX */
+/*---------------------------------------------------------------------------*/
 static void
 next_scriptstate(struct httpd_state *s)
 {
@@ -229,6 +246,21 @@ PT_THREAD(handle_output(struct httpd_state *s))
 		   http_header_404));
     PT_WAIT_THREAD(&s->outputpt,
 		   send_file(s));
+#if HTTPD_FS_INDEX
+  } else if(s->file.header_len > 0) {
+    if(s->file.gzip && !s->accept_gzip) {
+      PT_WAIT_THREAD(&s->outputpt,
+		     send_headers(s,
+		     http_header_406));
+    } else if(s->etag_valid && s->etag == s->file.etag) {
+      PT_WAIT_THREAD(&s->outputpt,
+		     send_headers(s,
+		     http_header_304));
+    } else {
+      PT_WAIT_THREAD(&s->outputpt,
+		     send_file_with_header(s));
+    }
+#endif /* HTTPD_FS_INDEX */
   } else {
     PT_WAIT_THREAD(&s->outputpt,
 		   send_headers(s,
@@ -246,6 +278,66 @@ PT_THREAD(handle_output(struct httpd_state *s))
   PT_END(&s->outputpt);
 }
 /*---------------------------------------------------------------------------*/
+#if HTTPD_FS_INDEX
+static char
+to_lower(char c)
+{
+  if(c >= 'A' && c <= 'Z') {
+    return c + ('a' - 'A');
+  }
+  return c;
+}
+/*---------------------------------------------------------------------------*/
+/* Header names and content codings are case-insensitive (RFC 7230). */
+static uint8_t
+starts_with(const char *str, const char *prefix, uint8_t len)
+{
+  uint8_t i;
+
+  for(i = 0; i < len; i++) {
+    if(to_lower(str[i]) != to_lower(prefix[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+has_gzip(const char *ptr)
+{
+  for(; *ptr != 0; ptr++) {
+    if(starts_with(ptr, http_gzip, 4)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+parse_etag(struct httpd_state *s, const char *ptr)
+{
+  uint8_t i;
+  char c;
+
+  while(*ptr == ISO_space || *ptr == ISO_quote) {
+    ++ptr;
+  }
+  s->etag = 0;
+  for(i = 0; i < 8; i++) {
+    c = to_lower(ptr[i]);
+    if(c >= '0' && c <= '9') {
+      c -= '0';
+    } else if(c >= 'a' && c <= 'f') {
+      c -= 'a' - 10;
+    } else {
+      return;
+    }
+    s->etag = (s->etag << 4) | c;
+  }
+  s->etag_valid = ptr[8] == ISO_quote;
+}
+#endif /* HTTPD_FS_INDEX */
+/*---------------------------------------------------------------------------*/
 static
 PT_THREAD(handle_input(struct httpd_state *s))
 {
@@ -272,7 +364,9 @@ PT_THREAD(handle_input(struct httpd_state *s))
   petsciiconv_topetscii(s->filename, sizeof(s->filename));
   webserver_log_file(&uip_conn->ripaddr, s->filename);
   petsciiconv_toascii(s->filename, sizeof(s->filename));
+#if !HTTPD_FS_INDEX
   s->state = STATE_OUTPUT;
+#endif /* !HTTPD_FS_INDEX */
 
   while(1) {
     PSOCK_READTO(&s->sin, ISO_nl);
@@ -282,6 +376,19 @@ PT_THREAD(handle_input(struct httpd_state *s))
       petsciiconv_topetscii(s->inputbuf, PSOCK_DATALEN(&s->sin) - 2);
       webserver_log(s->inputbuf);
     }
+#if HTTPD_FS_INDEX
+    /* Conditional and encoding headers decide the response, so wait
+       for the end of the request before answering. */
+    s->inputbuf[PSOCK_DATALEN(&s->sin)] = 0;
+    if(starts_with(s->inputbuf, http_if_none_match, 14)) {
+      parse_etag(s, s->inputbuf + 14);
+    } else if(starts_with(s->inputbuf, http_accept_encoding, 16) &&
+              has_gzip(s->inputbuf + 16)) {
+      s->accept_gzip = 1;
+    } else if(s->inputbuf[0] == ISO_nl || s->inputbuf[0] == ISO_cr) {
+      s->state = STATE_OUTPUT;
+    }
+#endif /* HTTPD_FS_INDEX */
   }
   
   PSOCK_END(&s->sin);
@@ -316,6 +423,10 @@ httpd_appcall(void *state)
     PSOCK_INIT(&s->sout, (uint8_t *)s->inputbuf, sizeof(s->inputbuf) - 1);
     PT_INIT(&s->outputpt);
     s->state = STATE_WAITING;
+#if HTTPD_FS_INDEX
+    s->etag_valid = 0;
+    s->accept_gzip = 0;
+#endif /* HTTPD_FS_INDEX */
     /*    timer_set(&s->timer, CLOCK_SECOND * 100);*/
     s->timer = 0;
     handle_connection(s);
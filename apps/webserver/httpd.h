@@ -49,6 +49,11 @@ struct httpd_state {
   int len;
   char *scriptptr;
   int scriptlen;
+#if HTTPD_FS_INDEX
+  uint32_t etag;
+  char etag_valid;
+  char accept_gzip;
+#endif /* HTTPD_FS_INDEX */
   union {
     unsigned short count;
     void *ptr;
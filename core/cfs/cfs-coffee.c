@@ -84,6 +84,29 @@
 #define COFFEE_EXTENDED_WEAR_LEVELLING  1
 #endif
 
+/*
+ * Keep an index of file names and free pages in RAM, so that opening
+ * a file and reserving pages do not have to scan the file headers.
+ * The index is built from the headers when the file system is first
+ * used, or explicitly with cfs_coffee_mount().
+ */
+#ifdef COFFEE_CONF_INDEX
+#define COFFEE_INDEX COFFEE_CONF_INDEX
+#else
+#define COFFEE_INDEX 0
+#endif
+
+/*
+ * Number of slots in the file name index; must be a power of two.
+ * At most three quarters of them are used. Files beyond that are
+ * still found, by scanning the headers as without the index.
+ */
+#ifdef COFFEE_CONF_INDEX_FILES
+#define COFFEE_INDEX_FILES COFFEE_CONF_INDEX_FILES
+#else
+#define COFFEE_INDEX_FILES 32
+#endif
+
 #if COFFEE_START & (COFFEE_SECTOR_SIZE - 1)
 #error COFFEE_START must point to the first byte in a sector.
 #endif
@@ -206,6 +229,31 @@ static struct file_desc coffee_fd_set[COFFEE_FD_SET_SIZE];
 static coffee_page_t next_free;
 static char gc_wait;
 
+#if COFFEE_INDEX
+/* A slot of the file name index, which uses open addressing with
+   linear probing. Empty slots have the page INVALID_PAGE. */
+struct index_entry {
+  coffee_page_t page;
+  uint16_t hash;
+};
+
+#define INDEX_MASK      (COFFEE_INDEX_FILES - 1)
+#define INDEX_MAX_FILES (COFFEE_INDEX_FILES - COFFEE_INDEX_FILES / 4)
+
+static struct index_entry name_index[COFFEE_INDEX_FILES];
+static coffee_page_t index_count;
+/* Files that did not fit in the name index. As long as there is one,
+   find_file() has to fall back to scanning the headers. */
+static coffee_page_t unindexed;
+/* The offset of the first free page in each sector. Pages are
+   allocated in order within a sector, so its free pages always
+   form a suffix of it. */
+static coffee_page_t sector_free[COFFEE_SECTOR_COUNT];
+static uint8_t index_mounted;
+
+static void index_scan(int add_names);
+#endif /* COFFEE_INDEX */
+
 /*---------------------------------------------------------------------------*/
 static void
 write_header(struct file_header *hdr, coffee_page_t page)
@@ -354,6 +402,9 @@ collect_garbage(int mode)
   coffee_page_t sector;
   struct sector_status stats;
   coffee_page_t first_page, isolation_count;
+#if COFFEE_INDEX
+  int erased = 0;
+#endif /* COFFEE_INDEX */
 
   PRINTF("Coffee: Running the garbage collector in %s mode\n",
          mode == GC_RELUCTANT ? "reluctant" : "greedy");
@@ -384,12 +435,24 @@ collect_garbage(int mode)
 
       COFFEE_ERASE(sector);
       PRINTF("Coffee: Erased sector %d!\n", sector);
+#if COFFEE_INDEX
+      erased = 1;
+#endif /* COFFEE_INDEX */
 
       if(mode == GC_RELUCTANT && isolation_count > 0) {
         break;
       }
     }
   }
+
+#if COFFEE_INDEX
+  /* An erased sector may still be covered in part by an obsolete file
+     starting in the previous sector, so its free pages are taken from
+     the headers again. */
+  if(erased && index_mounted) {
+    index_scan(0);
+  }
+#endif /* COFFEE_INDEX */
 }
 /*---------------------------------------------------------------------------*/
 static coffee_page_t
@@ -452,6 +515,154 @@ load_file(coffee_page_t start, struct file_header *hdr)
   return file;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_INDEX
+static uint16_t
+name_hash(const char *name)
+{
+  uint16_t h;
+  int i;
+
+  /* Only the part of the name that fits in a file header counts */
+  h = 0;
+  for(i = 0; i < COFFEE_NAME_LENGTH - 1 && name[i] != '\0'; i++) {
+    h = (h << 5) - h + (unsigned char)name[i];
+  }
+  return h;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add(const char *name, coffee_page_t page)
+{
+  uint16_t h;
+  unsigned i;
+
+  if(index_count >= INDEX_MAX_FILES) {
+    unindexed++;
+    return;
+  }
+
+  h = name_hash(name);
+  for(i = h & INDEX_MASK;
+      name_index[i].page != INVALID_PAGE;
+      i = (i + 1) & INDEX_MASK);
+  name_index[i].page = page;
+  name_index[i].hash = h;
+  index_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(const char *name, coffee_page_t page)
+{
+  unsigned i, j, home;
+
+  for(i = name_hash(name) & INDEX_MASK;
+      name_index[i].page != page;
+      i = (i + 1) & INDEX_MASK) {
+    if(name_index[i].page == INVALID_PAGE) {
+      /* Not in the index */
+      if(unindexed > 0) {
+        unindexed--;
+      }
+      return;
+    }
+  }
+
+  /* Shift back the following entries of the probe sequence, so that
+     lookups do not stop at the hole left by the removed entry. */
+  for(j = (i + 1) & INDEX_MASK;
+      name_index[j].page != INVALID_PAGE;
+      j = (j + 1) & INDEX_MASK) {
+    home = name_index[j].hash & INDEX_MASK;
+    if(((j - home) & INDEX_MASK) >= ((j - i) & INDEX_MASK)) {
+      name_index[i] = name_index[j];
+      i = j;
+    }
+  }
+  name_index[i].page = INVALID_PAGE;
+  index_count--;
+}
+/*---------------------------------------------------------------------------*/
+static coffee_page_t
+index_lookup(const char *name, struct file_header *hdr)
+{
+  uint16_t h;
+  unsigned i;
+
+  h = name_hash(name);
+  for(i = h & INDEX_MASK;
+      name_index[i].page != INVALID_PAGE;
+      i = (i + 1) & INDEX_MASK) {
+    if(name_index[i].hash == h) {
+      read_header(hdr, name_index[i].page);
+      if(HDR_ACTIVE(*hdr) && !HDR_LOG(*hdr) && strcmp(name, hdr->name) == 0) {
+        return name_index[i].page;
+      }
+    }
+  }
+  return INVALID_PAGE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_allocate(coffee_page_t page, coffee_page_t pages)
+{
+  coffee_page_t sector;
+  coffee_page_t end;
+
+  for(sector = page / COFFEE_PAGES_PER_SECTOR;
+      sector < COFFEE_SECTOR_COUNT &&
+      sector * COFFEE_PAGES_PER_SECTOR < page + pages;
+      sector++) {
+    end = page + pages - sector * COFFEE_PAGES_PER_SECTOR;
+    sector_free[sector] = end < COFFEE_PAGES_PER_SECTOR ?
+      end : COFFEE_PAGES_PER_SECTOR;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_clear(coffee_page_t first_free)
+{
+  coffee_page_t i;
+
+  for(i = 0; i < COFFEE_INDEX_FILES; i++) {
+    name_index[i].page = INVALID_PAGE;
+  }
+  for(i = 0; i < COFFEE_SECTOR_COUNT; i++) {
+    sector_free[i] = first_free;
+  }
+  index_count = 0;
+  unindexed = 0;
+  index_mounted = 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_scan(int add_names)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+
+  /* A sector that the walk jumps over has no free pages */
+  for(page = 0; page < COFFEE_SECTOR_COUNT; page++) {
+    sector_free[page] = COFFEE_PAGES_PER_SECTOR;
+  }
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(HDR_FREE(hdr)) {
+      sector_free[page / COFFEE_PAGES_PER_SECTOR] =
+        page % COFFEE_PAGES_PER_SECTOR;
+    } else if(add_names && HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
+      index_add(hdr.name, page);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_mount(void)
+{
+  index_clear(COFFEE_PAGES_PER_SECTOR);
+  index_scan(1);
+}
+#endif /* COFFEE_INDEX */
+/*---------------------------------------------------------------------------*/
 static struct file *
 find_file(const char *name)
 {
@@ -459,6 +670,25 @@ find_file(const char *name)
   struct file_header hdr;
   coffee_page_t page;
 
+#if COFFEE_INDEX
+  if(!index_mounted) {
+    index_mount();
+  }
+
+  if(unindexed == 0) {
+    page = index_lookup(name, &hdr);
+    if(page == INVALID_PAGE) {
+      return NULL;
+    }
+    for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
+      if(!FILE_FREE(&coffee_files[i]) && coffee_files[i].page == page) {
+        return &coffee_files[i];
+      }
+    }
+    return load_file(page, &hdr);
+  }
+#endif /* COFFEE_INDEX */
+
   /* First check if the file metadata is cached. */
   for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
     if(FILE_FREE(&coffee_files[i])) {
@@ -516,6 +746,50 @@ file_end(coffee_page_t start)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_INDEX
+static coffee_page_t
+find_contiguous_pages(coffee_page_t amount)
+{
+  coffee_page_t sector, start, first;
+
+  if(!index_mounted) {
+    index_mount();
+  }
+
+  /* Same search as below, but on the free page offsets of the sectors
+     instead of the file headers. A run of free pages can only continue
+     into a sector that is entirely free. */
+  start = INVALID_PAGE;
+  for(sector = next_free / COFFEE_PAGES_PER_SECTOR;
+      sector < COFFEE_SECTOR_COUNT;
+      sector++) {
+    if(sector_free[sector] >= COFFEE_PAGES_PER_SECTOR) {
+      start = INVALID_PAGE;
+      continue;
+    }
+
+    first = sector * COFFEE_PAGES_PER_SECTOR + sector_free[sector];
+    if(first < next_free) {
+      first = next_free;
+    }
+    if(start == INVALID_PAGE || sector_free[sector] > 0) {
+      start = first;
+      if(start + amount >= COFFEE_PAGE_COUNT) {
+        /* We can stop immediately if the remaining pages are not enough. */
+        break;
+      }
+    }
+
+    if(start + amount <= (sector + 1) * COFFEE_PAGES_PER_SECTOR) {
+      if(start == next_free) {
+        next_free = start + amount;
+      }
+      return start;
+    }
+  }
+  return INVALID_PAGE;
+}
+#else /* COFFEE_INDEX */
 static coffee_page_t
 find_contiguous_pages(coffee_page_t amount)
 {
@@ -551,6 +825,7 @@ find_contiguous_pages(coffee_page_t amount)
   }
   return INVALID_PAGE;
 }
+#endif /* COFFEE_INDEX */
 /*---------------------------------------------------------------------------*/
 static int
 remove_by_page(coffee_page_t page, int remove_log,
@@ -572,6 +847,11 @@ remove_by_page(coffee_page_t page, int remove_log,
 
   hdr.flags |= HDR_FLAG_OBSOLETE;
   write_header(&hdr, page);
+#if COFFEE_INDEX
+  if(index_mounted && !HDR_LOG(hdr)) {
+    index_remove(hdr.name, page);
+  }
+#endif /* COFFEE_INDEX */
 
   gc_wait = 0;
 
@@ -636,6 +916,12 @@ reserve(const char *name, coffee_page_t pages,
   hdr.max_pages = pages;
   hdr.flags = HDR_FLAG_ALLOCATED | flags;
   write_header(&hdr, page);
+#if COFFEE_INDEX
+  index_allocate(page, pages);
+  if(!(flags & HDR_FLAG_LOG)) {
+    index_add(name, page);
+  }
+#endif /* COFFEE_INDEX */
 
   PRINTF("Coffee: Reserved %u pages starting from %u for file %s\n",
          (unsigned)pages, (unsigned)page, name);
@@ -1338,9 +1624,21 @@ cfs_coffee_format(void)
   memset(&coffee_fd_set, 0, sizeof(coffee_fd_set));
   next_free = 0;
   gc_wait = 1;
+#if COFFEE_INDEX
+  index_clear(0);
+#endif /* COFFEE_INDEX */
 
   PRINTF(" done!\n");
 
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+int
+cfs_coffee_mount(void)
+{
+#if COFFEE_INDEX
+  index_mount();
+#endif /* COFFEE_INDEX */
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
@@ -140,6 +140,18 @@ int cfs_coffee_set_io_semantics(int fd, unsigned flags);
  */
 int cfs_coffee_format(void);
 
+/**
+ * \brief Build the in-RAM index of the file system.
+ * \return 0 on success, -1 on failure.
+ *
+ * With COFFEE_CONF_INDEX, Coffee keeps an index of the file names
+ * and of the free pages in RAM, and builds it by scanning the file
+ * headers when the file system is first used. Calling this function
+ * at boot moves the cost of the scan out of the first file operation.
+ * Without the index, the function does nothing.
+ */
+int cfs_coffee_mount(void);
+
 /** @} */
 /** @} */
 
@@ -55,6 +55,23 @@
 #ifndef CRC16_H_
 #define CRC16_H_
 
+#include "contiki-conf.h"
+
+/**
+ * Number of bytes crc16_data() adds per step: 0 for the table-less
+ * shift-and-xor code, or 1, 4 or 8 for table-driven code, at the cost
+ * of 512 bytes of ROM per byte.
+ */
+#ifdef CRC16_CONF_SLICES
+#define CRC16_SLICES CRC16_CONF_SLICES
+#else /* CRC16_CONF_SLICES */
+#define CRC16_SLICES 0
+#endif /* CRC16_CONF_SLICES */
+
+#if CRC16_SLICES != 0 && CRC16_SLICES != 1 && CRC16_SLICES != 4 && CRC16_SLICES != 8
+#error "CRC16_CONF_SLICES must be 0, 1, 4 or 8"
+#endif
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -82,10 +99,10 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  *
  *             This function calculates the CRC16 checksum of a data area.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note Unless CRC16_CONF_SLICES is set, the algorithm
+ *             used in this implementation is tailored for a running
+ *             checksum and does not perform as well as a table-driven
+ *             algorithm when checksumming an entire data block.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
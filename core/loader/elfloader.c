@@ -172,6 +172,140 @@ seek_write(int fd, unsigned int offset, char *buf, int len)
 }
 */
 /*---------------------------------------------------------------------------*/
+#if ELFLOADER_BUFFERED
+/* Relocation entries read at once. */
+#define RELA_CHUNK 16
+
+/* The scratch arena holds a chunk of relocations, then the symbol
+   table, the string table and a hash of the symbol names of the module
+   being loaded. */
+static union {
+  uint32_t align;
+  char mem[ELFLOADER_SCRATCH_SIZE];
+} scratch;
+
+static unsigned char buffered;
+static char *relas;
+static unsigned int relas_start, relas_len;
+static struct elf32_sym *syms;
+static unsigned short nsyms;
+static char *strings;
+static unsigned short strings_size;
+/* Symbol index + 1 for each slot, 0 if the slot is empty. */
+static uint16_t *names;
+static uint16_t names_mask;
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+name_hash(const char *name)
+{
+  uint16_t h;
+
+  for(h = 5381; *name != 0; name++) {
+    h = h * 33 + (unsigned char)*name;
+  }
+  return h;
+}
+/*---------------------------------------------------------------------------*/
+/* Reads the symbol and string tables into the scratch arena and hashes
+   the symbol names. Returns 0 if they do not fit. */
+static int
+buffer_tables(int fd, unsigned int symtab, unsigned short symtabsize,
+	      unsigned int strtab, unsigned short strtabsize)
+{
+  unsigned int used;
+  uint16_t slots;
+  uint16_t slot;
+  uint16_t i;
+
+  nsyms = symtabsize / sizeof(struct elf32_sym);
+  for(slots = 2; slots < 2 * nsyms; slots *= 2);
+
+  used = RELA_CHUNK * sizeof(struct elf32_rela) +
+    nsyms * sizeof(struct elf32_sym) +
+    ((strtabsize + 2) & ~1) + slots * sizeof(uint16_t);
+  if(used > sizeof(scratch.mem)) {
+    PRINTF("elfloader: %u bytes of tables, not buffered\n", used);
+    return 0;
+  }
+
+  relas = scratch.mem;
+  relas_len = 0;
+  syms = (struct elf32_sym *)(relas + RELA_CHUNK * sizeof(struct elf32_rela));
+  strings = (char *)&syms[nsyms];
+  strings_size = strtabsize;
+  names = (uint16_t *)&strings[(strtabsize + 2) & ~1];
+  names_mask = slots - 1;
+
+  seek_read(fd, symtab, (char *)syms, nsyms * sizeof(struct elf32_sym));
+  seek_read(fd, strtab, strings, strtabsize);
+  strings[strtabsize] = 0;
+
+  /* Symbols are inserted in table order, so the first of several
+     symbols with the same name is found first, as in the table scan. */
+  memset(names, 0, slots * sizeof(uint16_t));
+  for(i = 0; i < nsyms; i++) {
+    if(syms[i].st_name != 0 && syms[i].st_name < strings_size) {
+      for(slot = name_hash(&strings[syms[i].st_name]) & names_mask;
+	  names[slot] != 0;
+	  slot = (slot + 1) & names_mask);
+      names[slot] = i + 1;
+    }
+  }
+  return 1;
+}
+#endif /* ELFLOADER_BUFFERED */
+/*---------------------------------------------------------------------------*/
+static void
+read_rela(int fd, unsigned int a, unsigned int end,
+	  struct elf32_rela *rela, int rel_size)
+{
+#if ELFLOADER_BUFFERED
+  if(buffered) {
+    if(a < relas_start || a + rel_size > relas_start + relas_len) {
+      relas_start = a;
+      relas_len = end - a;
+      if(relas_len > RELA_CHUNK * rel_size) {
+	relas_len = RELA_CHUNK * rel_size;
+      }
+      seek_read(fd, a, relas, relas_len);
+    }
+    memcpy(rela, &relas[a - relas_start], rel_size);
+    return;
+  }
+#endif /* ELFLOADER_BUFFERED */
+  seek_read(fd, a, (char *)rela, rel_size);
+}
+/*---------------------------------------------------------------------------*/
+static void
+read_symbol(int fd, unsigned int symtab, unsigned int index,
+	    struct elf32_sym *s)
+{
+#if ELFLOADER_BUFFERED
+  if(buffered && index < nsyms) {
+    memcpy(s, &syms[index], sizeof(*s));
+    return;
+  }
+#endif /* ELFLOADER_BUFFERED */
+  seek_read(fd, symtab + sizeof(struct elf32_sym) * index,
+	    (char *)s, sizeof(*s));
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the name of symbol s, read into buf unless the string table
+   is buffered. */
+static const char *
+symbol_name(int fd, unsigned int strtab, const struct elf32_sym *s,
+	    char *buf, int len)
+{
+#if ELFLOADER_BUFFERED
+  if(buffered && s->st_name < strings_size) {
+    return &strings[s->st_name];
+  }
+#endif /* ELFLOADER_BUFFERED */
+  seek_read(fd, strtab + s->st_name, buf, len);
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
 static void *
 find_local_symbol(int fd, const char *symbol,
 		  unsigned int symtab, unsigned short symtabsize,
@@ -181,6 +315,32 @@ find_local_symbol(int fd, const char *symbol,
   unsigned int a;
   char name[30];
   struct relevant_section *sect;
+#if ELFLOADER_BUFFERED
+  uint16_t slot;
+
+  if(buffered) {
+    for(slot = name_hash(symbol) & names_mask;
+	names[slot] != 0;
+	slot = (slot + 1) & names_mask) {
+      s = syms[names[slot] - 1];
+      if(strcmp(&strings[s.st_name], symbol) == 0) {
+	if(s.st_shndx == bss.number) {
+	  sect = &bss;
+	} else if(s.st_shndx == data.number) {
+	  sect = &data;
+	} else if(s.st_shndx == rodata.number) {
+	  sect = &rodata;
+	} else if(s.st_shndx == text.number) {
+	  sect = &text;
+	} else {
+	  return NULL;
+	}
+	return &(sect->address[s.st_value]);
+      }
+    }
+    return NULL;
+  }
+#endif /* ELFLOADER_BUFFERED */
   
   for(a = symtab; a < symtab + symtabsize; a += sizeof(s)) {
     seek_read(fd, a, (char *)&s, sizeof(s));
@@ -221,7 +381,8 @@ relocate_section(int fd,
   int rel_size = 0;
   struct elf32_sym s;
   unsigned int a;
-  char name[30];
+  char namebuf[30];
+  const char *name;
   char *addr;
   struct relevant_section *sect;
 
@@ -233,12 +394,10 @@ relocate_section(int fd,
   }
   
   for(a = section; a < section + size; a += rel_size) {
-    seek_read(fd, a, (char *)&rela, rel_size);
-    seek_read(fd,
-	      symtab + sizeof(struct elf32_sym) * ELF32_R_SYM(rela.r_info),
-	      (char *)&s, sizeof(s));
+    read_rela(fd, a, section + size, &rela, rel_size);
+    read_symbol(fd, symtab, ELF32_R_SYM(rela.r_info), &s);
     if(s.st_name != 0) {
-      seek_read(fd, strtab + s.st_name, name, sizeof(name));
+      name = symbol_name(fd, strtab, &s, namebuf, sizeof(namebuf));
       PRINTF("name: %s\n", name);
       addr = (char *)symtab_lookup(name);
       /* ADDED */
@@ -258,7 +417,7 @@ relocate_section(int fd,
 	  sect = &text;
 	} else {
 	  PRINTF("elfloader unknown name: '%30s'\n", name);
-	  memcpy(elfloader_unknown, name, sizeof(elfloader_unknown));
+	  strncpy(elfloader_unknown, name, sizeof(elfloader_unknown));
 	  elfloader_unknown[sizeof(elfloader_unknown) - 1] = 0;
 	  return ELFLOADER_SYMBOL_NOT_FOUND;
 	}
@@ -438,7 +597,9 @@ elfloader_load(int fd)
       PRINTF("symtab\n");
       symtaboff = shdr.sh_offset;
       symtabsize = shdr.sh_size;
-    } else if(shdr.sh_type == SHT_STRTAB/*strncmp(name, ".strtab", 7) == 0*/) {
+    } else if(shdr.sh_type == SHT_STRTAB/*strncmp(name, ".strtab", 7) == 0*/ &&
+	      i != ehdr.e_shstrndx) {
+      /* Newer binutils put the section name table last. */
       PRINTF("strtab\n");
       strtaboff = shdr.sh_offset;
       strtabsize = shdr.sh_size;
@@ -504,6 +665,10 @@ elfloader_load(int fd)
     return ELFLOADER_NO_TEXT;
   }
 
+#if ELFLOADER_BUFFERED
+  buffered = buffer_tables(fd, symtaboff, symtabsize, strtaboff, strtabsize);
+#endif /* ELFLOADER_BUFFERED */
+
   PRINTF("before allocate ram\n");
   bss.address = (char *)elfloader_arch_allocate_ram(bsssize + datasize);
   data.address = (char *)bss.address + bsssize;
@@ -175,11 +175,31 @@ extern char elfloader_unknown[30];
 #endif
 #endif /* ELFLOADER_TEXTMEMORY_SIZE */
 
-typedef unsigned long  elf32_word;
-typedef   signed long  elf32_sword;
-typedef unsigned short elf32_half;
-typedef unsigned long  elf32_off;
-typedef unsigned long  elf32_addr;
+#ifndef ELFLOADER_BUFFERED
+#ifdef ELFLOADER_CONF_BUFFERED
+#define ELFLOADER_BUFFERED ELFLOADER_CONF_BUFFERED
+#else
+#define ELFLOADER_BUFFERED 0
+#endif
+#endif /* ELFLOADER_BUFFERED */
+
+/* With ELFLOADER_BUFFERED, the symbol and string tables of the module
+   are read into a scratch arena of this size, along with a hash of the
+   symbol names and a chunk of relocations. Modules whose tables do not
+   fit are loaded with one read per symbol, as without it. */
+#ifndef ELFLOADER_SCRATCH_SIZE
+#ifdef ELFLOADER_CONF_SCRATCH_SIZE
+#define ELFLOADER_SCRATCH_SIZE ELFLOADER_CONF_SCRATCH_SIZE
+#else
+#define ELFLOADER_SCRATCH_SIZE 1024
+#endif
+#endif /* ELFLOADER_SCRATCH_SIZE */
+
+typedef uint32_t elf32_word;
+typedef  int32_t elf32_sword;
+typedef uint16_t elf32_half;
+typedef uint32_t elf32_off;
+typedef uint32_t elf32_addr;
 
 struct elf32_rela {
   elf32_addr      r_offset;       /* Location to be relocated. */
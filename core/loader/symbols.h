@@ -41,4 +41,11 @@ extern const int symbols_nelts;
 
 extern const struct symbols symbols[/* symbols_nelts */];
 
+/* Open-addressed hash of the names in symbols[], generated along with
+   it for symtab_lookup() with SYMTAB_CONF_HASH. Each slot holds the
+   index of a symbol + 1, or 0 if empty. */
+extern const unsigned short symbols_hash_size;
+
+extern const unsigned short symbols_hash[/* symbols_hash_size */];
+
 #endif /* SYMBOLS_H_ */
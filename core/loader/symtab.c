@@ -41,8 +41,37 @@
 #define SYMTAB_CONF_BINARY_SEARCH 1
 #endif
 
+/* Look names up in the hash generated by tools/mknmlist or
+   tools/make-symbols-nm instead. */
+#ifndef SYMTAB_CONF_HASH
+#define SYMTAB_CONF_HASH 0
+#endif
+
 /*---------------------------------------------------------------------------*/
-#if SYMTAB_CONF_BINARY_SEARCH
+#if SYMTAB_CONF_HASH
+void *
+symtab_lookup(const char *name)
+{
+  const char *p;
+  unsigned short h;
+  unsigned short slot;
+
+  /* Same hash as the generators: h = h * 33 + c, modulo 2^16. */
+  h = 5381;
+  for(p = name; *p != 0; p++) {
+    h = h * 33 + (unsigned char)*p;
+  }
+
+  for(slot = h & (symbols_hash_size - 1);
+      symbols_hash[slot] != 0;
+      slot = (slot + 1) & (symbols_hash_size - 1)) {
+    if(strcmp(name, symbols[symbols_hash[slot] - 1].name) == 0) {
+      return symbols[symbols_hash[slot] - 1].value;
+    }
+  }
+  return NULL;
+}
+#elif SYMTAB_CONF_BINARY_SEARCH
 void *
 symtab_lookup(const char *name)
 {
@@ -78,5 +107,5 @@ symtab_lookup(const char *name)
   }
   return 0;
 }
-#endif /* SYMTAB_CONF_BINARY_SEARCH */
+#endif /* SYMTAB_CONF_HASH */
 /*---------------------------------------------------------------------------*/
@@ -407,7 +407,7 @@ eventhandler(process_event_t ev, process_data_t data)
       for(cptr = &uip_udp_conns[0];
           cptr < &uip_udp_conns[UIP_UDP_CONNS]; ++cptr) {
         if(cptr->appstate.p == p) {
-          cptr->lport = 0;
+          uip_udp_remove(cptr);
         }
       }
     }
@@ -816,6 +816,9 @@ PROCESS_THREAD(tcpip_process, ev, data)
 {
   PROCESS_BEGIN();
 
+  /* Keep packet processing ahead of application processes */
+  process_set_priority(PROCESS_CURRENT(), PROCESS_PRIORITY_HIGH);
+
 #if UIP_TCP
   {
     unsigned char i;
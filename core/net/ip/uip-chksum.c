@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2001-2003, Adam Dunkels.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote
+ *    products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the uIP TCP/IP stack.
+ *
+ *
+ */
+
+/**
+ * \file
+ *         Internet checksum kernel shared by uIP, uIPv6 and ip64
+ */
+
+#include "net/ip/uip-chksum.h"
+#include "net/ip/uip.h"
+
+#include <string.h>
+
+/* Sum 32-bit words into a 64-bit accumulator on CPUs that have 32-bit
+   registers, and 16-bit words into a 32-bit one on the others */
+#if UINTPTR_MAX > 0xffff
+typedef uint64_t acc_t;
+typedef uint32_t word_t;
+#else
+typedef uint32_t acc_t;
+typedef uint16_t word_t;
+#endif
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+fold(acc_t acc)
+{
+  while(acc >> 16) {
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  return (uint16_t)acc;
+}
+/*---------------------------------------------------------------------------*/
+/* Sum of the big-endian 16-bit words in data, which starts at an even
+   address. The words are added in host byte order, and the sum is
+   swapped once at the end. */
+static uint16_t
+sum_words(const uint8_t *data, uint16_t len)
+{
+  acc_t acc;
+  word_t w;
+  uint16_t h;
+
+  acc = 0;
+  if(sizeof(word_t) > 2 && ((uintptr_t)data & 2) && len >= 2) {
+    memcpy(&h, data, 2);
+    acc += h;
+    data += 2;
+    len -= 2;
+  }
+
+  while(len >= 4 * sizeof(word_t)) {
+    memcpy(&w, data, sizeof(w));
+    acc += w;
+    memcpy(&w, data + sizeof(w), sizeof(w));
+    acc += w;
+    memcpy(&w, data + 2 * sizeof(w), sizeof(w));
+    acc += w;
+    memcpy(&w, data + 3 * sizeof(w), sizeof(w));
+    acc += w;
+    data += 4 * sizeof(w);
+    len -= 4 * sizeof(w);
+  }
+  while(len >= 2) {
+    memcpy(&h, data, 2);
+    acc += h;
+    data += 2;
+    len -= 2;
+  }
+  if(len == 1) {
+    /* Padded with a zero byte */
+    acc += UIP_HTONS((uint16_t)(data[0] << 8));
+  }
+
+  return UIP_HTONS(fold(acc));
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  acc_t acc;
+  uint16_t rest;
+
+  acc = sum;
+  if(len > 0 && ((uintptr_t)data & 1)) {
+    /* Start the word loads at an even address. The rest of the data
+       is then off by one byte, which byte-swaps its sum (RFC 1071). */
+    acc += (uint16_t)(data[0] << 8);
+    rest = sum_words(data + 1, len - 1);
+    acc += (uint16_t)((rest << 8) | (rest >> 8));
+  } else {
+    acc += sum_words(data, len);
+  }
+  return fold(acc);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
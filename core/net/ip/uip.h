@@ -849,6 +849,21 @@ CCIF void uip_send(const void *data, int len);
  */
 struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
 
+#if UIP_CONN_HASH
+/**
+ * Set the local port of a UDP connection, 0 to remove it.
+ *
+ * With UIP_CONF_CONN_HASH, the local port must only be changed
+ * through this function, which keeps the connection hash in sync.
+ * uip_udp_bind() and uip_udp_remove() use it.
+ *
+ * \param conn A pointer to the uip_udp_conn structure for the connection.
+ *
+ * \param lport The local port number, in network byte order.
+ */
+void uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t lport);
+#endif /* UIP_CONN_HASH */
+
 /**
  * Remove a UDP connection.
  *
@@ -856,7 +871,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_HASH
+#define uip_udp_remove(conn) uip_udp_set_lport(conn, 0)
+#else /* UIP_CONN_HASH */
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif /* UIP_CONN_HASH */
 
 /**
  * Bind a UDP connection to a local port.
@@ -868,7 +887,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_HASH
+#define uip_udp_bind(conn, port) uip_udp_set_lport(conn, port)
+#else /* UIP_CONN_HASH */
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif /* UIP_CONN_HASH */
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -365,6 +365,38 @@ void uip_log(char *msg);
 #define UIP_UDP_CONNS    10
 #endif /* UIP_CONF_UDP_CONNS */
 
+/**
+ * Demultiplex incoming UDP and TCP through hash tables instead of a
+ * walk over all connections, and take UDP ephemeral ports from a
+ * bitmap. For hosts with many connections, with IPv6 only; the port
+ * bitmap alone takes close to 4 kbytes.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CONN_HASH
+#define UIP_CONN_HASH (UIP_CONF_CONN_HASH && NETSTACK_CONF_WITH_IPV6)
+#else /* UIP_CONF_CONN_HASH */
+#define UIP_CONN_HASH 0
+#endif /* UIP_CONF_CONN_HASH */
+
+/**
+ * The number of buckets in each connection hash table, a power of two.
+ * By default about one per UDP connection.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CONN_HASH_SIZE
+#define UIP_CONN_HASH_SIZE (UIP_CONF_CONN_HASH_SIZE)
+#elif UIP_UDP_CONNS <= 16
+#define UIP_CONN_HASH_SIZE 16
+#elif UIP_UDP_CONNS <= 64
+#define UIP_CONN_HASH_SIZE 64
+#elif UIP_UDP_CONNS <= 256
+#define UIP_CONN_HASH_SIZE 256
+#else
+#define UIP_CONN_HASH_SIZE 1024
+#endif /* UIP_CONF_CONN_HASH_SIZE */
+
 /**
  * The name of the function that should be called when UDP datagrams arrive.
  *
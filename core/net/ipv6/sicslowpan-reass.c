@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2008, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup sicslowpan
+ * @{
+ */
+
+/**
+ * \file
+ *         In-place reassembly of 6lowpan fragments
+ */
+
+#include "net/ipv6/sicslowpan-reass.h"
+#include "net/ipv6/sicslowpan.h"
+#include "lib/list.h"
+#include "lib/memb.h"
+#include "sys/ctimer.h"
+
+#include <string.h>
+
+#define DEBUG DEBUG_NONE
+#include "net/ip/uip-debug.h"
+
+#if SICSLOWPAN_CONF_FRAG && SICSLOWPAN_REASS_IN_PLACE
+
+#define REASS_MAXAGE (SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16)
+
+/* A received fragment */
+struct reass_frag {
+  struct reass_frag *next;
+  uint16_t offset;
+  uint16_t len;
+};
+
+struct reass_context {
+  /* First, so that the IPv6 header in it is as aligned as the struct */
+  uint8_t buf[SICSLOWPAN_REASS_BUF_SIZE];
+  /* Received fragments, sorted on offset */
+  LIST_STRUCT(frags);
+  linkaddr_t sender;
+  uint16_t tag;
+  /* Datagram size, 0 if the context is free */
+  uint16_t size;
+  /* Bytes received so far. As fragments never overlap, the datagram
+     is complete when this reaches size. */
+  uint16_t received;
+  clock_time_t start;
+};
+
+static struct reass_context contexts[SICSLOWPAN_REASS_CONTEXTS];
+
+/* One descriptor per fragment buffer of the copying reassembly, plus
+   one for the first fragment of each context */
+MEMB(frag_memb, struct reass_frag,
+     SICSLOWPAN_FRAGMENT_BUFFERS + SICSLOWPAN_REASS_CONTEXTS);
+
+static struct ctimer expire_timer;
+static void expire_callback(void *ptr);
+
+/*---------------------------------------------------------------------------*/
+static void
+context_clear(struct reass_context *c)
+{
+  struct reass_frag *f;
+
+  while((f = list_pop(c->frags)) != NULL) {
+    memb_free(&frag_memb, f);
+  }
+  c->size = 0;
+  c->received = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Free the expired contexts but not_context, and set the timer for
+   the next one to expire */
+static int
+expire_contexts(int not_context)
+{
+  struct reass_context *c;
+  clock_time_t now;
+  clock_time_t age;
+  clock_time_t next;
+  int count;
+  int i;
+
+  now = clock_time();
+  next = REASS_MAXAGE;
+  count = 0;
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    c = &contexts[i];
+    if(c->size == 0) {
+      continue;
+    }
+    age = now - c->start;
+    if(age < REASS_MAXAGE) {
+      if(REASS_MAXAGE - age < next) {
+        next = REASS_MAXAGE - age;
+      }
+    } else if(i != not_context) {
+      PRINTF("sicslowpan reass: tag %u timed out\n", c->tag);
+      context_clear(c);
+      count++;
+    } else {
+      /* Spared by the caller, look again soon */
+      next = 1;
+    }
+  }
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    if(contexts[i].size != 0) {
+      ctimer_set(&expire_timer, next, expire_callback, NULL);
+      return count;
+    }
+  }
+  ctimer_stop(&expire_timer);
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+expire_callback(void *ptr)
+{
+  expire_contexts(-1);
+}
+/*---------------------------------------------------------------------------*/
+void
+sicslowpan_reass_init(void)
+{
+  int i;
+
+  memb_init(&frag_memb);
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    LIST_STRUCT_INIT(&contexts[i], frags);
+    contexts[i].size = 0;
+    contexts[i].received = 0;
+  }
+  ctimer_stop(&expire_timer);
+}
+/*---------------------------------------------------------------------------*/
+int
+sicslowpan_reass_find(const linkaddr_t *sender, uint16_t tag, uint16_t size)
+{
+  struct reass_context *c;
+  int found;
+  int i;
+
+  if(size == 0 || size > SICSLOWPAN_REASS_BUF_SIZE) {
+    PRINTF("sicslowpan reass: datagram size %u not supported\n", size);
+    return -1;
+  }
+
+  found = -1;
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    c = &contexts[i];
+    if(c->size == 0) {
+      if(found < 0) {
+        found = i;
+      }
+    } else if(c->tag == tag && linkaddr_cmp(&c->sender, sender)) {
+      if(c->size == size) {
+        return i;
+      }
+      /* The tag has been reused for another datagram */
+      context_clear(c);
+      found = i;
+      break;
+    }
+  }
+
+  if(found < 0 && expire_contexts(-1) > 0) {
+    for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+      if(contexts[i].size == 0) {
+        found = i;
+        break;
+      }
+    }
+  }
+  if(found < 0) {
+    PRINTF("sicslowpan reass: no free context for tag %u\n", tag);
+    return -1;
+  }
+
+  c = &contexts[found];
+  linkaddr_copy(&c->sender, sender);
+  c->tag = tag;
+  c->size = size;
+  c->received = 0;
+  c->start = clock_time();
+  if(ctimer_expired(&expire_timer)) {
+    /* Otherwise, the timer is set for an older context and will be
+       set again when that one is gone */
+    ctimer_set(&expire_timer, REASS_MAXAGE, expire_callback, NULL);
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+int
+sicslowpan_reass_add(int context, uint16_t offset,
+                     const uint8_t *data, uint16_t len)
+{
+  struct reass_context *c;
+  struct reass_frag *f;
+  struct reass_frag *prev;
+
+  c = &contexts[context];
+  if(offset >= c->size) {
+    PRINTF("sicslowpan reass: offset %u beyond datagram size %u\n",
+           offset, c->size);
+    return SICSLOWPAN_REASS_ERR;
+  }
+  if(len > c->size - offset) {
+    /* The last fragment may carry extraneous bytes at the end */
+    len = c->size - offset;
+  }
+  if(len == 0) {
+    return SICSLOWPAN_REASS_ERR;
+  }
+
+  /* Find the first fragment that ends after this one starts */
+  prev = NULL;
+  for(f = list_head(c->frags);
+      f != NULL && f->offset + f->len <= offset;
+      f = list_item_next(f)) {
+    prev = f;
+  }
+  if(f != NULL && f->offset < offset + len) {
+    if(f->offset == offset && f->len == len) {
+      return SICSLOWPAN_REASS_DUPLICATE;
+    }
+    PRINTF("sicslowpan reass: fragment %u+%u overlaps %u+%u, tag %u discarded\n",
+           offset, len, f->offset, f->len, c->tag);
+    context_clear(c);
+    return SICSLOWPAN_REASS_DISCARDED;
+  }
+
+  f = memb_alloc(&frag_memb);
+  if(f == NULL && expire_contexts(context) > 0) {
+    f = memb_alloc(&frag_memb);
+  }
+  if(f == NULL) {
+    PRINTF("sicslowpan reass: out of fragment descriptors, tag %u\n", c->tag);
+    return SICSLOWPAN_REASS_ERR;
+  }
+  f->offset = offset;
+  f->len = len;
+  list_insert(c->frags, prev, f);
+
+  if(data != NULL) {
+    memcpy(c->buf + offset, data, len);
+  }
+  c->received += len;
+  return c->received == c->size ?
+    SICSLOWPAN_REASS_COMPLETE : SICSLOWPAN_REASS_INCOMPLETE;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t *
+sicslowpan_reass_buf(int context)
+{
+  return contexts[context].buf;
+}
+/*---------------------------------------------------------------------------*/
+void
+sicslowpan_reass_free(int context)
+{
+  context_clear(&contexts[context]);
+}
+/*---------------------------------------------------------------------------*/
+#endif /* SICSLOWPAN_CONF_FRAG && SICSLOWPAN_REASS_IN_PLACE */
+/** @} */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2008, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \addtogroup sicslowpan
+ * @{
+ */
+
+/**
+ * \file
+ *         In-place reassembly of 6lowpan fragments
+ *
+ *         Every reassembly context owns a buffer large enough for a
+ *         whole IPv6 packet, and fragments are written straight to
+ *         their final offset in it. A list of (offset, length)
+ *         descriptors per context, sorted on offset, tells which parts
+ *         have been received. Fragments may arrive in any order. A
+ *         fragment with the same offset and length as one already
+ *         received is a duplicate and is ignored; any other overlap
+ *         discards the datagram (RFC 4944, Section 5.3). Contexts that
+ *         are not completed within SICSLOWPAN_REASS_MAXAGE are freed
+ *         by a single ctimer.
+ *
+ *         This saves the per-fragment buffers, not a copy: FRAGN
+ *         payloads are still copied from the packetbuf into the
+ *         context buffer, and the completed datagram is then copied
+ *         into uip_buf, as uIP only works on uip_buf.
+ *
+ *         Enabled with SICSLOWPAN_CONF_REASS_IN_PLACE.
+ */
+
+#ifndef SICSLOWPAN_REASS_H_
+#define SICSLOWPAN_REASS_H_
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/linkaddr.h"
+
+#ifdef SICSLOWPAN_CONF_REASS_IN_PLACE
+#define SICSLOWPAN_REASS_IN_PLACE SICSLOWPAN_CONF_REASS_IN_PLACE
+#else
+#define SICSLOWPAN_REASS_IN_PLACE 0
+#endif
+
+/* This needs to be defined in NBR / Nodes depending on available RAM   */
+/*   and expected reassembly requirements                               */
+#ifdef SICSLOWPAN_CONF_FRAGMENT_BUFFERS
+#define SICSLOWPAN_FRAGMENT_BUFFERS SICSLOWPAN_CONF_FRAGMENT_BUFFERS
+#else
+#define SICSLOWPAN_FRAGMENT_BUFFERS 12
+#endif
+
+/* REASS_CONTEXTS corresponds to the number of simultaneous
+ * reassemblies that can be made. NOTE: the first buffer for each
+ * reassembly is stored in the context since it can be larger than the
+ * rest of the fragments due to header compression.
+ **/
+#ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
+#define SICSLOWPAN_REASS_CONTEXTS SICSLOWPAN_CONF_REASS_CONTEXTS
+#else
+#define SICSLOWPAN_REASS_CONTEXTS 2
+#endif
+
+/** Size of the reassembly buffer of each context */
+#define SICSLOWPAN_REASS_BUF_SIZE (UIP_BUFSIZE - UIP_LLH_LEN)
+
+/** \name Return values of sicslowpan_reass_add()
+ * @{ */
+/** The fragment was not stored, but the context is kept, so that the
+    datagram can still complete if the fragment is sent again */
+#define SICSLOWPAN_REASS_ERR        -1
+/** The fragment was stored, more are needed */
+#define SICSLOWPAN_REASS_INCOMPLETE  0
+/** The fragment was stored and completed the datagram */
+#define SICSLOWPAN_REASS_COMPLETE    1
+/** The fragment had already been received */
+#define SICSLOWPAN_REASS_DUPLICATE   2
+/** The fragment overlapped another one, the context was freed */
+#define SICSLOWPAN_REASS_DISCARDED   3
+/** @} */
+
+void sicslowpan_reass_init(void);
+
+/**
+ * \brief Find the reassembly context of a datagram, or allocate one
+ * \param sender The link-layer source of the fragment
+ * \param tag The datagram tag of the fragment
+ * \param size The datagram size of the fragment
+ * \return The context index, or -1 if none is available
+ *
+ * Any fragment of a datagram, not only the first one, can open its
+ * context.
+ */
+int sicslowpan_reass_find(const linkaddr_t *sender, uint16_t tag,
+                          uint16_t size);
+
+/**
+ * \brief Record a fragment in a context
+ * \param context The context index
+ * \param offset The byte offset of the fragment in the datagram
+ * \param data The fragment payload, or NULL if it has already been
+ *        written at its offset in sicslowpan_reass_buf()
+ * \param len The length of the fragment
+ * \return One of the SICSLOWPAN_REASS_ result codes
+ *
+ * Bytes past the end of the datagram are dropped.
+ */
+int sicslowpan_reass_add(int context, uint16_t offset,
+                         const uint8_t *data, uint16_t len);
+
+/** \brief The reassembly buffer of a context */
+uint8_t *sicslowpan_reass_buf(int context);
+
+/** \brief Free a context, e.g. once its datagram has been delivered */
+void sicslowpan_reass_free(int context);
+
+#endif /* SICSLOWPAN_REASS_H_ */
+/** @} */
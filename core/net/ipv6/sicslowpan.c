@@ -68,6 +68,7 @@
 #include "net/ipv6/uip-ds6.h"
 #include "net/rime/rime.h"
 #include "net/ipv6/sicslowpan.h"
+#include "net/ipv6/sicslowpan-reass.h"
 #include "net/netstack.h"
 
 #include <stdio.h>
@@ -222,25 +223,6 @@ static uint16_t my_tag;
 
 /** The total length of the IPv6 packet in the sicslowpan_buf. */
 
-/* This needs to be defined in NBR / Nodes depending on available RAM   */
-/*   and expected reassembly requirements                               */
-#ifdef SICSLOWPAN_CONF_FRAGMENT_BUFFERS
-#define SICSLOWPAN_FRAGMENT_BUFFERS SICSLOWPAN_CONF_FRAGMENT_BUFFERS
-#else
-#define SICSLOWPAN_FRAGMENT_BUFFERS 12
-#endif
-
-/* REASS_CONTEXTS corresponds to the number of simultaneous
- * reassemblies that can be made. NOTE: the first buffer for each
- * reassembly is stored in the context since it can be larger than the
- * rest of the fragments due to header compression.
- **/
-#ifdef SICSLOWPAN_CONF_REASS_CONTEXTS
-#define SICSLOWPAN_REASS_CONTEXTS SICSLOWPAN_CONF_REASS_CONTEXTS
-#else
-#define SICSLOWPAN_REASS_CONTEXTS 2
-#endif
-
 /* The size of each fragment (IP payload) for the 6lowpan fragmentation */
 #ifdef SICSLOWPAN_CONF_FRAGMENT_SIZE
 #define SICSLOWPAN_FRAGMENT_SIZE SICSLOWPAN_CONF_FRAGMENT_SIZE
@@ -251,6 +233,7 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+#if !SICSLOWPAN_REASS_IN_PLACE
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
@@ -433,6 +416,7 @@ copy_frags2uip(int context)
   /* deallocate all the fragments for this context */
   clear_fragments(context);
 }
+#endif /* !SICSLOWPAN_REASS_IN_PLACE */
 #endif /* SICSLOWPAN_CONF_FRAG */
 
 /* -------------------------------------------------------------------------- */
@@ -1497,7 +1481,8 @@ output(const uip_lladdr_t *localdest)
  *  to uip_buf and the IP layer is called.
  *
  * \note We do not check for overlapping sicslowpan fragments
- * (it is a SHALL in the RFC 4944 and should never happen)
+ * (it is a SHALL in the RFC 4944 and should never happen), unless
+ * SICSLOWPAN_CONF_REASS_IN_PLACE is set
  */
 static void
 input(void)
@@ -1559,6 +1544,17 @@ input(void)
       first_fragment = 1;
       is_fragment = 1;
 
+#if SICSLOWPAN_REASS_IN_PLACE
+      /* Uncompress straight into the reassembly buffer */
+      frag_context = sicslowpan_reass_find(packetbuf_addr(PACKETBUF_ADDR_SENDER),
+                                           frag_tag, frag_size);
+
+      if(frag_context == -1) {
+        return;
+      }
+
+      buffer = sicslowpan_reass_buf(frag_context);
+#else /* SICSLOWPAN_REASS_IN_PLACE */
       /* Add the fragment to the fragmentation context */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
@@ -1567,6 +1563,7 @@ input(void)
       }
 
       buffer = frag_info[frag_context].first_frag;
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
 
       break;
     case SICSLOWPAN_DISPATCH_FRAGN:
@@ -1587,6 +1584,47 @@ input(void)
       PRINTFI("last_fragment?: packetbuf_payload_len %d frag_size %d\n",
               packetbuf_datalen() - packetbuf_hdr_len, frag_size);
 
+#if SICSLOWPAN_REASS_IN_PLACE
+      if(packetbuf_datalen() < packetbuf_hdr_len) {
+        return;
+      }
+
+      /* sicslowpan_reass_find() checks frag_size */
+      frag_context = sicslowpan_reass_find(packetbuf_addr(PACKETBUF_ADDR_SENDER),
+                                           frag_tag, frag_size);
+
+      if(frag_context == -1) {
+        return;
+      }
+      is_fragment = 1;
+
+      /* Check the fragment before adding it to its datagram, as below
+         for unfragmented packets and first fragments */
+      if(UIP_LLH_LEN + (uint16_t)(frag_offset << 3)
+         + packetbuf_datalen() - packetbuf_hdr_len > sizeof(uip_buf)) {
+        PRINTF("SICSLOWPAN: fragment dropped, offset %u + length %u too large\n",
+               (uint16_t)(frag_offset << 3),
+               packetbuf_datalen() - packetbuf_hdr_len);
+        goto drop;
+      }
+
+      /* Copy the payload to its final place in the reassembly buffer */
+      switch(sicslowpan_reass_add(frag_context, (uint16_t)(frag_offset << 3),
+                                  packetbuf_ptr + packetbuf_hdr_len,
+                                  packetbuf_datalen() - packetbuf_hdr_len)) {
+      case SICSLOWPAN_REASS_COMPLETE:
+        last_fragment = 1;
+        break;
+      case SICSLOWPAN_REASS_ERR:
+        /* Only this fragment is lost, e.g. for lack of descriptors: keep
+           the datagram, a retransmission may still complete it */
+        return;
+      default:
+        break;
+      }
+
+      buffer = NULL;
+#else /* SICSLOWPAN_REASS_IN_PLACE */
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
@@ -1602,6 +1640,7 @@ input(void)
       if(frag_info[frag_context].reassembled_len >= frag_size) {
         last_fragment = 1;
       }
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
       is_fragment = 1;
       break;
     default:
@@ -1637,7 +1676,7 @@ input(void)
       /* unknown header */
       PRINTFI("sicslowpan input: unknown dispatch: %u\n",
              PACKETBUF_HC1_PTR[PACKETBUF_HC1_DISPATCH]);
-      return;
+      goto drop;
   }
 
 
@@ -1653,7 +1692,7 @@ input(void)
    */
   if(packetbuf_datalen() < packetbuf_hdr_len) {
     PRINTF("SICSLOWPAN: packet dropped due to header > total packet\n");
-    return;
+    goto drop;
   }
   packetbuf_payload_len = packetbuf_datalen() - packetbuf_hdr_len;
 
@@ -1666,7 +1705,7 @@ input(void)
           "SICSLOWPAN: packet dropped, minimum required IP_BUF size: %d+%d+%d+%d=%d (current size: %u)\n",
           UIP_LLH_LEN, uncomp_hdr_len, (uint16_t)(frag_offset << 3),
           packetbuf_payload_len, req_size, (unsigned)sizeof(uip_buf));
-      return;
+      goto drop;
     }
   }
 
@@ -1680,6 +1719,22 @@ input(void)
 
 #if SICSLOWPAN_CONF_FRAG
   if(frag_size > 0) {
+#if SICSLOWPAN_REASS_IN_PLACE
+    /* The first fragment is already in place, and may be the last
+       one to arrive */
+    if(first_fragment != 0 &&
+       sicslowpan_reass_add(frag_context, 0, NULL,
+                            uncomp_hdr_len + packetbuf_payload_len)
+       == SICSLOWPAN_REASS_COMPLETE) {
+      last_fragment = 1;
+    }
+    if(last_fragment != 0) {
+      /* uIP only works on uip_buf */
+      memcpy((uint8_t *)UIP_IP_BUF, sicslowpan_reass_buf(frag_context),
+             frag_size);
+      sicslowpan_reass_free(frag_context);
+    }
+#else /* SICSLOWPAN_REASS_IN_PLACE */
     /* Add the size of the header only for the first fragment. */
     if(first_fragment != 0) {
       frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
@@ -1692,6 +1747,7 @@ input(void)
       /* copy to uip */
       copy_frags2uip(frag_context);
     }
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
   }
 
   /*
@@ -1734,6 +1790,20 @@ input(void)
 #if SICSLOWPAN_CONF_FRAG
   }
 #endif /* SICSLOWPAN_CONF_FRAG */
+  return;
+
+ drop:
+#if SICSLOWPAN_CONF_FRAG
+  /* The datagram of a dropped fragment cannot complete any more */
+  if(is_fragment) {
+#if SICSLOWPAN_REASS_IN_PLACE
+    sicslowpan_reass_free(frag_context);
+#else /* SICSLOWPAN_REASS_IN_PLACE */
+    clear_fragments(frag_context);
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
+  }
+#endif /* SICSLOWPAN_CONF_FRAG */
+  return;
 }
 /** @} */
 
@@ -1750,6 +1820,10 @@ sicslowpan_init(void)
 
   tcpip_set_outputfunc(output);
 
+#if SICSLOWPAN_CONF_FRAG && SICSLOWPAN_REASS_IN_PLACE
+  sicslowpan_reass_init();
+#endif /* SICSLOWPAN_CONF_FRAG && SICSLOWPAN_REASS_IN_PLACE */
+
 #if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_HC06
 /* Preinitialize any address contexts for better header compression
  * (Saves up to 13 bytes per 6lowpan packet)
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * \addtogroup uip6
+ * @{
+ */
+
+/**
+ * \file
+ *    Lookup index for the routing table
+ */
+#include "net/ipv6/uip-ds6-route-index.h"
+#include "lib/memb.h"
+
+#include <string.h>
+
+#if UIP_DS6_ROUTE_INDEX && (UIP_CONF_MAX_ROUTES != 0)
+
+/* A trie node. Nodes without a route are branching points and always
+   have two children, so the trie never holds more than
+   2 * UIP_DS6_ROUTE_INDEX_PREFIXES - 1 nodes. */
+struct trie_node {
+  struct trie_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t length;
+};
+
+MEMB(trienodememb, struct trie_node, 2 * UIP_DS6_ROUTE_INDEX_PREFIXES);
+
+static struct trie_node *trie_root;
+static uip_ds6_route_t *host_routes[UIP_DS6_ROUTE_INDEX_HASH_SIZE];
+
+/* Routes that could not be inserted into the trie. As long as there
+   is one, lookups have to fall back to the list walk. */
+static int num_unindexed;
+
+/*---------------------------------------------------------------------------*/
+static unsigned
+host_hash(const uip_ipaddr_t *addr)
+{
+  unsigned h;
+  int i;
+
+  /* All routes in a DODAG share the prefix, so only the interface
+     identifier is hashed */
+  h = 0;
+  for(i = 8; i < 16; i++) {
+    h = (h << 5) - h + addr->u8[i];
+  }
+  return h & (UIP_DS6_ROUTE_INDEX_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static int
+addr_bit(const uip_ipaddr_t *addr, uint8_t pos)
+{
+  return (addr->u8[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Number of leading bits, up to max, that a and b have in common */
+static uint8_t
+common_length(const uip_ipaddr_t *a, const uip_ipaddr_t *b, uint8_t max)
+{
+  uint8_t len;
+  uint8_t diff;
+
+  for(len = 0; len < max; len += 8) {
+    diff = a->u8[len >> 3] ^ b->u8[len >> 3];
+    if(diff != 0) {
+      while((diff & 0x80) == 0) {
+        diff <<= 1;
+        len++;
+      }
+      break;
+    }
+  }
+  return len < max ? len : max;
+}
+/*---------------------------------------------------------------------------*/
+static struct trie_node *
+trie_node_new(const uip_ipaddr_t *prefix, uint8_t length,
+              uip_ds6_route_t *route)
+{
+  struct trie_node *n;
+
+  n = memb_alloc(&trienodememb);
+  if(n != NULL) {
+    n->child[0] = n->child[1] = NULL;
+    n->route = route;
+    uip_ipaddr_copy(&n->prefix, prefix);
+    n->length = length;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trie_insert(uip_ds6_route_t *route)
+{
+  struct trie_node **link;
+  struct trie_node *n;
+  struct trie_node *leaf;
+  struct trie_node *branch;
+  uint8_t length;
+  uint8_t common;
+
+  length = route->length;
+  link = &trie_root;
+  while(*link != NULL) {
+    n = *link;
+    common = common_length(&route->ipaddr, &n->prefix,
+                           length < n->length ? length : n->length);
+    if(common == n->length) {
+      if(length == n->length) {
+        /* A branching point for this very prefix already exists */
+        if(n->route != NULL) {
+          return 0;
+        }
+        n->route = route;
+        return 1;
+      }
+      link = &n->child[addr_bit(&route->ipaddr, n->length)];
+      continue;
+    }
+
+    leaf = trie_node_new(&route->ipaddr, length, route);
+    if(leaf == NULL) {
+      return 0;
+    }
+    if(common == length) {
+      /* The new prefix covers n: insert it above n */
+      leaf->child[addr_bit(&n->prefix, length)] = n;
+      *link = leaf;
+      return 1;
+    }
+    /* The prefixes diverge: split with a new branching point */
+    branch = trie_node_new(&route->ipaddr, common, NULL);
+    if(branch == NULL) {
+      memb_free(&trienodememb, leaf);
+      return 0;
+    }
+    branch->child[addr_bit(&route->ipaddr, common)] = leaf;
+    branch->child[addr_bit(&n->prefix, common)] = n;
+    *link = branch;
+    return 1;
+  }
+
+  *link = trie_node_new(&route->ipaddr, length, route);
+  return *link != NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trie_remove(uip_ds6_route_t *route)
+{
+  struct trie_node **link;
+  struct trie_node **parent_link;
+  struct trie_node *n;
+  struct trie_node *parent;
+
+  parent_link = NULL;
+  link = &trie_root;
+  while(*link != NULL && (*link)->length < route->length) {
+    parent_link = link;
+    link = &(*link)->child[addr_bit(&route->ipaddr, (*link)->length)];
+  }
+  n = *link;
+  if(n == NULL || n->route != route) {
+    return 0;
+  }
+
+  n->route = NULL;
+  if(n->child[0] != NULL && n->child[1] != NULL) {
+    /* Still needed as a branching point */
+    return 1;
+  }
+  *link = n->child[0] != NULL ? n->child[0] : n->child[1];
+  memb_free(&trienodememb, n);
+
+  /* Collapse a branching point left with a single child */
+  if(parent_link != NULL) {
+    parent = *parent_link;
+    if(parent->route == NULL &&
+       (parent->child[0] == NULL || parent->child[1] == NULL)) {
+      *parent_link = parent->child[0] != NULL ?
+        parent->child[0] : parent->child[1];
+      memb_free(&trienodememb, parent);
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_ds6_route_index_init(void)
+{
+  memb_init(&trienodememb);
+  trie_root = NULL;
+  memset(host_routes, 0, sizeof(host_routes));
+  num_unindexed = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_ds6_route_index_add(uip_ds6_route_t *route)
+{
+  unsigned h;
+
+  if(route->length == 128) {
+    h = host_hash(&route->ipaddr);
+    route->index_next = host_routes[h];
+    host_routes[h] = route;
+  } else if(!trie_insert(route)) {
+    num_unindexed++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_ds6_route_index_rm(uip_ds6_route_t *route)
+{
+  uip_ds6_route_t **r;
+
+  if(route->length == 128) {
+    for(r = &host_routes[host_hash(&route->ipaddr)];
+        *r != NULL;
+        r = &(*r)->index_next) {
+      if(*r == route) {
+        *r = route->index_next;
+        break;
+      }
+    }
+  } else if(!trie_remove(route)) {
+    num_unindexed--;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uip_ds6_route_t *
+uip_ds6_route_index_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  struct trie_node *n;
+
+  for(r = host_routes[host_hash(addr)]; r != NULL; r = r->index_next) {
+    if(uip_ipaddr_cmp(&r->ipaddr, addr)) {
+      return r;
+    }
+  }
+
+  r = NULL;
+  n = trie_root;
+  while(n != NULL &&
+        common_length(addr, &n->prefix, n->length) == n->length) {
+    if(n->route != NULL) {
+      r = n->route;
+    }
+    if(n->length >= 128) {
+      break;
+    }
+    n = n->child[addr_bit(addr, n->length)];
+  }
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_ds6_route_index_complete(void)
+{
+  return num_unindexed == 0;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* UIP_DS6_ROUTE_INDEX && (UIP_CONF_MAX_ROUTES != 0) */
+/** @} */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * \addtogroup uip6
+ * @{
+ */
+/**
+ * \file
+ *    Lookup index for the routing table
+ *
+ *    Host routes (/128, as installed by RPL DAOs) are kept in a hash
+ *    table keyed on the interface identifier. Shorter prefixes are
+ *    kept in a path-compressed binary trie, so that a longest-prefix
+ *    match costs one hash probe plus at most one trie descent instead
+ *    of a walk over the whole routing table.
+ *
+ *    Enabled with UIP_DS6_ROUTE_CONF_INDEX. The routing table list
+ *    in uip-ds6-route.c stays the authoritative store; the index only
+ *    references its entries.
+ */
+#ifndef UIP_DS6_ROUTE_INDEX_H
+#define UIP_DS6_ROUTE_INDEX_H
+
+#include "net/ipv6/uip-ds6-route.h"
+
+/** \brief Number of host-route hash buckets, must be a power of two */
+#ifdef UIP_DS6_ROUTE_INDEX_CONF_HASH_SIZE
+#define UIP_DS6_ROUTE_INDEX_HASH_SIZE UIP_DS6_ROUTE_INDEX_CONF_HASH_SIZE
+#elif UIP_DS6_ROUTE_NB <= 16
+#define UIP_DS6_ROUTE_INDEX_HASH_SIZE 16
+#elif UIP_DS6_ROUTE_NB <= 64
+#define UIP_DS6_ROUTE_INDEX_HASH_SIZE 64
+#elif UIP_DS6_ROUTE_NB <= 256
+#define UIP_DS6_ROUTE_INDEX_HASH_SIZE 256
+#else
+#define UIP_DS6_ROUTE_INDEX_HASH_SIZE 1024
+#endif
+
+/** \brief Number of non-host prefixes the trie can hold. Prefixes
+ *  that do not fit are still routed, through the list walk. */
+#ifdef UIP_DS6_ROUTE_INDEX_CONF_PREFIXES
+#define UIP_DS6_ROUTE_INDEX_PREFIXES UIP_DS6_ROUTE_INDEX_CONF_PREFIXES
+#else
+#define UIP_DS6_ROUTE_INDEX_PREFIXES 4
+#endif
+
+void uip_ds6_route_index_init(void);
+void uip_ds6_route_index_add(uip_ds6_route_t *route);
+void uip_ds6_route_index_rm(uip_ds6_route_t *route);
+
+/**
+ * \brief Longest-prefix match through the index
+ * \param addr The destination address
+ * \return The matching route, or NULL if none
+ *
+ * Only valid while uip_ds6_route_index_complete() returns true.
+ */
+uip_ds6_route_t *uip_ds6_route_index_lookup(const uip_ipaddr_t *addr);
+
+/**
+ * \brief Tell if every route in the routing table is in the index
+ * \return Non-zero if uip_ds6_route_index_lookup() can be used
+ */
+int uip_ds6_route_index_complete(void);
+
+#endif /* UIP_DS6_ROUTE_INDEX_H */
+/** @} */
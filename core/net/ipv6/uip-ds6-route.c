@@ -39,6 +39,7 @@
  *    Routing table manipulation
  */
 #include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route-index.h"
 #include "net/ip/uip.h"
 
 #include "lib/list.h"
@@ -162,6 +163,9 @@ uip_ds6_route_init(void)
 #if (UIP_CONF_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_INDEX
+  uip_ds6_route_index_init();
+#endif /* UIP_DS6_ROUTE_INDEX */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_CONF_MAX_ROUTES != 0) */
@@ -264,17 +268,24 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
 
 
   found_route = NULL;
-  longestmatch = 0;
-  for(r = uip_ds6_route_head();
-      r != NULL;
-      r = uip_ds6_route_next(r)) {
-    if(r->length >= longestmatch &&
-       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
-      longestmatch = r->length;
-      found_route = r;
-      /* check if total match - e.g. all 128 bits do match */
-      if(longestmatch == 128) {
-	break;
+#if UIP_DS6_ROUTE_INDEX
+  if(uip_ds6_route_index_complete()) {
+    found_route = uip_ds6_route_index_lookup(addr);
+  } else
+#endif /* UIP_DS6_ROUTE_INDEX */
+  {
+    longestmatch = 0;
+    for(r = uip_ds6_route_head();
+        r != NULL;
+        r = uip_ds6_route_next(r)) {
+      if(r->length >= longestmatch &&
+         uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+        longestmatch = r->length;
+        found_route = r;
+        /* check if total match - e.g. all 128 bits do match */
+        if(longestmatch == 128) {
+          break;
+        }
       }
     }
   }
@@ -289,6 +300,10 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     PRINTF("uip-ds6-route: No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the index, the list order only matters for picking the least
+     recently used route to evict, so the (linear) reordering is skipped
+     when eviction is disabled. */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -298,6 +313,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_INDEX || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_CONF_MAX_ROUTES != 0) */
@@ -436,14 +452,19 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_INDEX
+  uip_ds6_route_index_add(r);
+#endif /* UIP_DS6_ROUTE_INDEX */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
 
+#if UIP_DS6_ROUTE_LOG_ADD
   printf("uip_ds6_route_add: adding route: ");
   printf("%u ",ipaddr->u8[15]);
   printf("via %u\n",nexthop->u8[15]);
+#endif /* UIP_DS6_ROUTE_LOG_ADD */
 
   PRINTF("uip_ds6_route_add: adding route: ");
   PRINT6ADDR(ipaddr);
@@ -486,6 +507,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_INDEX
+    uip_ds6_route_index_rm(route);
+#endif /* UIP_DS6_ROUTE_INDEX */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
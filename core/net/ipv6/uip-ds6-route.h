@@ -88,6 +88,23 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_CONF_MAX_ROUTES */
 
+/** \brief Enable the route lookup index (host-route hash table plus
+ *  prefix trie, see uip-ds6-route-index.h). When disabled, lookups
+ *  walk the routing table list. */
+#ifdef UIP_DS6_ROUTE_CONF_INDEX
+#define UIP_DS6_ROUTE_INDEX UIP_DS6_ROUTE_CONF_INDEX
+#else /* UIP_DS6_ROUTE_CONF_INDEX */
+#define UIP_DS6_ROUTE_INDEX 0
+#endif /* UIP_DS6_ROUTE_CONF_INDEX */
+
+/** \brief Print every route added to the routing table, independently
+ *  of DEBUG. On by default, for the logs of the experiments. */
+#ifdef UIP_DS6_ROUTE_CONF_LOG_ADD
+#define UIP_DS6_ROUTE_LOG_ADD UIP_DS6_ROUTE_CONF_LOG_ADD
+#else /* UIP_DS6_ROUTE_CONF_LOG_ADD */
+#define UIP_DS6_ROUTE_LOG_ADD 1
+#endif /* UIP_DS6_ROUTE_CONF_LOG_ADD */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -157,6 +174,10 @@ typedef struct uip_ds6_route {
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   UIP_DS6_ROUTE_STATE_TYPE state;
 #endif
+#if UIP_DS6_ROUTE_INDEX
+  /* Next route in the same host-route hash bucket */
+  struct uip_ds6_route *index_next;
+#endif /* UIP_DS6_ROUTE_INDEX */
   uint8_t length;
 } uip_ds6_route_t;
 
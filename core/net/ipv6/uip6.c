@@ -74,6 +74,7 @@
 #include "sys/cc.h"
 #include "net/ip/uip.h"
 #include "net/ip/uip_arch.h"
+#include "net/ip/uip-chksum.h"
 #include "net/ip/uipopt.h"
 #include "net/ipv6/uip-icmp6.h"
 #include "net/ipv6/uip-nd6.h"
@@ -273,6 +274,166 @@ struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
 #endif /* UIP_UDP */
 /** @} */
 
+#if UIP_CONN_HASH
+/*---------------------------------------------------------------------------*/
+/**
+ * \name Connection hash tables
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+/* Range of ephemeral ports: lastport counts up from 1024, and wraps
+   around from 32000 to 4096 */
+#define EPHEMERAL_PORT_MIN  1024
+#define EPHEMERAL_PORT_WRAP 4096
+#define EPHEMERAL_PORT_MAX  32000
+
+#if UIP_UDP
+/* UDP connections are hashed on their local port only: the remote
+   port and address may be wildcards, and applications change them in
+   place. Chains are kept in array order, so that the first match is
+   the same as with the array walk. */
+static struct uip_udp_conn *udp_hash[UIP_CONN_HASH_SIZE];
+static struct uip_udp_conn *udp_next[UIP_UDP_CONNS];
+/* Local ports in the ephemeral range used by UDP connections */
+static uint32_t udp_ports[(EPHEMERAL_PORT_MAX - EPHEMERAL_PORT_MIN) / 32];
+#endif /* UIP_UDP */
+
+#if UIP_TCP
+/* TCP connections are hashed on local port, remote port and remote
+   address, which are set once for each new connection. Closed
+   connections stay in their chain until their slot is reused. */
+static struct uip_conn *tcp_hash[UIP_CONN_HASH_SIZE];
+static struct uip_conn *tcp_next[UIP_CONNS];
+#endif /* UIP_TCP */
+/*---------------------------------------------------------------------------*/
+static unsigned
+conn_hash(uint16_t lport, uint16_t rport, const uip_ipaddr_t *ripaddr)
+{
+  uint32_t h;
+
+  h = lport | ((uint32_t)rport << 16);
+  if(ripaddr != NULL) {
+    /* Peers usually share a prefix, so only the interface identifier
+       is mixed in */
+    h ^= ripaddr->u16[4] ^ ripaddr->u16[5] ^
+      ((uint32_t)(ripaddr->u16[6] ^ ripaddr->u16[7]) << 16);
+  }
+  h *= 2654435761UL;
+  return (h >> 16) & (UIP_CONN_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_UDP
+static void
+udp_port_mark(uint16_t lport, int used)
+{
+  unsigned bit;
+
+  lport = uip_ntohs(lport);
+  if(lport < EPHEMERAL_PORT_MIN || lport >= EPHEMERAL_PORT_MAX) {
+    return;
+  }
+  bit = lport - EPHEMERAL_PORT_MIN;
+  if(used) {
+    udp_ports[bit >> 5] |= (uint32_t)1 << (bit & 31);
+  } else {
+    udp_ports[bit >> 5] &= ~((uint32_t)1 << (bit & 31));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The first port after port, in host byte order, that no UDP
+   connection uses */
+static uint16_t
+udp_port_next_free(uint16_t port)
+{
+  unsigned bit;
+
+  while(1) {
+    ++port;
+    if(port >= EPHEMERAL_PORT_MAX) {
+      port = EPHEMERAL_PORT_WRAP;
+    }
+    bit = port - EPHEMERAL_PORT_MIN;
+    if(udp_ports[bit >> 5] == 0xffffffff) {
+      /* Skip the rest of a full word */
+      port += 31 - (bit & 31);
+    } else if(!(udp_ports[bit >> 5] & ((uint32_t)1 << (bit & 31)))) {
+      return port;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t lport)
+{
+  struct uip_udp_conn **link;
+  struct uip_udp_conn *c;
+  unsigned h;
+
+  if(conn->lport != 0) {
+    h = conn_hash(conn->lport, 0, NULL);
+    for(link = &udp_hash[h];
+        *link != NULL && *link != conn;
+        link = &udp_next[*link - uip_udp_conns]);
+    if(*link != NULL) {
+      *link = udp_next[conn - uip_udp_conns];
+    }
+    /* The port stays in use if another connection is bound to it */
+    for(c = udp_hash[h];
+        c != NULL && c->lport != conn->lport;
+        c = udp_next[c - uip_udp_conns]);
+    if(c == NULL) {
+      udp_port_mark(conn->lport, 0);
+    }
+  }
+
+  conn->lport = lport;
+
+  if(lport != 0) {
+    for(link = &udp_hash[conn_hash(lport, 0, NULL)];
+        *link != NULL && *link < conn;
+        link = &udp_next[*link - uip_udp_conns]);
+    c = *link;
+    *link = conn;
+    udp_next[conn - uip_udp_conns] = c;
+    udp_port_mark(lport, 1);
+  }
+}
+#endif /* UIP_UDP */
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP
+static void
+tcp_hash_remove(struct uip_conn *conn)
+{
+  struct uip_conn **link;
+
+  if(conn->lport == 0) {
+    return;
+  }
+  for(link = &tcp_hash[conn_hash(conn->lport, conn->rport, &conn->ripaddr)];
+      *link != NULL;
+      link = &tcp_next[*link - uip_conns]) {
+    if(*link == conn) {
+      *link = tcp_next[conn - uip_conns];
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+tcp_hash_add(struct uip_conn *conn)
+{
+  struct uip_conn **link;
+
+  for(link = &tcp_hash[conn_hash(conn->lport, conn->rport, &conn->ripaddr)];
+      *link != NULL && *link < conn;
+      link = &tcp_next[*link - uip_conns]);
+  tcp_next[conn - uip_conns] = *link;
+  *link = conn;
+}
+#endif /* UIP_TCP */
+/** @} */
+#endif /* UIP_CONN_HASH */
+
 /*---------------------------------------------------------------------------*/
 /**
  * \name ICMPv6 variables
@@ -323,41 +484,10 @@ uip_add32(uint8_t *op32, uint16_t op16)
 
 #if ! UIP_ARCH_CHKSUM
 /*---------------------------------------------------------------------------*/
-static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
-{
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {   /* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
-}
-/*---------------------------------------------------------------------------*/
 uint16_t
 uip_chksum(uint16_t *data, uint16_t len)
 {
-  return uip_htons(chksum(0, (uint8_t *)data, len));
+  return uip_htons(uip_chksum_add(0, (uint8_t *)data, len));
 }
 /*---------------------------------------------------------------------------*/
 #ifndef UIP_ARCH_IPCHKSUM
@@ -366,7 +496,7 @@ uip_ipchksum(void)
 {
   uint16_t sum;
 
-  sum = chksum(0, &uip_buf[UIP_LLH_LEN], UIP_IPH_LEN);
+  sum = uip_chksum_add(0, &uip_buf[UIP_LLH_LEN], UIP_IPH_LEN);
   PRINTF("uip_ipchksum: sum 0x%04x\n", sum);
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -396,11 +526,11 @@ upper_layer_chksum(uint8_t proto)
   /* IP protocol and length fields. This addition cannot carry. */
   sum = upper_layer_len + proto;
   /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
+  sum = uip_chksum_add(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
 
   /* Sum TCP header and data. */
-  sum = chksum(sum, &uip_buf[UIP_IPH_LEN + UIP_LLH_LEN + uip_ext_len],
-               upper_layer_len);
+  sum = uip_chksum_add(sum, &uip_buf[UIP_IPH_LEN + UIP_LLH_LEN + uip_ext_len],
+                       upper_layer_len);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -444,7 +574,13 @@ uip_init(void)
   }
   for(c = 0; c < UIP_CONNS; ++c) {
     uip_conns[c].tcpstateflags = UIP_CLOSED;
+#if UIP_CONN_HASH
+    uip_conns[c].lport = 0;
+#endif /* UIP_CONN_HASH */
   }
+#if UIP_CONN_HASH
+  memset(tcp_hash, 0, sizeof(tcp_hash));
+#endif /* UIP_CONN_HASH */
 #endif /* UIP_TCP */
 
 #if UIP_ACTIVE_OPEN || UIP_UDP
@@ -455,6 +591,10 @@ uip_init(void)
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     uip_udp_conns[c].lport = 0;
   }
+#if UIP_CONN_HASH
+  memset(udp_hash, 0, sizeof(udp_hash));
+  memset(udp_ports, 0, sizeof(udp_ports));
+#endif /* UIP_CONN_HASH */
 #endif /* UIP_UDP */
 
 #if UIP_IPV6_MULTICAST
@@ -526,9 +666,15 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
   conn->rto = UIP_RTO;
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
+#if UIP_CONN_HASH
+  tcp_hash_remove(conn);
+#endif /* UIP_CONN_HASH */
   conn->lport = uip_htons(lastport);
   conn->rport = rport;
   uip_ipaddr_copy(&conn->ripaddr, ripaddr);
+#if UIP_CONN_HASH
+  tcp_hash_add(conn);
+#endif /* UIP_CONN_HASH */
 
   return conn;
 }
@@ -566,6 +712,9 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
   register struct uip_udp_conn *conn;
 
   /* Find an unused local port. */
+#if UIP_CONN_HASH
+  lastport = udp_port_next_free(lastport);
+#else /* UIP_CONN_HASH */
   again:
   ++lastport;
 
@@ -578,6 +727,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
       goto again;
     }
   }
+#endif /* UIP_CONN_HASH */
 
   conn = 0;
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
@@ -591,7 +741,11 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     return 0;
   }
 
+#if UIP_CONN_HASH
+  uip_udp_set_lport(conn, UIP_HTONS(lastport));
+#else /* UIP_CONN_HASH */
   conn->lport = UIP_HTONS(lastport);
+#endif /* UIP_CONN_HASH */
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -1515,9 +1669,15 @@ uip_process(uint8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
+#if UIP_CONN_HASH
+  for(uip_udp_conn = udp_hash[conn_hash(UIP_UDP_BUF->destport, 0, NULL)];
+      uip_udp_conn != NULL;
+      uip_udp_conn = udp_next[uip_udp_conn - uip_udp_conns]) {
+#else /* UIP_CONN_HASH */
   for(uip_udp_conn = &uip_udp_conns[0];
       uip_udp_conn < &uip_udp_conns[UIP_UDP_CONNS];
       ++uip_udp_conn) {
+#endif /* UIP_CONN_HASH */
     /* If the local UDP port is non-zero, the connection is considered
        to be used. If so, the local port number is checked against the
        destination port number in the received packet. If the two port
@@ -1618,8 +1778,16 @@ uip_process(uint8_t flag)
 
   /* Demultiplex this segment. */
   /* First check any active connections. */
+#if UIP_CONN_HASH
+  for(uip_connr = tcp_hash[conn_hash(UIP_TCP_BUF->destport,
+                                     UIP_TCP_BUF->srcport,
+                                     &UIP_IP_BUF->srcipaddr)];
+      uip_connr != NULL;
+      uip_connr = tcp_next[uip_connr - uip_conns]) {
+#else /* UIP_CONN_HASH */
   for(uip_connr = &uip_conns[0]; uip_connr <= &uip_conns[UIP_CONNS - 1];
       ++uip_connr) {
+#endif /* UIP_CONN_HASH */
     if(uip_connr->tcpstateflags != UIP_CLOSED &&
        UIP_TCP_BUF->destport == uip_connr->lport &&
        UIP_TCP_BUF->srcport == uip_connr->rport &&
@@ -1739,9 +1907,15 @@ uip_process(uint8_t flag)
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
+#if UIP_CONN_HASH
+  tcp_hash_remove(uip_connr);
+#endif /* UIP_CONN_HASH */
   uip_connr->lport = UIP_TCP_BUF->destport;
   uip_connr->rport = UIP_TCP_BUF->srcport;
   uip_ipaddr_copy(&uip_connr->ripaddr, &UIP_IP_BUF->srcipaddr);
+#if UIP_CONN_HASH
+  tcp_hash_add(uip_connr);
+#endif /* UIP_CONN_HASH */
   uip_connr->tcpstateflags = UIP_SYN_RCVD;
 
   uip_connr->snd_nxt[0] = iss[0];
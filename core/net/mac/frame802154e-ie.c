@@ -369,126 +369,198 @@ frame80215e_create_ie_tsch_channel_hopping_sequence(uint8_t *buf, int len,
   }
 }
 
-/* Parse a header IE */
+/* Parsers for the IEs we support. Each gets the IE content and its length,
+ * and returns the length if the IE is valid, -1 otherwise */
+typedef int (*ie_parse_func)(const uint8_t *buf, int len,
+    struct ieee802154_ies *ies);
+
+/* Header IE. ACK/NACK time correction */
 static int
-frame802154e_parse_header_ie(const uint8_t *buf, int len,
-    uint8_t element_id, struct ieee802154_ies *ies)
+parse_ie_ack_nack_time_correction(const uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
 {
-  switch(element_id) {
-    case HEADER_IE_ACK_NACK_TIME_CORRECTION:
-      if(len == 2) {
-        if(ies != NULL) {
-          /* If the originator was a time source neighbor, the receiver adjust
-           * its own clock by incorporating the received drift correction */
-          uint16_t time_sync_field = 0;
-          int16_t drift_us = 0;
-          /* Extract drift correction from Sync-IE, cast from 12 to 16-bit,
-           * and convert it to RTIMER ticks.
-           * See page 88 in IEEE Std 802.15.4e-2012. */
-          READ16(buf, time_sync_field);
-          /* First extract NACK */
-          ies->ie_is_nack = (time_sync_field & (uint16_t)0x8000) ? 1 : 0;
-          /* Then cast from 12 to 16 bit signed */
-          if(time_sync_field & 0x0800) { /* Negative integer */
-            drift_us = time_sync_field | 0xf000;
-          } else { /* Positive integer */
-            drift_us = time_sync_field & 0x0fff;
-          }
-          /* Convert to RTIMER ticks */
-          ies->ie_time_correction = drift_us;
-        }
-        return len;
+  if(len == 2) {
+    if(ies != NULL) {
+      /* If the originator was a time source neighbor, the receiver adjust
+       * its own clock by incorporating the received drift correction */
+      uint16_t time_sync_field = 0;
+      int16_t drift_us = 0;
+      /* Extract drift correction from Sync-IE, cast from 12 to 16-bit,
+       * and convert it to RTIMER ticks.
+       * See page 88 in IEEE Std 802.15.4e-2012. */
+      READ16(buf, time_sync_field);
+      /* First extract NACK */
+      ies->ie_is_nack = (time_sync_field & (uint16_t)0x8000) ? 1 : 0;
+      /* Then cast from 12 to 16 bit signed */
+      if(time_sync_field & 0x0800) { /* Negative integer */
+        drift_us = time_sync_field | 0xf000;
+      } else { /* Positive integer */
+        drift_us = time_sync_field & 0x0fff;
       }
-      break;
+      /* Convert to RTIMER ticks */
+      ies->ie_time_correction = drift_us;
+    }
+    return len;
+  }
+  return -1;
+}
 
 #if TESLA
-      case HEADER_IE_TSCH_SF_SIZE:
-      if(len == 3) {
-        if(ies != NULL) {
-          READ16(buf, ies->sf_size);
-          ies->sf_size_version = buf[2];
-          //printf("parse: sf_size %u, ver %u\n",ies->sf_size,ies->sf_size_version);
+/* Header IE or MLME sub-IE. Slotframe size */
+static int
+parse_ie_tsch_sf_size(const uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
+{
+  if(len == 3) {
+    if(ies != NULL) {
+      READ16(buf, ies->sf_size);
+      ies->sf_size_version = buf[2];
+    }
+    return len;
+  }
+  return -1;
+}
+#endif
+
+/* MLME sub-IE. TSCH slotframe and link */
+static int
+parse_ie_tsch_slotframe_and_link(const uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
+{
+  int i;
+  int num_slotframes;
+  int num_links;
+
+  if(len >= 1 && buf[0] == 0) {
+    return len;
+  }
+  if(len >= 5) {
+    num_slotframes = buf[0];
+    num_links = buf[4];
+    if(num_slotframes <= 1 && num_links <= FRAME802154E_IE_MAX_LINKS
+        && len == 1 + num_slotframes * (4 + 5 * num_links)) {
+      if(ies != NULL) {
+        /* We support only 0 or 1 slotframe in this IE and a predefined maximum number of links */
+        ies->ie_tsch_slotframe_and_link.num_slotframes = buf[0];
+        ies->ie_tsch_slotframe_and_link.slotframe_handle = buf[1];
+        READ16(buf + 2, ies->ie_tsch_slotframe_and_link.slotframe_size);
+        ies->ie_tsch_slotframe_and_link.num_links = buf[4];
+        for(i = 0; i < num_links; i++) {
+          READ16(buf + 5 + i * 5, ies->ie_tsch_slotframe_and_link.links[i].timeslot);
+          READ16(buf + 5 + i * 5 + 2, ies->ie_tsch_slotframe_and_link.links[i].channel_offset);
+          ies->ie_tsch_slotframe_and_link.links[i].link_options = buf[5 + i * 5 + 4];
         }
-        return len;
       }
-      break;
-#endif 
+      return len;
+    }
   }
   return -1;
 }
 
-/* Parse a MLME short IE */
+/* MLME sub-IE. TSCH synchronization */
 static int
-frame802154e_parse_mlme_short_ie(const uint8_t *buf, int len,
-    uint8_t sub_id, struct ieee802154_ies *ies)
+parse_ie_tsch_synchronization(const uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
 {
-  switch(sub_id) {
-    case MLME_SHORT_IE_TSCH_SLOFTRAME_AND_LINK:
-      if(len >= 1) {
+  if(len == 6) {
+    if(ies != NULL) {
+      ies->ie_asn.ls4b = (uint32_t)buf[0];
+      ies->ie_asn.ls4b |= (uint32_t)buf[1] << 8;
+      ies->ie_asn.ls4b |= (uint32_t)buf[2] << 16;
+      ies->ie_asn.ls4b |= (uint32_t)buf[3] << 24;
+      ies->ie_asn.ms1b = (uint8_t)buf[4];
+      ies->ie_join_priority = (uint8_t)buf[5];
+    }
+    return len;
+  }
+  return -1;
+}
+
+/* MLME sub-IE. TSCH timeslot */
+static int
+parse_ie_tsch_timeslot(const uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
+{
+  if(len == 1 || len == 25) {
+    if(ies != NULL) {
+      ies->ie_tsch_timeslot_id = buf[0];
+      if(len == 25) {
         int i;
-        int num_slotframes = buf[0];
-        int num_links = buf[4];
-        if(num_slotframes == 0) {
-          return len;
-        }
-        if(num_slotframes <= 1 && num_links <= FRAME802154E_IE_MAX_LINKS
-            && len == 1 + num_slotframes * (4 + 5 * num_links)) {
-          if(ies != NULL) {
-            /* We support only 0 or 1 slotframe in this IE and a predefined maximum number of links */
-            ies->ie_tsch_slotframe_and_link.num_slotframes = buf[0];
-            ies->ie_tsch_slotframe_and_link.slotframe_handle = buf[1];
-            READ16(buf + 2, ies->ie_tsch_slotframe_and_link.slotframe_size);
-            ies->ie_tsch_slotframe_and_link.num_links = buf[4];
-            for(i = 0; i < num_links; i++) {
-              READ16(buf + 5 + i * 5, ies->ie_tsch_slotframe_and_link.links[i].timeslot);
-              READ16(buf + 5 + i * 5 + 2, ies->ie_tsch_slotframe_and_link.links[i].channel_offset);
-              ies->ie_tsch_slotframe_and_link.links[i].link_options = buf[5 + i * 5 + 4];
-            }
-          }
-          return len;
+        for(i = 0; i < tsch_ts_elements_count; i++) {
+          READ16(buf+1+2*i, ies->ie_tsch_timeslot[i]);
         }
       }
-      break;
+    }
+    return len;
+  }
+  return -1;
+}
 
-#if TESLA
-    case MLME_SHORT_IE_TSCH_SF_SIZE:
-    if(len == 3) {
-        if(ies != NULL) {
-          READ16(buf, ies->sf_size);
-          ies->sf_size_version = buf[2];
-          //printf("parse: sf_size %u, ver %u\n",ies->sf_size,ies->sf_size_version);
-        }
-        return len;
-      }
-      break;
-#endif      
-    case MLME_SHORT_IE_TSCH_SYNCHRONIZATION:
-      if(len == 6) {
-        if(ies != NULL) {
-          ies->ie_asn.ls4b = (uint32_t)buf[0];
-          ies->ie_asn.ls4b |= (uint32_t)buf[1] << 8;
-          ies->ie_asn.ls4b |= (uint32_t)buf[2] << 16;
-          ies->ie_asn.ls4b |= (uint32_t)buf[3] << 24;
-          ies->ie_asn.ms1b = (uint8_t)buf[4];
-          ies->ie_join_priority = (uint8_t)buf[5];
-        }
-        return len;
-      }
-      break;
-    case MLME_SHORT_IE_TSCH_TIMESLOT:
-      if(len == 1 || len == 25) {
-        if(ies != NULL) {
-          ies->ie_tsch_timeslot_id = buf[0];
-          if(len == 25) {
-            int i;
-            for(i = 0; i < tsch_ts_elements_count; i++) {
-              READ16(buf+1+2*i, ies->ie_tsch_timeslot[i]);
-            }
-          }
+/* MLME long sub-IE. TSCH channel hopping sequence */
+static int
+parse_ie_tsch_channel_hopping_sequence(const uint8_t *buf, int len,
+    struct ieee802154_ies *ies)
+{
+  if(len > 0) {
+    if(ies != NULL) {
+      ies->ie_channel_hopping_sequence_id = buf[0];
+      if(len >= 12) {
+        READ16(buf+8, ies->ie_hopping_sequence_len); /* sequence len */
+        if(ies->ie_hopping_sequence_len <= sizeof(ies->ie_hopping_sequence_list)
+            && len == 12 + ies->ie_hopping_sequence_len) {
+          memcpy(ies->ie_hopping_sequence_list, buf+10, ies->ie_hopping_sequence_len); /* sequence list */
         }
-        return len;
       }
-      break;
+    }
+    return len;
+  }
+  return -1;
+}
+
+/* All header IEs and MLME short sub-IEs we support have an id between
+ * IE_TABLE_BASE and IE_TABLE_BASE + IE_TABLE_SIZE - 1, which lets us find
+ * the parser of an IE with a single table lookup rather than a switch */
+#define IE_TABLE_BASE 0x18
+#define IE_TABLE_SIZE 8
+
+#if TESLA
+#define PARSE_IE_TSCH_SF_SIZE parse_ie_tsch_sf_size
+#else
+#define PARSE_IE_TSCH_SF_SIZE NULL
+#endif
+
+/* Header IE parsers, c.f. IEEE 802.15.4e Table 4b */
+static const ie_parse_func header_ie_parsers[IE_TABLE_SIZE] = {
+  NULL,
+  PARSE_IE_TSCH_SF_SIZE,                /* 0x19 */
+  NULL,                                 /* LE CSL */
+  NULL,                                 /* LE RIT */
+  NULL,                                 /* DSME PAN descriptor */
+  NULL,                                 /* RZ time */
+  parse_ie_ack_nack_time_correction,    /* 0x1e */
+  NULL,                                 /* GACK */
+};
+
+/* MLME short sub-IE parsers, c.f. IEEE 802.15.4e Table 4d */
+static const ie_parse_func mlme_short_ie_parsers[IE_TABLE_SIZE] = {
+  NULL,
+  PARSE_IE_TSCH_SF_SIZE,                /* 0x19 */
+  parse_ie_tsch_synchronization,        /* 0x1a */
+  parse_ie_tsch_slotframe_and_link,     /* 0x1b */
+  parse_ie_tsch_timeslot,               /* 0x1c */
+  NULL,                                 /* Hopping timing */
+  NULL,                                 /* EB filter */
+  NULL,                                 /* MAC metrics 1 */
+};
+
+/* Parse an IE with the parser found in a table, if any */
+static int
+parse_ie(const ie_parse_func *parsers, const uint8_t *buf, int len,
+    uint8_t id, struct ieee802154_ies *ies)
+{
+  uint8_t index = id - IE_TABLE_BASE;
+  if(index < IE_TABLE_SIZE && parsers[index] != NULL) {
+    return parsers[index](buf, len, ies);
   }
   return -1;
 }
@@ -498,22 +570,8 @@ static int
 frame802154e_parse_mlme_long_ie(const uint8_t *buf, int len,
     uint8_t sub_id, struct ieee802154_ies *ies)
 {
-  switch(sub_id) {
-    case MLME_LONG_IE_TSCH_CHANNEL_HOPPING_SEQUENCE:
-      if(len > 0) {
-        if(ies != NULL) {
-          ies->ie_channel_hopping_sequence_id = buf[0];
-          if(len > 1) {
-            READ16(buf+8, ies->ie_hopping_sequence_len); /* sequence len */
-            if(ies->ie_hopping_sequence_len <= sizeof(ies->ie_hopping_sequence_list)
-                && len == 12 + ies->ie_hopping_sequence_len) {
-              memcpy(ies->ie_hopping_sequence_list, buf+10, ies->ie_hopping_sequence_len); /* sequence list */
-            }
-          }
-        }
-        return len;
-      }
-      break;
+  if(sub_id == MLME_LONG_IE_TSCH_CHANNEL_HOPPING_SEQUENCE) {
+    return parse_ie_tsch_channel_hopping_sequence(buf, len, ies);
   }
   return -1;
 }
@@ -586,7 +644,7 @@ frame802154e_parse_information_elements(const uint8_t *buf, uint8_t buf_size,
             }
           default:
             //printf("c3\n");
-            if(len > buf_size || frame802154e_parse_header_ie(buf, len, id, ies) == -1) {
+            if(len > buf_size || parse_ie(header_ie_parsers, buf, len, id, ies) == -1) {
               PRINTF("frame802154e: failed to parse\n");
               return -1;
             }
@@ -626,7 +684,7 @@ frame802154e_parse_information_elements(const uint8_t *buf, uint8_t buf_size,
           len = ie_desc & 0x00ff; /* b0-b7 */
           id = (ie_desc & 0x7f00) >> 8; /* b8-b14 */
           PRINTF("frame802154e: short mlme ie len %u id %x\n", len, id);
-          if(len > buf_size || frame802154e_parse_mlme_short_ie(buf, len, id, ies) == -1) {
+          if(len > buf_size || parse_ie(mlme_short_ie_parsers, buf, len, id, ies) == -1) {
             PRINTF("frame802154e: failed to parse ie\n");
             return -1;
           }
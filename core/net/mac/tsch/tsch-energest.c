@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Radio-on time accounting for TSCH, per slotframe, neighbor
+ *         and link type.
+ *
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-private.h"
+#include "net/mac/tsch/tsch-energest.h"
+
+#include <string.h>
+
+#if TSCH_ENERGEST_ENABLED
+
+static struct tsch_energest_snapshot counters;
+/* Incremented at every update, for consistent snapshots */
+static volatile uint16_t generation;
+
+static rtimer_clock_t radio_on_since;
+static uint8_t radio_is_on;
+/* Radio-on time in the current slot */
+static rtimer_clock_t slot_radio_time;
+static const struct tsch_neighbor *slot_neighbor;
+
+/*---------------------------------------------------------------------------*/
+static int
+link_type(const struct tsch_link *link, const struct tsch_neighbor *n)
+{
+#if PROPOSED && RESIDUAL_ALLOC
+  if(link->slotframe_handle > SSQ_SCHEDULE_HANDLE_OFFSET) {
+    return TSCH_ENERGEST_LINK_SSQ;
+  }
+#endif
+  if(link->link_type == LINK_TYPE_ADVERTISING_ONLY ||
+     (n != NULL && n == n_eb)) {
+    return TSCH_ENERGEST_LINK_EB;
+  }
+  if(link->link_options & LINK_OPTION_SHARED) {
+    return TSCH_ENERGEST_LINK_SHARED;
+  }
+  return TSCH_ENERGEST_LINK_UNICAST;
+}
+/*---------------------------------------------------------------------------*/
+static void
+account(struct tsch_energest *e, rtimer_clock_t time, int is_tx)
+{
+  if(is_tx) {
+    e->tx += time;
+  } else {
+    e->rx += time;
+  }
+  e->slots++;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_radio_on(void)
+{
+  if(!radio_is_on) {
+    radio_on_since = RTIMER_NOW();
+    radio_is_on = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_radio_off(void)
+{
+  if(radio_is_on) {
+    slot_radio_time += (rtimer_clock_t)(RTIMER_NOW() - radio_on_since);
+    radio_is_on = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_slot_neighbor(const struct tsch_neighbor *n)
+{
+  slot_neighbor = n;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_slot_end(const struct tsch_link *link, int is_tx)
+{
+  const struct tsch_neighbor *n;
+  struct tsch_energest_neighbor *e;
+  rtimer_clock_t now;
+  rtimer_clock_t time;
+  int index;
+
+  if(radio_is_on) {
+    /* Radio kept on across slots: split at the slot boundary */
+    now = RTIMER_NOW();
+    slot_radio_time += (rtimer_clock_t)(now - radio_on_since);
+    radio_on_since = now;
+  }
+  time = slot_radio_time;
+  slot_radio_time = 0;
+  n = slot_neighbor;
+  slot_neighbor = NULL;
+  if(link == NULL) {
+    return;
+  }
+
+  account(&counters.link_types[link_type(link, n)], time, is_tx);
+
+  index = link->slotframe_handle;
+  if(index >= TSCH_ENERGEST_SLOTFRAMES) {
+    index = TSCH_ENERGEST_SLOTFRAMES - 1;
+  }
+  account(&counters.slotframes[index], time, is_tx);
+
+  if(n != NULL) {
+    index = tsch_queue_get_nbr_index(n);
+    if(index >= 0 && index < TSCH_QUEUE_MAX_NEIGHBOR_QUEUES) {
+      e = &counters.neighbors[index];
+      if(!linkaddr_cmp(&e->addr, &n->addr)) {
+        linkaddr_copy(&e->addr, &n->addr);
+        memset(&e->energest, 0, sizeof(e->energest));
+      }
+      account(&e->energest, time, is_tx);
+    }
+  }
+  generation++;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_snapshot(struct tsch_energest_snapshot *s)
+{
+  uint16_t g;
+
+  /* Slot operation may preempt the copy: retry until no slot ended
+   * during it */
+  do {
+    g = generation;
+    memcpy(s, &counters, sizeof(struct tsch_energest_snapshot));
+  } while(g != generation);
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_energest_init(void)
+{
+  memset(&counters, 0, sizeof(counters));
+  radio_is_on = 0;
+  slot_radio_time = 0;
+  slot_neighbor = NULL;
+  generation++;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_ENERGEST_ENABLED */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Radio-on time accounting for TSCH. Complements energest, which
+ *         only keeps global totals, by attributing the radio-on time of
+ *         every active slot to its slotframe handle, its neighbor and its
+ *         link type (EB, shared, unicast, SSQ one-shot). Accounting is
+ *         done from the slot operation interrupt with constant-time array
+ *         indexing; tsch_energest_snapshot() copies the counters from
+ *         process context.
+ */
+
+#ifndef __TSCH_ENERGEST_H__
+#define __TSCH_ENERGEST_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "net/linkaddr.h"
+
+/******** Configuration *******/
+
+/* Enable per-slotframe, per-neighbor and per-link type accounting */
+#ifdef TSCH_ENERGEST_CONF_ENABLED
+#define TSCH_ENERGEST_ENABLED TSCH_ENERGEST_CONF_ENABLED
+#else /* TSCH_ENERGEST_CONF_ENABLED */
+#define TSCH_ENERGEST_ENABLED 0
+#endif /* TSCH_ENERGEST_CONF_ENABLED */
+
+/* Number of slotframe counters. Slotframe handles from
+ * TSCH_ENERGEST_SLOTFRAMES - 1 upwards all share the last counter */
+#ifdef TSCH_ENERGEST_CONF_SLOTFRAMES
+#define TSCH_ENERGEST_SLOTFRAMES TSCH_ENERGEST_CONF_SLOTFRAMES
+#else /* TSCH_ENERGEST_CONF_SLOTFRAMES */
+#define TSCH_ENERGEST_SLOTFRAMES 8
+#endif /* TSCH_ENERGEST_CONF_SLOTFRAMES */
+
+#if TSCH_ENERGEST_ENABLED
+
+#include "sys/rtimer.h"
+#include "net/mac/tsch/tsch-queue.h"
+#include "net/mac/tsch/tsch-schedule.h"
+
+/************ Types ***********/
+
+enum tsch_energest_link_type {
+  TSCH_ENERGEST_LINK_EB,
+  TSCH_ENERGEST_LINK_SHARED,
+  TSCH_ENERGEST_LINK_UNICAST,
+  TSCH_ENERGEST_LINK_SSQ,
+  TSCH_ENERGEST_LINK_TYPES
+};
+
+/* Radio-on time, in rtimer ticks, and number of active slots */
+struct tsch_energest {
+  uint32_t tx; /* Radio on in slots with a transmission */
+  uint32_t rx; /* Radio on in listening slots */
+  uint32_t slots;
+};
+
+/* Per-neighbor counters, indexed as the TSCH neighbor pool. A counter
+ * is restarted when its entry is reused for another neighbor */
+struct tsch_energest_neighbor {
+  linkaddr_t addr;
+  struct tsch_energest energest;
+};
+
+struct tsch_energest_snapshot {
+  struct tsch_energest link_types[TSCH_ENERGEST_LINK_TYPES];
+  struct tsch_energest slotframes[TSCH_ENERGEST_SLOTFRAMES];
+  struct tsch_energest_neighbor neighbors[TSCH_QUEUE_MAX_NEIGHBOR_QUEUES];
+};
+
+/********** Functions *********/
+
+/* Called from slot operation when turning the radio on and off */
+void tsch_energest_radio_on(void);
+void tsch_energest_radio_off(void);
+/* Called from slot operation with the neighbor transmitted to or
+ * received from in the current slot */
+void tsch_energest_slot_neighbor(const struct tsch_neighbor *n);
+/* Called from slot operation at the end of an active slot */
+void tsch_energest_slot_end(const struct tsch_link *link, int is_tx);
+/* Copy all counters to s, consistently with regard to slot operation */
+void tsch_energest_snapshot(struct tsch_energest_snapshot *s);
+/* Reset all counters */
+void tsch_energest_init(void);
+
+#else /* TSCH_ENERGEST_ENABLED */
+
+#define tsch_energest_radio_on()
+#define tsch_energest_radio_off()
+#define tsch_energest_slot_neighbor(n)
+#define tsch_energest_slot_end(link, is_tx)
+#define tsch_energest_init()
+
+#endif /* TSCH_ENERGEST_ENABLED */
+
+#endif /* __TSCH_ENERGEST_H__ */
@@ -364,6 +364,14 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
   return n;
 }
 /*---------------------------------------------------------------------------*/
+/* Get the index of a neighbor in the neighbor pool, in
+ * [0, TSCH_QUEUE_MAX_NEIGHBOR_QUEUES) */
+int
+tsch_queue_get_nbr_index(const struct tsch_neighbor *n)
+{
+  return n - (struct tsch_neighbor *)neighbor_memb.mem;
+}
+/*---------------------------------------------------------------------------*/
 
 struct tsch_neighbor *
 tsch_queue_get_nbr_from_id(const uint16_t id)
@@ -158,6 +158,9 @@ extern struct tsch_neighbor *n_eb;
 struct tsch_neighbor *tsch_queue_add_nbr(const linkaddr_t *addr);
 /* Get a TSCH neighbor */
 struct tsch_neighbor *tsch_queue_get_nbr(const linkaddr_t *addr);
+/* Get the index of a neighbor in the neighbor pool, in
+ * [0, TSCH_QUEUE_MAX_NEIGHBOR_QUEUES) */
+int tsch_queue_get_nbr_index(const struct tsch_neighbor *n);
 /* Get a TSCH time source (we currently assume there is only one) */
 
 #if TESLA
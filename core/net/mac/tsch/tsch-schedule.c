@@ -55,7 +55,7 @@
 #include "sys/rtimer.h"
 #include <string.h>
 
-#if PROPOSED && RESIDUAL_ALLOC
+#if PROPOSED
     #include "orchestra.h"
 #endif
 #if TSCH_LOG_LEVEL >= 1
@@ -72,6 +72,218 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_INDEX
+/* One entry per slotframe with links. Its links are
+ * index_links[first..first+count), sorted by timeslot. next is the time
+ * of its next link occurrence, in ASN after index_asn. The entries form
+ * a min-heap on next. */
+struct index_entry {
+  struct tsch_slotframe *sf;
+  struct tsch_link *link;
+  uint32_t next;
+  uint16_t first;
+  uint16_t count;
+  /* Position in slotframe_list, as overlaps are resolved in that order */
+  uint16_t order;
+};
+static struct index_entry index_heap[TSCH_SCHEDULE_MAX_SLOTFRAMES];
+static uint16_t index_count;
+static struct tsch_link *index_links[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t index_tied[TSCH_SCHEDULE_MAX_SLOTFRAMES];
+static struct tsch_asn_t index_asn;
+/* ASN of the last lookup, relative to index_asn */
+static uint32_t index_offset;
+static uint8_t index_valid;
+#define INDEX_INVALIDATE() (index_valid = 0)
+#else /* TSCH_SCHEDULE_WITH_INDEX */
+#define INDEX_INVALIDATE()
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+
+#if TSCH_SCHEDULE_BATCH
+PROCESS_NAME(tsch_pending_events_process);
+
+enum staged_type {
+  STAGED_ADD_SLOTFRAME,
+  STAGED_REMOVE_SLOTFRAME,
+  STAGED_ADD_LINK,
+  STAGED_REMOVE_LINK
+};
+
+struct staged_op {
+  uint8_t type;
+  struct tsch_slotframe *sf;
+  struct tsch_link *l;
+};
+
+/* Staged updates. The indices run freely and wrap at 256:
+ * [reclaimed, applied) are applied and their removed objects not yet
+ * freed, [applied, committed) wait for slot operation, and
+ * [committed, staged) belong to the group in progress. Only process
+ * context stages, commits and frees; the updates are applied either by
+ * slot operation or by process context holding the TSCH lock. */
+static struct staged_op staged_ops[TSCH_SCHEDULE_BATCH_SIZE];
+static uint8_t staged_reclaimed;
+static volatile uint8_t staged_applied;
+static volatile uint8_t staged_committed;
+static volatile uint8_t staged_count;
+/* Nesting depth of tsch_schedule_begin() */
+static uint8_t staged_depth;
+
+#define STAGED_OP(i) (&staged_ops[(uint8_t)(i) % TSCH_SCHEDULE_BATCH_SIZE])
+
+/* Remove an item from a list but keep its next pointer, so that process
+ * code walking the list when slot operation preempts it carries on */
+static void
+staged_list_remove(list_t list, void *item)
+{
+  void *next = list_item_next(item);
+  list_remove(list, item);
+  *(void **)item = next;
+}
+/*---------------------------------------------------------------------------*/
+/* Apply the committed updates. Slot operation must not be using the
+ * schedule: call it from slot operation or with the TSCH lock. */
+static void
+staged_apply(void)
+{
+  struct staged_op *op;
+  struct tsch_link *l;
+
+  if(staged_applied == staged_committed) {
+    return;
+  }
+  while(staged_applied != staged_committed) {
+    op = STAGED_OP(staged_applied);
+    switch(op->type) {
+    case STAGED_ADD_SLOTFRAME:
+      list_add(slotframe_list, op->sf);
+      break;
+    case STAGED_REMOVE_SLOTFRAME:
+      for(l = list_head(op->sf->links_list); l != NULL; l = list_item_next(l)) {
+        if(l == current_link) {
+          current_link = NULL;
+        }
+      }
+      staged_list_remove(slotframe_list, op->sf);
+      break;
+    case STAGED_ADD_LINK:
+      list_add(op->sf->links_list, op->l);
+      break;
+    case STAGED_REMOVE_LINK:
+      /* The link to be removed is scheduled as next, set it to NULL
+       * to abort the next link operation */
+      if(op->l == current_link) {
+        current_link = NULL;
+      }
+      staged_list_remove(op->sf->links_list, op->l);
+      break;
+    }
+    staged_applied++;
+  }
+  INDEX_INVALIDATE();
+}
+/*---------------------------------------------------------------------------*/
+/* Apply the committed updates now unless a slot is in progress, in which
+ * case slot operation applies them at the end of the slot */
+static void
+staged_try_apply(void)
+{
+  if(staged_applied != staged_committed && tsch_try_lock()) {
+    staged_apply();
+    tsch_release_lock();
+    tsch_schedule_process_pending();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Apply all staged updates now, waiting for the slot in progress if
+ * needed. Only used when the staging area or the pools are full. */
+static int
+staged_flush(void)
+{
+  staged_committed = staged_count;
+  if(staged_applied != staged_committed) {
+    if(!tsch_get_lock()) {
+      return 0;
+    }
+    staged_apply();
+    tsch_release_lock();
+  }
+  tsch_schedule_process_pending();
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Stage an update. Outside of a group it is committed right away */
+static int
+staged_add(uint8_t type, struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  struct staged_op *op;
+
+  if((uint8_t)(staged_count - staged_reclaimed) == TSCH_SCHEDULE_BATCH_SIZE) {
+    tsch_schedule_process_pending();
+    if((uint8_t)(staged_count - staged_reclaimed) == TSCH_SCHEDULE_BATCH_SIZE
+       && !staged_flush()) {
+      PRINTF("TSCH-schedule:! staging area full\n");
+      return 0;
+    }
+  }
+  op = STAGED_OP(staged_count);
+  op->type = type;
+  op->sf = sf;
+  op->l = l;
+  staged_count++;
+  if(staged_depth == 0) {
+    staged_committed = staged_count;
+    staged_try_apply();
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Has a slotframe been removed by an update not yet freed? */
+static int
+staged_sf_removed(struct tsch_slotframe *sf)
+{
+  uint8_t i;
+
+  for(i = staged_reclaimed; i != staged_count; i++) {
+    if(STAGED_OP(i)->type == STAGED_REMOVE_SLOTFRAME && STAGED_OP(i)->sf == sf) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Has a link been removed by an update not yet freed? */
+static int
+staged_link_removed(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint8_t i;
+
+  for(i = staged_reclaimed; i != staged_count; i++) {
+    if(STAGED_OP(i)->type == STAGED_REMOVE_LINK && STAGED_OP(i)->l == l) {
+      return 1;
+    }
+  }
+  return staged_sf_removed(sf);
+}
+/*---------------------------------------------------------------------------*/
+/* Update the neighbor counters of a removed link and free it */
+static void
+staged_free_link(struct tsch_link *l)
+{
+  /* This was a tx link to this neighbor, update counters */
+  if(l->link_options & LINK_OPTION_TX) {
+    struct tsch_neighbor *n = tsch_queue_add_nbr(&l->addr);
+    if(n != NULL) {
+      n->tx_links_count--;
+      if(!(l->link_options & LINK_OPTION_SHARED)) {
+        n->dedicated_tx_links_count--;
+      }
+    }
+  }
+  memb_free(&link_memb, l);
+}
+#endif /* TSCH_SCHEDULE_BATCH */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -86,6 +298,32 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
     return NULL;
   }
 
+#if TSCH_SCHEDULE_BATCH
+  {
+    struct tsch_slotframe *sf = memb_alloc(&slotframe_memb);
+    if(sf == NULL && staged_flush()) {
+      /* Removed slotframes may be waiting to be freed */
+      sf = memb_alloc(&slotframe_memb);
+    }
+    if(sf != NULL) {
+      /* Initialize the slotframe */
+      sf->handle = handle;
+      TSCH_ASN_DIVISOR_INIT(sf->size, size);
+      LIST_STRUCT_INIT(sf, links_list);
+      /* Add the slotframe to the global list */
+      if(!staged_add(STAGED_ADD_SLOTFRAME, sf, NULL)) {
+        memb_free(&slotframe_memb, sf);
+        sf = NULL;
+      }
+    }
+    if(sf == NULL) {
+      PRINTF("ERROR: add_slotframe fail\n");
+    }
+    PRINTF("TSCH-schedule: add_slotframe %u %u\n",
+           handle, size);
+    return sf;
+  }
+#else /* TSCH_SCHEDULE_BATCH */
   if(tsch_get_lock()) {
     struct tsch_slotframe *sf = memb_alloc(&slotframe_memb);
     if(sf != NULL) {
@@ -95,6 +333,7 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       LIST_STRUCT_INIT(sf, links_list);
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
+      INDEX_INVALIDATE();
     }
     else{
       PRINTF("ERROR: add_slotframe fail\n");
@@ -105,6 +344,7 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
     return sf;
   }
   return NULL;
+#endif /* TSCH_SCHEDULE_BATCH */
 }
 /*---------------------------------------------------------------------------*/
 /* Removes all slotframes, resulting in an empty schedule */
@@ -112,11 +352,31 @@ int
 tsch_schedule_remove_all_slotframes(void)
 {
   struct tsch_slotframe *sf;
+#if TSCH_SCHEDULE_BATCH
+  /* Get the staged slotframes into the list first */
+  if(!staged_flush()) {
+    return 0;
+  }
+  sf = list_head(slotframe_list);
+  while(sf != NULL) {
+    /* The removal may be applied and freed right away */
+    struct tsch_slotframe *next = list_item_next(sf);
+    if(tsch_schedule_remove_slotframe(sf) == 0) {
+      return 0;
+    }
+    sf = next;
+  }
+#else /* TSCH_SCHEDULE_BATCH */
   while((sf = list_head(slotframe_list))) {
     if(tsch_schedule_remove_slotframe(sf) == 0) {
       return 0;
     }
   }
+#endif /* TSCH_SCHEDULE_BATCH */
+#if PROPOSED
+  /* The OST slotframes went along with the rest */
+  reset_t_offset_occupancy();
+#endif
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -124,6 +384,14 @@ tsch_schedule_remove_all_slotframes(void)
 int
 tsch_schedule_remove_slotframe(struct tsch_slotframe *slotframe)
 {
+#if TSCH_SCHEDULE_BATCH
+  /* Its links are freed along with it */
+  if(slotframe != NULL && !staged_sf_removed(slotframe)
+     && staged_add(STAGED_REMOVE_SLOTFRAME, slotframe, NULL)) {
+    PRINTF("TSCH-schedule: remove_slotframe %u %u\n", slotframe->handle, slotframe->size.val);
+    return 1;
+  }
+#else /* TSCH_SCHEDULE_BATCH */
   if(slotframe != NULL) {
     /* Remove all links belonging to this slotframe */
     struct tsch_link *l;
@@ -144,10 +412,12 @@ tsch_schedule_remove_slotframe(struct tsch_slotframe *slotframe)
       PRINTF("TSCH-schedule: remove_slotframe %u %u\n", slotframe->handle, slotframe->size.val);
       memb_free(&slotframe_memb, slotframe);
       list_remove(slotframe_list, slotframe);
+      INDEX_INVALIDATE();
       tsch_release_lock();
       return 1;
     }
   }
+#endif /* TSCH_SCHEDULE_BATCH */
   return 0;
 }
 /*---------------------------------------------------------------------------*/
@@ -168,6 +438,17 @@ tsch_schedule_change_slotframe_link_handle(struct tsch_slotframe *slotframe, uin
         l->slotframe_handle = handle; //link handle change
         l = list_item_next(l);
     }
+#if TSCH_SCHEDULE_BATCH
+    {
+      uint8_t i;
+      for(i = staged_reclaimed; i != staged_count; i++) {
+        if(STAGED_OP(i)->type == STAGED_ADD_LINK && STAGED_OP(i)->sf == slotframe) {
+          STAGED_OP(i)->l->slotframe_handle = handle;
+        }
+      }
+    }
+#endif /* TSCH_SCHEDULE_BATCH */
+    INDEX_INVALIDATE();
     return 1;
   }
 
@@ -183,10 +464,25 @@ tsch_schedule_get_slotframe_by_handle(uint16_t handle)
     struct tsch_slotframe *sf = list_head(slotframe_list);
     while(sf != NULL) {
       if(sf->handle == handle) {
-        return sf;
+        break;
       }
       sf = list_item_next(sf);
     }
+#if TSCH_SCHEDULE_BATCH
+    {
+      /* Replay the staged updates on top of the list */
+      uint8_t i;
+      for(i = staged_reclaimed; i != staged_count; i++) {
+        struct staged_op *op = STAGED_OP(i);
+        if(op->type == STAGED_ADD_SLOTFRAME && op->sf->handle == handle) {
+          sf = op->sf;
+        } else if(op->type == STAGED_REMOVE_SLOTFRAME && op->sf == sf) {
+          sf = NULL;
+        }
+      }
+    }
+#endif /* TSCH_SCHEDULE_BATCH */
+    return sf;
   }
   return NULL;
 }
@@ -224,6 +520,59 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
     /* Start with removing the link currently installed at this timeslot (needed
      * to keep neighbor state in sync with link options etc.) */
     tsch_schedule_remove_link_by_timeslot(slotframe, timeslot);
+#if TSCH_SCHEDULE_BATCH
+    if(staged_sf_removed(slotframe)) {
+      PRINTF("TSCH-schedule:! add_link to a removed slotframe\n");
+      return NULL;
+    }
+    l = memb_alloc(&link_memb);
+    if(l == NULL && staged_flush()) {
+      /* Removed links may be waiting to be freed */
+      l = memb_alloc(&link_memb);
+    }
+    if(l == NULL) {
+      PRINTF("TSCH-schedule:! add_link memb_alloc failed\n");
+    } else {
+      static int current_link_handle = 0;
+      struct tsch_neighbor *n;
+      /* Initialize link */
+      l->handle = current_link_handle++;
+      l->link_options = link_options;
+      l->link_type = link_type;
+      l->slotframe_handle = slotframe->handle;
+      l->timeslot = timeslot;
+      l->channel_offset = channel_offset;
+      l->data = NULL;
+      if(address == NULL) {
+        address = &linkaddr_null;
+      }
+      linkaddr_copy(&l->addr, address);
+      /* Add the link to the slotframe */
+      if(!staged_add(STAGED_ADD_LINK, slotframe, l)) {
+        memb_free(&link_memb, l);
+        return NULL;
+      }
+
+      PRINTF("TSCH-schedule: add_link %u %u %u %u %u %u\n",
+             slotframe->handle, link_options, link_type, timeslot, channel_offset, TSCH_LOG_ID_FROM_LINKADDR(address));
+
+      if(timeslot>=slotframe->size.val)
+      {
+        printf("ERROR: too big timeslot %u %u %u (tsch_schedule_add_link)\n",slotframe->handle, timeslot, slotframe->size.val);
+      }
+
+      if(l->link_options & LINK_OPTION_TX) {
+        n = tsch_queue_add_nbr(&l->addr);
+        /* We have a tx link to this neighbor, update counters */
+        if(n != NULL) {
+          n->tx_links_count++;
+          if(!(l->link_options & LINK_OPTION_SHARED)) {
+            n->dedicated_tx_links_count++;
+          }
+        }
+      }
+    }
+#else /* TSCH_SCHEDULE_BATCH */
     if(!tsch_get_lock()) {
       PRINTF("TSCH-schedule:! add_link memb_alloc couldn't take lock\n");
     } else {
@@ -248,6 +597,7 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+        INDEX_INVALIDATE();
 
         PRINTF("TSCH-schedule: add_link %u %u %u %u %u %u\n",
                slotframe->handle, link_options, link_type, timeslot, channel_offset, TSCH_LOG_ID_FROM_LINKADDR(address));
@@ -275,6 +625,7 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
 
       }
     }
+#endif /* TSCH_SCHEDULE_BATCH */
   }
   return l;
 }
@@ -285,6 +636,16 @@ int
 tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
 {
   if(slotframe != NULL && l != NULL && l->slotframe_handle == slotframe->handle) {
+#if TSCH_SCHEDULE_BATCH
+    /* The neighbor counters are updated when the link is freed */
+    if(!staged_link_removed(slotframe, l)
+       && staged_add(STAGED_REMOVE_LINK, slotframe, l)) {
+      PRINTF("TSCH-schedule: remove_link %u %u %u %u %u\n",
+             slotframe->handle, l->link_options, l->timeslot, l->channel_offset,
+             TSCH_LOG_ID_FROM_LINKADDR(&l->addr));
+      return 1;
+    }
+#else /* TSCH_SCHEDULE_BATCH */
     if(tsch_get_lock()) {
       uint8_t link_options;
       linkaddr_t addr;
@@ -306,6 +667,7 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
 
       list_remove(slotframe->links_list, l);
       memb_free(&link_memb, l);
+      INDEX_INVALIDATE();
 
       /* Release the lock before we update the neighbor (will take the lock) */
       tsch_release_lock();
@@ -325,6 +687,7 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
     } else {
       PRINTF("TSCH-schedule:! remove_link memb_alloc couldn't take lock\n");
     }
+#endif /* TSCH_SCHEDULE_BATCH */
   }
 
   return 0;
@@ -348,16 +711,60 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe, uint16_t ti
       /* Loop over all items. Assume there is max one link per timeslot */
       while(l != NULL) {
         if(l->timeslot == timeslot) {
-          return l;
+          break;
         }
         l = list_item_next(l);
       }
+#if TSCH_SCHEDULE_BATCH
+      {
+        /* Replay the staged updates on top of the list */
+        uint8_t i;
+        for(i = staged_reclaimed; i != staged_count; i++) {
+          struct staged_op *op = STAGED_OP(i);
+          if(op->type == STAGED_ADD_LINK && op->sf == slotframe
+             && op->l->timeslot == timeslot) {
+            l = op->l;
+          } else if((op->type == STAGED_REMOVE_LINK && op->l == l)
+                    || (op->type == STAGED_REMOVE_SLOTFRAME && op->sf == slotframe)) {
+            l = NULL;
+          }
+        }
+      }
+#endif /* TSCH_SCHEDULE_BATCH */
       return l;
     }
   }
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Returns the first link of a slotframe, including staged links */
+struct tsch_link *
+tsch_schedule_get_link_head(struct tsch_slotframe *slotframe)
+{
+  struct tsch_link *l;
+
+  if(slotframe == NULL) {
+    return NULL;
+  }
+  l = list_head(slotframe->links_list);
+#if TSCH_SCHEDULE_BATCH
+  while(l != NULL && staged_link_removed(slotframe, l)) {
+    l = list_item_next(l);
+  }
+  if(l == NULL && !staged_sf_removed(slotframe)) {
+    uint8_t i;
+    for(i = staged_reclaimed; i != staged_count; i++) {
+      struct staged_op *op = STAGED_OP(i);
+      if(op->type == STAGED_ADD_LINK && op->sf == slotframe
+         && !staged_link_removed(slotframe, op->l)) {
+        return op->l;
+      }
+    }
+  }
+#endif /* TSCH_SCHEDULE_BATCH */
+  return l;
+}
+/*---------------------------------------------------------------------------*/
 #if PROPOSED
 #if RESIDUAL_ALLOC
 uint16_t
@@ -532,6 +939,396 @@ earlier_ssq_schedule_list(uint16_t * time_to_orig_schedule, struct tsch_link **
 #endif
 #endif
 
+/*---------------------------------------------------------------------------*/
+/* Two links occur in the same timeslot: pick the best one as curr_best,
+ * and maintain curr_backup */
+static void
+select_overlapping_link(struct tsch_link **best, struct tsch_link **backup,
+    struct tsch_link *l)
+{
+  struct tsch_link *curr_best = *best;
+  struct tsch_link *curr_backup = *backup;
+  struct tsch_link *new_best = NULL;
+  /* Two links are overlapping, we need to select one of them.
+   * By standard: prioritize Tx links first, second by lowest handle */
+  if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+    /* Both or neither links have Tx, select the one with lowest handle */
+    if(l->slotframe_handle < curr_best->slotframe_handle) {
+      new_best = l;
+    }
+#if PROPOSED
+    if( (curr_best->slotframe_handle==1) && (curr_best->link_options & LINK_OPTION_TX) &&  (l->slotframe_handle==2) )
+    { //Prevent Autonomous unicast Tx from interfere Autonomous broadcast Tx/Rx (They share the same c_offset in PROPOSED) 
+      //Prioritize Autonomous broadcast Tx/Rx to Autonomous unicast Tx
+      //printf("AU Tx < AB\n");
+      new_best = l;
+    }
+#endif
+
+#if TESLA
+    if( ((curr_best->link_options & LINK_OPTION_TX)==1) && ((l->link_options & LINK_OPTION_TX)==1) //Both Tx option
+        && (curr_best->slotframe_handle > 3) && (l->slotframe_handle > 3) //Both tx_sf //NOTE1
+    ) {
+
+      uint16_t id_curr_best=curr_best->slotframe_handle - 3; //NOTE1
+      uint16_t id_l=l->slotframe_handle-3; //NOTE1
+      struct tsch_neighbor *n_curr_best = tsch_queue_get_nbr_from_id(id_curr_best); //NOTE1
+      struct tsch_neighbor *n_l= tsch_queue_get_nbr_from_id(id_l);//NOTE1
+
+      uint8_t q_num_curr_best;
+      uint8_t q_num_l;
+
+      //printf("Tx link overlap: ID %u %u\n",id_curr_best,id_l);
+
+      if(n_curr_best==NULL)
+      {
+        q_num_curr_best=0; //child and queue is empty
+      }
+      else
+      {
+        q_num_curr_best=ringbufindex_elements(&n_curr_best->tx_ringbuf);
+      }
+
+      if(n_l==NULL)
+      {
+        q_num_l=0; //child and queue is empty
+      }
+      else
+      {
+        q_num_l=ringbufindex_elements(&n_l->tx_ringbuf);
+      }
+
+      //printf("Tx link overlap: Queue size %u %u\n",q_num_curr_best,q_num_l);
+      if(q_num_l>q_num_curr_best)
+      {
+        new_best = l;
+      }
+      else
+      {
+        new_best=curr_best;
+      }
+
+    }
+#endif
+    
+  } else {
+    /* Select the link that has the Tx option */
+    if(l->link_options & LINK_OPTION_TX) {
+      new_best = l;
+    }
+  }
+
+//#if TESLA
+  //Give the highest priority to EB (even if rx link)
+  if(l->slotframe_handle==0)
+  {
+    new_best = l;
+  }
+  else if(curr_best->slotframe_handle==0)
+  {
+    new_best = curr_best;
+  }
+//#endif
+
+  /* Maintain backup_link */
+  if(curr_backup == NULL) {
+    /* Check if 'l' best can be used as backup */
+    if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+      curr_backup = l;
+    }
+    /* Check if curr_best can be used as backup */
+    if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+      curr_backup = curr_best;
+    }
+  }
+  
+#if TESLA
+  else{ //curr_backup!=NULL   //backup link update
+
+    if(l!=NULL)
+    {
+
+      if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+
+          if(curr_backup->slotframe_handle > l->slotframe_handle)
+          {
+            //printf("Backup link update 1\n");
+            curr_backup = l;
+          }
+
+      }
+    }
+    else
+    {
+      //printf("l=NULL!\n");
+    }
+
+    if(curr_best!=NULL){
+      /* Check if curr_best can be used as backup */
+      if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+        
+          if(curr_backup->slotframe_handle > curr_best->slotframe_handle)
+          {
+            //printf("Backup link update 2\n");
+            curr_backup = curr_best;
+          }
+      }
+    }
+    else
+    {
+      //printf("curr_best=NULL!\n");
+    }
+
+
+  }
+#endif
+
+
+  /* Maintain curr_best */
+  if(new_best != NULL) {
+    curr_best = new_best;
+  }
+
+  *best = curr_best;
+  *backup = curr_backup;
+}
+#if TSCH_SCHEDULE_WITH_INDEX
+/*---------------------------------------------------------------------------*/
+/* Sets the next link occurrence of an index entry strictly after asn,
+ * which is offset ASN after index_asn */
+static void
+index_entry_update(struct index_entry *e, struct tsch_asn_t *asn, uint32_t offset)
+{
+  struct tsch_link **links = &index_links[e->first];
+  uint16_t timeslot = TSCH_ASN_MOD(*asn, e->sf->size);
+  uint16_t lo = 0;
+  uint16_t hi = e->count;
+  uint16_t mid;
+
+  /* Binary search for the first link after timeslot */
+  while(lo < hi) {
+    mid = (lo + hi) / 2;
+    if(links[mid]->timeslot > timeslot) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  if(lo < e->count) {
+    e->link = links[lo];
+    e->next = offset + (uint16_t)(links[lo]->timeslot - timeslot);
+  } else {
+    /* Wrap around to the first link of the next slotframe cycle */
+    e->link = links[0];
+    e->next = offset + (uint16_t)(e->sf->size.val + links[0]->timeslot - timeslot);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_sift_down(uint16_t i)
+{
+  struct index_entry tmp;
+  uint16_t c;
+
+  while((c = 2 * i + 1) < index_count) {
+    if(c + 1 < index_count && index_heap[c + 1].next < index_heap[c].next) {
+      c++;
+    }
+    if(index_heap[i].next <= index_heap[c].next) {
+      break;
+    }
+    tmp = index_heap[i];
+    index_heap[i] = index_heap[c];
+    index_heap[c] = tmp;
+    i = c;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_rebuild(struct tsch_asn_t *asn)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *l;
+  struct index_entry *e;
+  uint16_t nlinks = 0;
+  uint16_t order = 0;
+  uint16_t i;
+
+  index_asn = *asn;
+  index_offset = 0;
+  index_count = 0;
+  for(sf = list_head(slotframe_list); sf != NULL; sf = list_item_next(sf), order++) {
+    if(list_head(sf->links_list) == NULL) {
+      continue;
+    }
+    e = &index_heap[index_count++];
+    e->sf = sf;
+    e->first = nlinks;
+    e->count = 0;
+    e->order = order;
+    for(l = list_head(sf->links_list);
+        l != NULL && nlinks < TSCH_SCHEDULE_MAX_LINKS;
+        l = list_item_next(l)) {
+      /* Insertion sort on timeslot */
+      for(i = nlinks; i > e->first && index_links[i - 1]->timeslot > l->timeslot; i--) {
+        index_links[i] = index_links[i - 1];
+      }
+      index_links[i] = l;
+      nlinks++;
+      e->count++;
+    }
+    index_entry_update(e, asn, 0);
+  }
+  for(i = index_count / 2; i > 0; i--) {
+    index_sift_down(i - 1);
+  }
+  index_valid = 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Same result as the scan of all links in tsch_schedule_get_next_active_link */
+static struct tsch_link *
+index_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_to_best,
+    struct tsch_link **backup)
+{
+  struct tsch_link *curr_best;
+  struct tsch_link *curr_backup = NULL;
+  uint32_t offset;
+  uint32_t next;
+  uint16_t ntied;
+  uint16_t i;
+  uint16_t c;
+  uint16_t tmp;
+
+  offset = TSCH_ASN_DIFF(*asn, index_asn);
+  /* Rebuild after a schedule change, or if the ASN went backwards */
+  if(!index_valid || offset < index_offset || offset > 0x7fffffff) {
+    index_rebuild(asn);
+    offset = 0;
+  }
+  index_offset = offset;
+  if(index_count == 0) {
+    *time_to_best = 0;
+    *backup = NULL;
+    return NULL;
+  }
+
+  /* Move past asn the slotframes whose next link is no longer ahead */
+  while(index_heap[0].next <= offset) {
+    index_entry_update(&index_heap[0], asn, offset);
+    index_sift_down(0);
+  }
+
+  /* Collect all slotframes with a link at the earliest time. They form
+   * a subtree at the top of the heap. */
+  next = index_heap[0].next;
+  index_tied[0] = 0;
+  ntied = 1;
+  for(i = 0; i < ntied; i++) {
+    for(c = 2 * index_tied[i] + 1; c <= 2 * index_tied[i] + 2 && c < index_count; c++) {
+      if(index_heap[c].next == next) {
+        index_tied[ntied++] = c;
+      }
+    }
+  }
+  /* Resolve overlaps in slotframe list order, as the scan does */
+  for(i = 1; i < ntied; i++) {
+    tmp = index_tied[i];
+    for(c = i; c > 0 && index_heap[index_tied[c - 1]].order > index_heap[tmp].order; c--) {
+      index_tied[c] = index_tied[c - 1];
+    }
+    index_tied[c] = tmp;
+  }
+  curr_best = index_heap[index_tied[0]].link;
+  for(i = 1; i < ntied; i++) {
+    select_overlapping_link(&curr_best, &curr_backup, index_heap[index_tied[i]].link);
+  }
+
+  *time_to_best = (uint16_t)(next - offset);
+  *backup = curr_backup;
+  return curr_best;
+}
+/*---------------------------------------------------------------------------*/
+#if PROPOSED && RESIDUAL_ALLOC
+/* Index of the earliest entry in ssq_schedule_list, -1 if none */
+static int8_t ssq_earliest = -1;
+static uint8_t ssq_dirty = 1;
+
+void
+tsch_schedule_ssq_changed(void)
+{
+  ssq_dirty = 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Same as earlier_ssq_schedule_list, with the earliest entry cached
+ * until ssq_schedule_list changes */
+static uint8_t
+index_earlier_ssq(uint16_t *time_to_orig_schedule, struct tsch_link **link)
+{
+  struct ssq_schedule_t *e;
+  uint64_t curr_ASN = (uint64_t)(tsch_current_asn.ls4b) + ((uint64_t)(tsch_current_asn.ms1b) << 32);
+  uint64_t earliest_ASN = 0;
+  uint64_t ssq_ASN;
+  uint64_t time_to_earliest;
+  uint8_t i;
+
+  if(ssq_earliest >= 0 &&
+     ssq_schedule_list[ssq_earliest].asn.ls4b == 0 &&
+     ssq_schedule_list[ssq_earliest].asn.ms1b == 0) {
+    ssq_dirty = 1;
+  }
+  if(ssq_dirty) {
+    ssq_dirty = 0;
+    ssq_earliest = -1;
+    for(i = 0; i < 16; i++) {
+      if(ssq_schedule_list[i].asn.ls4b != 0 || ssq_schedule_list[i].asn.ms1b != 0) {
+        ssq_ASN = (uint64_t)(ssq_schedule_list[i].asn.ls4b) + ((uint64_t)(ssq_schedule_list[i].asn.ms1b) << 32);
+        if(ssq_earliest < 0 || ssq_ASN < earliest_ASN) {
+          earliest_ASN = ssq_ASN;
+          ssq_earliest = i;
+        }
+      }
+    }
+  }
+  if(ssq_earliest < 0) {
+    /* No pending ssq schedule */
+    return 0;
+  }
+
+  e = &ssq_schedule_list[ssq_earliest];
+  earliest_ASN = (uint64_t)(e->asn.ls4b) + ((uint64_t)(e->asn.ms1b) << 32);
+  if(earliest_ASN <= curr_ASN) {
+    /* Drop the first stale entry, as earlier_ssq_schedule_list does */
+    for(i = 0; i < 16; i++) {
+      ssq_ASN = (uint64_t)(ssq_schedule_list[i].asn.ls4b) + ((uint64_t)(ssq_schedule_list[i].asn.ms1b) << 32);
+      if(ssq_ASN != 0 && ssq_ASN <= curr_ASN) {
+        e = &ssq_schedule_list[i];
+        break;
+      }
+    }
+    printf("ERROR: ssq_ASN(%x.%lx) <= curr_ASN(%x.%lx)\n",
+      e->asn.ms1b, (unsigned long)e->asn.ls4b,
+      tsch_current_asn.ms1b, (unsigned long)tsch_current_asn.ls4b);
+    e->asn.ls4b = 0;
+    e->asn.ms1b = 0;
+    ssq_dirty = 1;
+    return 0;
+  }
+
+  time_to_earliest = earliest_ASN - curr_ASN;
+  if(time_to_earliest < *time_to_orig_schedule) {
+    PRINTF("Earlier ssq exists %u\n", (uint16_t)time_to_earliest);
+    *time_to_orig_schedule = (uint16_t)time_to_earliest;
+    *link = &e->link;
+    return 1;
+  } else if(time_to_earliest == *time_to_orig_schedule) {
+    e->asn.ms1b = 0;
+    e->asn.ls4b = 0;
+    ssq_dirty = 1;
+  }
+  return 0;
+}
+#endif /* PROPOSED && RESIDUAL_ALLOC */
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
@@ -545,6 +1342,9 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
   no outgoing packet in queue. In that case, run the backup link instead. The backup link
   must have Rx flag set. */
   if(!tsch_is_locked()) {
+#if TSCH_SCHEDULE_WITH_INDEX
+    curr_best = index_get_next_active_link(asn, &time_to_curr_best, &curr_backup);
+#else /* TSCH_SCHEDULE_WITH_INDEX */
     struct tsch_slotframe *sf = list_head(slotframe_list);
     /* For each slotframe, look for the earliest occurring link */
     while(sf != NULL) {
@@ -561,152 +1361,14 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
           curr_best = l;
           curr_backup = NULL;
         } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle < curr_best->slotframe_handle) {
-              new_best = l;
-            }
-#if PROPOSED
-            if( (curr_best->slotframe_handle==1) && (curr_best->link_options & LINK_OPTION_TX) &&  (l->slotframe_handle==2) )
-            { //Prevent Autonomous unicast Tx from interfere Autonomous broadcast Tx/Rx (They share the same c_offset in PROPOSED) 
-              //Prioritize Autonomous broadcast Tx/Rx to Autonomous unicast Tx
-              //printf("AU Tx < AB\n");
-              new_best = l;
-            }
-#endif
-
-#if TESLA
-            if( ((curr_best->link_options & LINK_OPTION_TX)==1) && ((l->link_options & LINK_OPTION_TX)==1) //Both Tx option
-                && (curr_best->slotframe_handle > 3) && (l->slotframe_handle > 3) //Both tx_sf //NOTE1
-            ) {
-
-              uint16_t id_curr_best=curr_best->slotframe_handle - 3; //NOTE1
-              uint16_t id_l=l->slotframe_handle-3; //NOTE1
-              struct tsch_neighbor *n_curr_best = tsch_queue_get_nbr_from_id(id_curr_best); //NOTE1
-              struct tsch_neighbor *n_l= tsch_queue_get_nbr_from_id(id_l);//NOTE1
-
-              uint8_t q_num_curr_best;
-              uint8_t q_num_l;
-
-              //printf("Tx link overlap: ID %u %u\n",id_curr_best,id_l);
-
-              if(n_curr_best==NULL)
-              {
-                q_num_curr_best=0; //child and queue is empty
-              }
-              else
-              {
-                q_num_curr_best=ringbufindex_elements(&n_curr_best->tx_ringbuf);
-              }
-
-              if(n_l==NULL)
-              {
-                q_num_l=0; //child and queue is empty
-              }
-              else
-              {
-                q_num_l=ringbufindex_elements(&n_l->tx_ringbuf);
-              }
-
-              //printf("Tx link overlap: Queue size %u %u\n",q_num_curr_best,q_num_l);
-              if(q_num_l>q_num_curr_best)
-              {
-                new_best = l;
-              }
-              else
-              {
-                new_best=curr_best;
-              }
-
-            }
-#endif
-            
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-//#if TESLA
-          //Give the highest priority to EB (even if rx link)
-          if(l->slotframe_handle==0)
-          {
-            new_best = l;
-          }
-          else if(curr_best->slotframe_handle==0)
-          {
-            new_best = curr_best;
-          }
-//#endif
-
-          /* Maintain backup_link */
-          if(curr_backup == NULL) {
-            /* Check if 'l' best can be used as backup */
-            if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-              curr_backup = l;
-            }
-            /* Check if curr_best can be used as backup */
-            if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-              curr_backup = curr_best;
-            }
-          }
-          
-#if TESLA
-          else{ //curr_backup!=NULL   //backup link update
-
-            if(l!=NULL)
-            {
-
-              if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-
-                  if(curr_backup->slotframe_handle > l->slotframe_handle)
-                  {
-                    //printf("Backup link update 1\n");
-                    curr_backup = l;
-                  }
-
-              }
-            }
-            else
-            {
-              //printf("l=NULL!\n");
-            }
-
-            if(curr_best!=NULL){
-              /* Check if curr_best can be used as backup */
-              if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-                
-                  if(curr_backup->slotframe_handle > curr_best->slotframe_handle)
-                  {
-                    //printf("Backup link update 2\n");
-                    curr_backup = curr_best;
-                  }
-              }
-            }
-            else
-            {
-              //printf("curr_best=NULL!\n");
-            }
-
-
-          }
-#endif
-
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
+          select_overlapping_link(&curr_best, &curr_backup, l);
         }
 
         l = list_item_next(l);
       }
       sf = list_item_next(sf);
     }
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 
     if(time_offset != NULL) {
       *time_offset = time_to_curr_best;
@@ -717,7 +1379,11 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
 #if PROPOSED && RESIDUAL_ALLOC
     struct tsch_link * ssq_link =NULL;
     uint16_t new_time_offset=*time_offset; //initialize
+#if TSCH_SCHEDULE_WITH_INDEX
+    if(index_earlier_ssq(&new_time_offset,&ssq_link))
+#else
     if(earlier_ssq_schedule_list(&new_time_offset,&ssq_link))
+#endif
     {
       if(ssq_link!=NULL)
       {
@@ -745,6 +1411,58 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
   return curr_best;
 }
 /*---------------------------------------------------------------------------*/
+#if TSCH_SCHEDULE_BATCH
+/* Start a group of schedule updates */
+void
+tsch_schedule_begin(void)
+{
+  staged_depth++;
+}
+/*---------------------------------------------------------------------------*/
+/* End a group of schedule updates */
+void
+tsch_schedule_commit(void)
+{
+  if(staged_depth > 0 && --staged_depth == 0) {
+    staged_committed = staged_count;
+    staged_try_apply();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Apply the committed updates. Called by slot operation between slots */
+void
+tsch_schedule_apply_staged(void)
+{
+  if(staged_applied != staged_committed && !tsch_is_locked()) {
+    staged_apply();
+    /* Free the removed slotframes and links from process context */
+    process_poll(&tsch_pending_events_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Free the slotframes and links removed by applied updates */
+void
+tsch_schedule_process_pending(void)
+{
+  struct staged_op *op;
+  struct tsch_link *l;
+  uint8_t applied = staged_applied;
+
+  while(staged_reclaimed != applied) {
+    op = STAGED_OP(staged_reclaimed);
+    if(op->type == STAGED_REMOVE_SLOTFRAME) {
+      while((l = list_pop(op->sf->links_list)) != NULL) {
+        staged_free_link(l);
+      }
+      memb_free(&slotframe_memb, op->sf);
+    } else if(op->type == STAGED_REMOVE_LINK) {
+      staged_free_link(op->l);
+    }
+    staged_reclaimed++;
+  }
+}
+#endif /* TSCH_SCHEDULE_BATCH */
+/*---------------------------------------------------------------------------*/
 /* Module initialization, call only once at startup. Returns 1 is success, 0 if failure. */
 int
 tsch_schedule_init(void)
@@ -753,6 +1471,10 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_BATCH
+    staged_reclaimed = staged_applied = staged_committed = staged_count = 0;
+    staged_depth = 0;
+#endif /* TSCH_SCHEDULE_BATCH */
     tsch_release_lock();
     return 1;
   } else {
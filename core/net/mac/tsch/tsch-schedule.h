@@ -72,6 +72,33 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Index the schedule for tsch_schedule_get_next_active_link. The index
+ * is rebuilt when the schedule changes, and finds the next link in
+ * O(log n) of the number of slotframes instead of scanning every link */
+#ifdef TSCH_SCHEDULE_CONF_WITH_INDEX
+#define TSCH_SCHEDULE_WITH_INDEX TSCH_SCHEDULE_CONF_WITH_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_INDEX 0
+#endif
+
+/* Stage slotframe and link additions and removals instead of taking the
+ * TSCH lock for each of them. Staged updates are applied by slot
+ * operation at the end of a slot, or right away when no slot is in
+ * progress. tsch_schedule_begin() and tsch_schedule_commit() group
+ * updates so that they are applied together */
+#ifdef TSCH_SCHEDULE_CONF_BATCH
+#define TSCH_SCHEDULE_BATCH TSCH_SCHEDULE_CONF_BATCH
+#else
+#define TSCH_SCHEDULE_BATCH 0
+#endif
+
+/* Max number of staged updates not yet freed. Must be a power of two */
+#ifdef TSCH_SCHEDULE_CONF_BATCH_SIZE
+#define TSCH_SCHEDULE_BATCH_SIZE TSCH_SCHEDULE_CONF_BATCH_SIZE
+#else
+#define TSCH_SCHEDULE_BATCH_SIZE 16
+#endif
+
 /********** Constants *********/
 
 /* Link options */
@@ -160,6 +187,8 @@ struct tsch_link *tsch_schedule_add_link(struct tsch_slotframe *slotframe,
 struct tsch_link *tsch_schedule_get_link_by_handle(uint16_t handle);
 /* Looks within a slotframe for a link with a given timeslot */
 struct tsch_link *tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe, uint16_t timeslot);
+/* Returns the first link of a slotframe, including staged links */
+struct tsch_link *tsch_schedule_get_link_head(struct tsch_slotframe *slotframe);
 /* Removes a link. Return 1 if success, 0 if failure */
 int tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l);
 /* Removes a link from slotframe and timeslot. Return a 1 if success, 0 if failure */
@@ -177,6 +206,30 @@ int tsch_schedule_change_slotframe_link_handle(struct tsch_slotframe *slotframe,
 void tsch_schedule_print_proposed(void);
 struct tsch_slotframe * tsch_schedule_get_slotframe_head(void);
 uint16_t tsch_schedule_get_subsequent_schedule(struct tsch_asn_t *asn);
+#if RESIDUAL_ALLOC && TSCH_SCHEDULE_WITH_INDEX
+/* Must be called after any change to ssq_schedule_list */
+void tsch_schedule_ssq_changed(void);
+#else
+#define tsch_schedule_ssq_changed()
+#endif
 #endif
 
+#if TSCH_SCHEDULE_BATCH
+/* Start a group of schedule updates. They are staged until the matching
+ * tsch_schedule_commit(). Calls may nest */
+void tsch_schedule_begin(void);
+/* End a group of schedule updates. They are applied now if no slot is in
+ * progress, else by slot operation at the end of the slot */
+void tsch_schedule_commit(void);
+/* Apply the committed updates. Called by slot operation between slots */
+void tsch_schedule_apply_staged(void);
+/* Free the slotframes and links removed by applied updates */
+void tsch_schedule_process_pending(void);
+#else /* TSCH_SCHEDULE_BATCH */
+#define tsch_schedule_begin()
+#define tsch_schedule_commit()
+#define tsch_schedule_apply_staged()
+#define tsch_schedule_process_pending()
+#endif /* TSCH_SCHEDULE_BATCH */
+
 #endif /* __TSCH_SCHEDULE_H__ */
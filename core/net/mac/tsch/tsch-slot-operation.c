@@ -51,6 +51,8 @@
 #include "net/mac/tsch/tsch-queue.h"
 #include "net/mac/tsch/tsch-private.h"
 #include "net/mac/tsch/tsch-log.h"
+#include "net/mac/tsch/tsch-trace.h"
+#include "net/mac/tsch/tsch-energest.h"
 #include "net/mac/tsch/tsch-packet.h"
 #include "net/mac/tsch/tsch-security.h"
 #include "net/mac/tsch/tsch-adaptive-timesync.h"
@@ -66,6 +68,7 @@
   #include "net/ipv6/uip-ds6-nbr.h"
   #include "net/mac/tsch/tsch-schedule.h"
   #include "lib/random.h"
+  #include "lib/assert.h"
 
 #if RESIDUAL_ALLOC
   #include "net/mac/frame802154.h"
@@ -184,6 +187,10 @@ static volatile int tsch_locked = 0;
 /* As long as this is set, skip all slot operation */
 static volatile int tsch_lock_requested = 0;
 
+#if TSCH_LOCK_STATS
+struct tsch_lock_stats tsch_lock_stats;
+#endif /* TSCH_LOCK_STATS */
+
 /* Last estimated drift in RTIMER ticks
  * (Sky: 1 tick = 30.517578125 usec exactly) */
 static int32_t drift_correction = 0;
@@ -277,11 +284,15 @@ static uint16_t ratio_ss_coll_succ_over_total=0;
 //static struct ctimer reset_num_rx_timer; //JSB
 #if PROPOSED
 
-typedef struct t_offset_candidate{
-  uint8_t available;
-  uint8_t priority;
-
-} t_offset_candidate_t;
+/* Occupancy of the OST tx/rx slotframes. A slotframe of size 2^N
+   with its link at t_offset is entry (N, t_offset) of a binary tree
+   stored heap-style at index (1<<N) + t_offset. t_offset_blocked[]
+   counts, for every entry, the installed slotframes it shares a
+   timeslot with. t_offset_busy[] has the matching bit set while that
+   count is non-zero, so a free t_offset is a find-first-zero away. */
+#define T_OFFSET_INDEX(N, t_offset) ((1 << (N)) + (t_offset))
+static uint16_t t_offset_blocked[2 << N_MAX];
+static uint32_t t_offset_busy[((2 << N_MAX) + 31) / 32];
 
 static uint16_t prN_new_N;
 static uint16_t prN_new_t_offset;
@@ -409,6 +420,7 @@ remove_matching_slot(void)
       PRINTF("remove_matching_slot: ssq_schedule_list[%u]\n",i);
       ssq_schedule_list[i].asn.ls4b=0;
       ssq_schedule_list[i].asn.ms1b=0;
+      tsch_schedule_ssq_changed();
       break;
     }
 
@@ -460,6 +472,7 @@ add_matching_slot(uint16_t matching_slot, uint8_t is_tx, uint16_t nbr_id)
           ssq_schedule_list[i].link.slotframe_handle = SSQ_SCHEDULE_HANDLE_OFFSET+2*nbr_id+2;
           ssq_schedule_list[i].link.link_options = LINK_OPTION_RX;
         }
+        tsch_schedule_ssq_changed();
 
         PRINTF("add_matching_slot: ssq_schedule_list[%u] %x.%lx %u %u\n"
           , i, ssq_schedule_list[i].asn.ms1b, ssq_schedule_list[i].asn.ls4b, ssq_schedule_list[i].link.slotframe_handle, is_tx);
@@ -570,6 +583,107 @@ process_rx_matching_slot(frame802154_t* frame)
 #endif
 
 
+/* Tier of an OST slotframe, or 0 if it is not of size 2^1..2^N_MAX */
+static uint16_t
+t_offset_tier(struct tsch_slotframe *sf)
+{
+  uint16_t n;
+
+  for(n = 1; n <= N_MAX; n++) {
+    if(sf->size.val == (1 << n)) {
+      return n;
+    }
+  }
+  printf("ERROR: weird size of slotframe");
+  return 0;
+}
+
+static void
+t_offset_mark(uint16_t i, int8_t delta)
+{
+  /* A count goes out of range only if add and remove calls do not pair */
+  assert(delta > 0 ? t_offset_blocked[i] < 0xffff : t_offset_blocked[i] > 0);
+  t_offset_blocked[i] += delta;
+  if(t_offset_blocked[i] != 0) {
+    t_offset_busy[i / 32] |= (uint32_t)1 << (i % 32);
+  } else {
+    t_offset_busy[i / 32] &= ~((uint32_t)1 << (i % 32));
+  }
+}
+
+/* Add (delta 1) or remove (delta -1) an installed slotframe. It
+   blocks its ancestor in every lower tier and all its descendants in
+   every higher one. */
+static void
+t_offset_update(struct tsch_slotframe *sf, int8_t delta)
+{
+  struct tsch_link *l;
+  uint16_t used_N;
+  uint16_t used_t_offset;
+  uint16_t n;
+  uint16_t t;
+
+  if(sf == NULL || sf->handle <= 2) {
+    return;
+  }
+  l = tsch_schedule_get_link_head(sf);
+  used_N = t_offset_tier(sf);
+  if(l == NULL || used_N == 0) {
+    return;
+  }
+  used_t_offset = l->timeslot;
+  if(used_t_offset >= (1 << used_N)) {
+    printf("ERROR: used_t_offset is too big %u %u %u\n", sf->handle, used_t_offset, used_N);
+    return;
+  }
+
+  for(n = 1; n <= N_MAX; n++) {
+    if(n <= used_N) {
+      t_offset_mark(T_OFFSET_INDEX(n, used_t_offset % (1 << n)), delta);
+    } else {
+      for(t = used_t_offset; t < (1 << n); t += (1 << used_N)) {
+        t_offset_mark(T_OFFSET_INDEX(n, t), delta);
+      }
+    }
+  }
+}
+
+/* Forget all installed slotframes, when the whole schedule is removed */
+void
+reset_t_offset_occupancy(void)
+{
+  memset(t_offset_blocked, 0, sizeof(t_offset_blocked));
+  memset(t_offset_busy, 0, sizeof(t_offset_busy));
+}
+
+static uint8_t
+t_offset_is_busy(uint16_t N, uint16_t t_offset)
+{
+  uint16_t i = T_OFFSET_INDEX(N, t_offset);
+
+  return (t_offset_busy[i / 32] >> (i % 32)) & 1;
+}
+
+/* First free index in [from, to), or to if there is none */
+static uint16_t
+t_offset_first_free(uint16_t from, uint16_t to)
+{
+  uint32_t w;
+
+  while(from < to) {
+    w = ~t_offset_busy[from / 32] >> (from % 32);
+    if(w != 0) {
+      while((w & 1) == 0) {
+        w >>= 1;
+        from++;
+      }
+      return from < to ? from : to;
+    }
+    from = (from | 31) + 1;
+  }
+  return to;
+}
+
 /**************************************Rx N from Data -> Change Rx schedule *********************************/
 void 
 add_rx(uint16_t id, uint16_t N, uint16_t t_offset)
@@ -602,6 +716,10 @@ add_rx(uint16_t id, uint16_t N, uint16_t t_offset)
       {
         printf("ERROR(add_rx): add_link fail\n");
       }
+      else
+      {
+        t_offset_update(sf, 1);
+      }
 
 
     }
@@ -623,6 +741,7 @@ remove_rx(uint16_t id)
   if(rm_sf!=NULL)
   {  
     PRINTF("remove_rx: handle:%u, size:%u (nbr %u)\n",rm_sf_handle,rm_sf->size.val,id);
+    t_offset_update(rm_sf, -1);
     tsch_schedule_remove_slotframe(rm_sf);
   }
 
@@ -631,123 +750,42 @@ remove_rx(uint16_t id)
 
 
 
-void eliminate_overlap_toc(t_offset_candidate_t* toc, uint16_t target_N, uint16_t used_N, uint16_t used_t_offset)
-{
-  PRINTF("(%u,%u) ",used_N,used_t_offset);
-  if(target_N < used_N) // Lower-tier used
-  {
-    uint16_t parent_N = used_N-1;
-    uint16_t parent_t_offset = used_t_offset % (1<<(used_N-1)); 
-
-    eliminate_overlap_toc(toc,target_N,parent_N,parent_t_offset);
-  }
-  else if (target_N > used_N) // Higher-tier used
-  {
-    uint16_t child_N = used_N+1;
-    uint16_t left_child_t_offset = used_t_offset;
-    uint16_t right_child_t_offset = used_t_offset + (1<<used_N);
-
-    eliminate_overlap_toc(toc,target_N,child_N,left_child_t_offset);
-    eliminate_overlap_toc(toc,target_N,child_N,right_child_t_offset);
-
-  }
-  else // target_N == used_N
-  {
-    if(used_t_offset>=(1<<target_N))
-    {
-      printf("ERROR: used_t_offset is too big %u %u\n",used_t_offset,target_N);
-      return ;
-    }
-    toc[used_t_offset].available=0;
-  }
-
-}
-
-
 uint32_t 
 select_t_offset(uint16_t target_id, uint16_t N)  //similar with tx_installable
 {
-  t_offset_candidate_t toc[1<<N_MAX];
-
-  //Initialize 2^N toc
+  struct tsch_slotframe *own_sf;
+  uint16_t base = T_OFFSET_INDEX(N, 0);
+  uint16_t end = T_OFFSET_INDEX(N, 1 << N);
+  uint16_t start;
   uint16_t i;
-  for(i=0; i<(1<<N); i++)
-  {
-    toc[i].available=1;
-    toc[i].priority=255; //TODO
-  }
 
-  //check resource overlap
   PRINTF("\nselect_t_offset (target N=%u)\n",N);
-  
-  struct tsch_slotframe *sf = tsch_schedule_get_slotframe_head();
-  while(sf != NULL) {
-    if(sf->handle>2 && sf->handle!=get_rx_sf_handle_from_id(target_id)){
-
-      uint16_t n;
-      for(n=1;n<=N_MAX;n++)
-      {
-        if( (sf->size.val>>n) ==1)
-        {
-          uint16_t used_N=n;
-
-          struct tsch_link *l = list_head(sf->links_list);
-          if(l==NULL)
-          {
-            printf("ERROR: link is null (select_t_offset)\n");
-
-          }
-          else
-          {
 
-            uint16_t used_t_offset= l->timeslot;
-            if(used_t_offset>=(1<<used_N))
-            {
-              printf("ERROR: used_t_offset is too big (select_t_offset) %u %u %u %u\n",sf->handle,used_t_offset,used_N, target_id);
-            }
-            eliminate_overlap_toc(toc, N, used_N,used_t_offset);
-            PRINTF("\n");
-          }
-          
-        
-          break;
-        }
-        else if (n==N_MAX)
-        {
-          printf("ERROR: weird size of slotframe");
-        }
-      }
+  /* The Rx slotframe being replaced does not count as overlap */
+  own_sf = tsch_schedule_get_slotframe_by_handle(get_rx_sf_handle_from_id(target_id));
+  t_offset_update(own_sf, -1);
 
+  /* First free t_offset from a random start, wrapping around */
+  start = base + (random_rand() % (1 << N));
+  i = t_offset_first_free(start, end);
+  if(i == end) {
+    i = t_offset_first_free(base, start);
+    if(i == start) {
+      i = end;
     }
-    sf = list_item_next(sf);
   }
 
+  t_offset_update(own_sf, 1);
 
-
-  uint32_t rand= random_rand() % (1<<31);
-  uint32_t i1;
-
-  for(i=0; i<(1<<N); i++)
-  {
-    i1= (i+rand) % (1<<N);
-
-
-    if(toc[i1].available==1)
-    {
-      PRINTF("select_t_offset: %u chosen (nbr %u)\n",i1,target_id);
-
-      break;
-    }
-  }
-
-  if(i==(1<<N))  
+  if(i == end)
   {
     //printf("ERROR: select_t_offset: No available t_offset\n");
     return 65535+1;
   }
   else
   {
-    return i1;
+    PRINTF("select_t_offset: %u chosen (nbr %u)\n",i - base,target_id);
+    return i - base;
   }
   
 }
@@ -869,9 +907,11 @@ post_process_rx_N(void)
       if(prN_nbr!=NULL)
       {
         uint16_t nbr_id=ID_FROM_IPADDR(&(prN_nbr->ipaddr));
+        tsch_schedule_begin();
         remove_rx(nbr_id);
 
         add_rx(nbr_id,prN_new_N,prN_new_t_offset);
+        tsch_schedule_commit();
         printf("New Rx schedule: %u,%u (nbr %u)\n",prN_new_N,prN_new_t_offset,nbr_id);
 
         //print_nbr();
@@ -938,8 +978,10 @@ void change_queue_select_packet(uint16_t id, uint16_t handle, uint16_t timeslot)
         {
           index=j;  
         }
-        set_queuebuf_attr(n->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME, handle);
-        set_queuebuf_attr(n->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT, timeslot);
+        if(!set_queuebuf_attr(n->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME, handle)
+           || !set_queuebuf_attr(n->tx_array[index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT, timeslot)) {
+          printf("ERROR: link selector not set (index %u)\n", j);
+        }
 
         PRINTF("index: %u, %u %u\n",
           j,queuebuf_attr(n->tx_array[index]->qb,PACKETBUF_ATTR_TSCH_SLOTFRAME),queuebuf_attr(n->tx_array[index]->qb,PACKETBUF_ATTR_TSCH_TIMESLOT));
@@ -989,6 +1031,7 @@ add_tx(uint16_t id, uint16_t N, uint16_t t_offset)
         printf("ERROR(add_tx): add_link fail\n");
       }
       else{
+        t_offset_update(sf, 1);
         change_queue_select_packet(id, handle, t_offset);
       }
 
@@ -1036,6 +1079,7 @@ remove_tx(uint16_t id)
   if(rm_sf!=NULL)
   {  
     PRINTF("remove_tx: handle:%u, size:%u (nbr %u)\n",rm_sf_handle, rm_sf->size.val,id);
+    t_offset_update(rm_sf, -1);
     tsch_schedule_remove_slotframe(rm_sf);
 
     struct tsch_neighbor * n= tsch_queue_get_nbr_from_id(id);
@@ -1102,80 +1146,30 @@ tx_installable(uint16_t target_id, uint16_t N, uint16_t t_offset)  //similar wit
     return -1;
   }
 
-  t_offset_candidate_t toc[1<<N_MAX];
-
-  //Initialize 2^N toc
-  uint16_t i;
+  struct tsch_slotframe *own_sf;
+  uint8_t busy;
 
   if(t_offset==65535)
   {
     return -2;
   }
 
-  for(i=0; i<(1<<N); i++)
-  {
-    toc[i].priority=255; //TODO
-  }
-
-  if( t_offset < (1<<N) ) // For preparation of weird t_offset
-  {
-    toc[t_offset].available=1;
-  }
-  else
+  if( t_offset >= (1<<N) ) // For preparation of weird t_offset
   {
     printf("ERROR: weird t_offset %u\n",t_offset);
     return -1;
   }
 
-
   //check resource overlap
   PRINTF("\ntx_installable (target %u,%u)\n",N, t_offset);
 
-  struct tsch_slotframe *sf = tsch_schedule_get_slotframe_head();
-  while(sf != NULL) {
-    if(sf->handle>2  && sf->handle!=get_tx_sf_handle_from_id(target_id)){
+  /* The Tx slotframe being replaced does not count as overlap */
+  own_sf = tsch_schedule_get_slotframe_by_handle(get_tx_sf_handle_from_id(target_id));
+  t_offset_update(own_sf, -1);
+  busy = t_offset_is_busy(N, t_offset);
+  t_offset_update(own_sf, 1);
 
-      uint16_t n;
-      for(n=1;n<=N_MAX;n++)
-      {
-        if( (sf->size.val>>n) ==1)
-        {
-          uint16_t used_N=n;
-
-          struct tsch_link *l = list_head(sf->links_list);
-          if(l==NULL)
-          {
-            printf("ERROR: link is null (tx_installable)\n");
-
-          }
-          else
-          {
-            uint16_t used_t_offset= l->timeslot;
-            if(used_t_offset>=(1<<used_N))
-            {
-              printf("ERROR: used_t_offset is too big (tx_installable) %u %u %u %u\n",sf->handle,used_t_offset,used_N, target_id);
-            }
-            eliminate_overlap_toc(toc, N, used_N,used_t_offset);
-            PRINTF("\n");
-          }
-
-          break;
-        }
-        else if (n==N_MAX)
-        {
-          printf("ERROR: weird size of slotframe");
-        }
-      }
-
-    }
-
-    sf = list_item_next(sf);
-  }
-
-
-
-
-  if(toc[t_offset].available==1)
+  if(!busy)
   {
     PRINTF("tx_installable: %u installable\n\n",t_offset);
     return 1;
@@ -1329,6 +1323,7 @@ post_process_rx_t_offset(void)
       if(prt_nbr!=NULL)
       {
         uint16_t nbr_id=ID_FROM_IPADDR(&(prt_nbr->ipaddr));
+        tsch_schedule_begin();
         remove_tx(nbr_id);
 
         if(prt_nbr->my_uninstallable==0)
@@ -1349,6 +1344,7 @@ post_process_rx_t_offset(void)
 
           printf("Uninstallable (nbr %u)\n",nbr_id);
         }
+        tsch_schedule_commit();
 
 
         if(todo_N_update==1)
@@ -1670,6 +1666,31 @@ tsch_is_locked(void)
   return tsch_locked;
 }
 
+/* Wait for the end of current slot operation, return the time waited */
+static rtimer_clock_t
+wait_slot_operation_end(void)
+{
+  rtimer_clock_t busy_wait_time;
+
+  busy_wait_time = RTIMER_NOW();
+  while(tsch_in_slot_operation) {
+#if CONTIKI_TARGET_COOJA || CONTIKI_TARGET_COOJA_IP64
+    simProcessRunValue = 1;
+    cooja_mt_yield();
+#endif /* CONTIKI_TARGET_COOJA || CONTIKI_TARGET_COOJA_IP64 */
+  }
+  busy_wait_time = RTIMER_NOW() - busy_wait_time;
+
+#if TSCH_LOCK_STATS
+  tsch_lock_stats.busy_waits++;
+  tsch_lock_stats.wait_ticks += busy_wait_time;
+  if(busy_wait_time > tsch_lock_stats.max_wait_ticks) {
+    tsch_lock_stats.max_wait_ticks = busy_wait_time;
+  }
+#endif /* TSCH_LOCK_STATS */
+  return busy_wait_time;
+}
+
 /* Lock TSCH (no slot operation) */
 int
 tsch_get_lock(void)
@@ -1682,19 +1703,15 @@ tsch_get_lock(void)
     /* Wait for the end of current slot operation. */
     if(tsch_in_slot_operation) {
       busy_wait = 1;
-      busy_wait_time = RTIMER_NOW();
-      while(tsch_in_slot_operation) {
-#if CONTIKI_TARGET_COOJA || CONTIKI_TARGET_COOJA_IP64
-        simProcessRunValue = 1;
-        cooja_mt_yield();
-#endif /* CONTIKI_TARGET_COOJA || CONTIKI_TARGET_COOJA_IP64 */
-      }
-      busy_wait_time = RTIMER_NOW() - busy_wait_time;
+      busy_wait_time = wait_slot_operation_end();
     }
     if(!tsch_locked) {
       /* Take the lock if it is free */
       tsch_locked = 1;
       tsch_lock_requested = 0;
+#if TSCH_LOCK_STATS
+      tsch_lock_stats.locks++;
+#endif /* TSCH_LOCK_STATS */
       if(busy_wait) {
         /* Issue a log whenever we had to busy wait until getting the lock */
         TSCH_LOG_ADD(tsch_log_message,
@@ -1719,6 +1736,26 @@ tsch_release_lock(void)
   tsch_locked = 0;
 }
 
+/* Lock TSCH if no slot operation is in progress, without waiting */
+int
+tsch_try_lock(void)
+{
+  if(!tsch_locked) {
+    /* Make sure no new slot operation will start */
+    tsch_lock_requested = 1;
+    if(!tsch_in_slot_operation) {
+      tsch_locked = 1;
+      tsch_lock_requested = 0;
+#if TSCH_LOCK_STATS
+      tsch_lock_stats.locks++;
+#endif /* TSCH_LOCK_STATS */
+      return 1;
+    }
+    tsch_lock_requested = 0;
+  }
+  return 0;
+}
+
 /*---------------------------------------------------------------------------*/
 /* Channel hopping utility functions */
 
@@ -2073,6 +2110,7 @@ tsch_radio_on(enum tsch_radio_state_on_cmd command)
   }
   if(do_it) {
     NETSTACK_RADIO.on();
+    tsch_energest_radio_on();
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -2104,6 +2142,7 @@ tsch_radio_off(enum tsch_radio_state_off_cmd command)
   }
   if(do_it) {
     NETSTACK_RADIO.off();
+    tsch_energest_radio_off();
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -2159,6 +2198,7 @@ remove_reserved_ssq(uint16_t nbr_id)
         {
           ssq_schedule_list[i].asn.ls4b=0;
           ssq_schedule_list[i].asn.ms1b=0;
+          tsch_schedule_ssq_changed();
         }
       }
       
@@ -2589,6 +2629,17 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
 #endif
 
     );
+
+    TSCH_TRACE_ADD(TSCH_TRACE_TX,
+        trace->peer = TSCH_LOG_ID_FROM_LINKADDR(queuebuf_addr(current_packet->qb, PACKETBUF_ADDR_RECEIVER));
+    trace->status = mac_tx_status;
+    trace->num_tx = current_packet->transmissions;
+    trace->datalen = queuebuf_datalen(current_packet->qb);
+    trace->drift = drift_correction;
+    trace->flags = (trace->peer != 0 ? TSCH_TRACE_FLAG_UNICAST : 0)
+      | (((((uint8_t *)(queuebuf_dataptr(current_packet->qb)))[0]) & 7) == FRAME802154_DATAFRAME ? TSCH_TRACE_FLAG_DATA : 0)
+      | (is_drift_correction_used ? TSCH_TRACE_FLAG_DRIFT_USED : 0);
+    );
     
     /* Poll process for later processing of packet sent events and logs */
     process_poll(&tsch_pending_events_process);
@@ -3033,6 +3084,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 
             /* If the sender is a time source, proceed to clock drift compensation */
             n = tsch_queue_get_nbr(&source_address);
+            tsch_energest_slot_neighbor(n);
             if(n != NULL && n->is_time_source) {
               int32_t since_last_timesync = TSCH_ASN_DIFF(tsch_current_asn, last_sync_asn);
               /* Keep track of last sync time */
@@ -3069,6 +3121,14 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 #endif
 
             );
+            TSCH_TRACE_ADD(TSCH_TRACE_RX,
+              trace->peer = TSCH_LOG_ID_FROM_LINKADDR((linkaddr_t*)&frame.src_addr);
+              trace->datalen = current_input->len;
+              trace->drift = drift_correction;
+              trace->flags = (frame.fcf.ack_required ? TSCH_TRACE_FLAG_UNICAST : 0)
+                | (frame.fcf.frame_type == FRAME802154_DATAFRAME ? TSCH_TRACE_FLAG_DATA : 0)
+                | (is_drift_correction_used ? TSCH_TRACE_FLAG_DRIFT_USED : 0);
+            );
             /*TSCH_LOG_ADD(tsch_log_message,
                   snprintf(log->message, sizeof(log->message),
                   "Rx_(Succ)"));*/
@@ -3144,6 +3204,11 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
     //printf("c2\n");
     if(current_link == NULL || tsch_lock_requested) { /* Skip slot operation if there is no link
                                                           or if there is a pending request for getting the lock */
+#if TSCH_LOCK_STATS
+      if(current_link != NULL) {
+        tsch_lock_stats.skipped_slots++;
+      }
+#endif /* TSCH_LOCK_STATS */
       /* Issue a log whenever skipping a slot */
       TSCH_LOG_ADD(tsch_log_message,
                       snprintf(log->message, sizeof(log->message),
@@ -3350,12 +3415,15 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
            * 3. post tx callback
            **/
           static struct pt slot_tx_pt;
+          tsch_energest_slot_neighbor(current_neighbor);
           PT_SPAWN(&slot_operation_pt, &slot_tx_pt, tsch_tx_slot(&slot_tx_pt, t));
         } else {
           /* Listen */
           static struct pt slot_rx_pt;
           PT_SPAWN(&slot_operation_pt, &slot_rx_pt, tsch_rx_slot(&slot_rx_pt, t));
         }
+        /* Account the radio-on time of the slot */
+        tsch_energest_slot_end(current_link, current_packet != NULL);
       } // if(is_active_slot)
 
 
@@ -3402,6 +3470,8 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
           aaa=1;
         }
 
+        /* Apply the schedule updates staged during this slot */
+        tsch_schedule_apply_staged();
         /* Get next active link */
         current_link = tsch_schedule_get_next_active_link(&tsch_current_asn, &timeslot_diff, &backup_link);
         //printf("time to next slot %u\n",timeslot_diff);
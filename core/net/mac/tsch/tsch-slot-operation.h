@@ -74,6 +74,14 @@
 #define TSCH_MAX_INCOMING_PACKETS 4
 #endif
 
+/* Count the time spent busy-waiting for the TSCH lock and the slots
+ * skipped because the lock was requested, in tsch_lock_stats */
+#ifdef TSCH_CONF_LOCK_STATS
+#define TSCH_LOCK_STATS TSCH_CONF_LOCK_STATS
+#else
+#define TSCH_LOCK_STATS 0
+#endif
+
 /*********** Callbacks *********/
 
 /* Called by TSCH form interrupt after receiving a frame, enabled upper-layer to decide
@@ -93,6 +101,17 @@ struct input_packet {
   uint8_t channel; /* Channel we received the packet on */
 };
 
+#if TSCH_LOCK_STATS
+/* TSCH lock counters */
+struct tsch_lock_stats {
+  uint32_t locks; /* Lock acquisitions */
+  uint32_t busy_waits; /* Acquisitions that had to wait for the end of a slot */
+  uint32_t wait_ticks; /* Total busy-wait time, in rtimer ticks */
+  rtimer_clock_t max_wait_ticks; /* Longest busy-wait */
+  uint32_t skipped_slots; /* Active slots skipped because of a lock request */
+};
+#endif /* TSCH_LOCK_STATS */
+
 /***** External Variables *****/
 
 /* A ringbuf storing outgoing packets after they were dequeued.
@@ -103,6 +122,9 @@ extern struct tsch_packet *dequeued_array[TSCH_DEQUEUED_ARRAY_SIZE];
  * Will be processed layer by tsch_rx_process_pending */
 extern struct ringbufindex input_ringbuf;
 extern struct input_packet input_array[TSCH_MAX_INCOMING_PACKETS];
+#if TSCH_LOCK_STATS
+extern struct tsch_lock_stats tsch_lock_stats;
+#endif /* TSCH_LOCK_STATS */
 
 /********** Functions *********/
 
@@ -114,6 +136,8 @@ int tsch_is_locked(void);
 int tsch_get_lock(void);
 /* Release TSCH lock */
 void tsch_release_lock(void);
+/* Lock TSCH only if no slot operation is in progress. Returns 1 if success */
+int tsch_try_lock(void);
 /* Set global time before starting slot operation,
  * with a rtimer time and an ASN */
 void tsch_slot_operation_sync(rtimer_clock_t next_slot_start,
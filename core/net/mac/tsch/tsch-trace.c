@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Binary event trace for TSCH, filled from interrupt during
+ *         timeslot operation and drained from the TSCH pending events
+ *         process as fixed-size binary frames.
+ *
+ */
+
+#include "contiki.h"
+#include <stdio.h>
+#include "net/linkaddr.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-private.h"
+#include "net/mac/tsch/tsch-log.h"
+#include "net/mac/tsch/tsch-schedule.h"
+#include "net/mac/tsch/tsch-trace.h"
+#include "lib/ringbufindex.h"
+
+#if TSCH_TRACE_ENABLED
+
+PROCESS_NAME(tsch_pending_events_process);
+
+/* Check if TSCH_TRACE_QUEUE_LEN is a power of two fitting a ringbufindex */
+#if (TSCH_TRACE_QUEUE_LEN & (TSCH_TRACE_QUEUE_LEN - 1)) != 0 || TSCH_TRACE_QUEUE_LEN > 128
+#error TSCH_TRACE_QUEUE_LEN must be power of two, at most 128
+#endif
+static struct ringbufindex trace_ringbuf;
+static struct tsch_trace_record trace_array[TSCH_TRACE_QUEUE_LEN];
+/* Sequence number of the next record, incremented also on drops */
+static uint16_t trace_seqno;
+
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+id_from_linkaddr(const linkaddr_t *addr)
+{
+  return TSCH_LOG_ID_FROM_LINKADDR(addr);
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+put16(uint8_t *p, uint16_t v)
+{
+  p[0] = v & 0xff;
+  p[1] = v >> 8;
+  return p + 2;
+}
+/*---------------------------------------------------------------------------*/
+static void
+encode(const struct tsch_trace_record *trace, uint8_t *frame)
+{
+  uint8_t *p = frame;
+
+  *p++ = TSCH_TRACE_VERSION;
+  *p++ = trace->type;
+  p = put16(p, id_from_linkaddr(&linkaddr_node_addr));
+  p = put16(p, trace->seqno);
+  p = put16(p, trace->asn.ls4b & 0xffff);
+  p = put16(p, trace->asn.ls4b >> 16);
+  *p++ = trace->asn.ms1b;
+  p = put16(p, trace->sf_handle);
+  p = put16(p, trace->sf_size);
+  p = put16(p, trace->timeslot);
+  *p++ = trace->channel_offset;
+  p = put16(p, trace->peer);
+  *p++ = trace->status;
+  *p++ = trace->num_tx;
+  p = put16(p, (uint16_t)trace->drift);
+  *p++ = trace->datalen;
+  *p++ = trace->flags;
+}
+/*---------------------------------------------------------------------------*/
+static void
+output(const uint8_t *frame)
+{
+  int i;
+#if TSCH_TRACE_HEX
+  static const char hex[] = "0123456789abcdef";
+
+  TSCH_TRACE_WRITEB('T');
+  TSCH_TRACE_WRITEB('T');
+  TSCH_TRACE_WRITEB(':');
+  for(i = 0; i < TSCH_TRACE_FRAME_LEN; i++) {
+    TSCH_TRACE_WRITEB(hex[frame[i] >> 4]);
+    TSCH_TRACE_WRITEB(hex[frame[i] & 0x0f]);
+  }
+  TSCH_TRACE_WRITEB('\n');
+#else /* TSCH_TRACE_HEX */
+  /* SLIP-framed, with an END on both sides so that frames can be told
+   * apart from text output interleaved on the same line */
+  TSCH_TRACE_WRITEB(SLIP_END);
+  for(i = 0; i < TSCH_TRACE_FRAME_LEN; i++) {
+    if(frame[i] == SLIP_END) {
+      TSCH_TRACE_WRITEB(SLIP_ESC);
+      TSCH_TRACE_WRITEB(SLIP_ESC_END);
+    } else if(frame[i] == SLIP_ESC) {
+      TSCH_TRACE_WRITEB(SLIP_ESC);
+      TSCH_TRACE_WRITEB(SLIP_ESC_ESC);
+    } else {
+      TSCH_TRACE_WRITEB(frame[i]);
+    }
+  }
+  TSCH_TRACE_WRITEB(SLIP_END);
+#endif /* TSCH_TRACE_HEX */
+}
+/*---------------------------------------------------------------------------*/
+/* Output pending trace records */
+void
+tsch_trace_process_pending(void)
+{
+  uint8_t frame[TSCH_TRACE_FRAME_LEN];
+  int16_t trace_index;
+
+  while((trace_index = ringbufindex_peek_get(&trace_ringbuf)) != -1) {
+    encode(&trace_array[trace_index], frame);
+    /* Release the slot before the (slow) output */
+    ringbufindex_get(&trace_ringbuf);
+    output(frame);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Prepare addition of a new record, for the current ASN and link.
+ * Returns pointer to the record if success, NULL otherwise */
+struct tsch_trace_record *
+tsch_trace_prepare_add(void)
+{
+  struct tsch_trace_record *trace;
+  struct tsch_slotframe *sf;
+  int trace_index;
+
+  trace_index = ringbufindex_peek_put(&trace_ringbuf);
+  if(trace_index == -1) {
+    trace_seqno++;
+    return NULL;
+  }
+  trace = &trace_array[trace_index];
+  trace->asn = tsch_current_asn;
+  trace->seqno = trace_seqno++;
+  trace->peer = 0;
+  trace->status = 0;
+  trace->num_tx = 0;
+  trace->drift = 0;
+  trace->datalen = 0;
+  trace->flags = 0;
+  if(current_link != NULL) {
+    sf = tsch_schedule_get_slotframe_by_handle(current_link->slotframe_handle);
+    trace->sf_handle = current_link->slotframe_handle;
+    trace->sf_size = sf != NULL ? sf->size.val : 0;
+    trace->timeslot = current_link->timeslot;
+    trace->channel_offset = current_link->channel_offset;
+  } else {
+    trace->sf_handle = 0xffff;
+    trace->sf_size = 0;
+    trace->timeslot = 0;
+    trace->channel_offset = 0;
+  }
+  return trace;
+}
+/*---------------------------------------------------------------------------*/
+/* Actually add the previously prepared record */
+void
+tsch_trace_commit(void)
+{
+  ringbufindex_put(&trace_ringbuf);
+  process_poll(&tsch_pending_events_process);
+}
+/*---------------------------------------------------------------------------*/
+/* Initialize trace module */
+void
+tsch_trace_init(void)
+{
+  ringbufindex_init(&trace_ringbuf, TSCH_TRACE_QUEUE_LEN);
+  trace_seqno = 0;
+}
+
+#endif /* TSCH_TRACE_ENABLED */
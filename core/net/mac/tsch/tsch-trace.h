@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Binary event trace for TSCH. Every Tx and Rx of the slot
+ *         operation is stored from interrupt as a fixed-size record in
+ *         a ringbuf, and later drained as one binary frame per record,
+ *         without any formatting on the node. Frames are decoded on the
+ *         host with tools/tsch-trace-decode.
+ *
+ *         Frame layout, all fields little-endian (TSCH_TRACE_FRAME_LEN bytes):
+ *           0  version      1  type       2  node id    4  seqno
+ *           6  ASN (5)     11  sf handle 13  sf size   15  timeslot
+ *          17  ch. offset  18  peer id   20  status    21  num tx
+ *          22  drift       24  datalen   25  flags
+ *
+ *         With Orchestra/OST, the slotframe size and timeslot of a
+ *         per-neighbor link are 2^N and t_offset. Record sequence numbers
+ *         are incremented also for records dropped on a full ringbuf, so
+ *         that the decoder can count losses.
+ */
+
+#ifndef __TSCH_TRACE_H__
+#define __TSCH_TRACE_H__
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch-asn.h"
+
+/******** Configuration *******/
+
+/* Enable the binary trace. Independent of TSCH_LOG_LEVEL; set the log
+ * level to 1 to trace without also formatting every slot with printf */
+#ifdef TSCH_TRACE_CONF_ENABLED
+#define TSCH_TRACE_ENABLED TSCH_TRACE_CONF_ENABLED
+#else /* TSCH_TRACE_CONF_ENABLED */
+#define TSCH_TRACE_ENABLED 0
+#endif /* TSCH_TRACE_CONF_ENABLED */
+
+/* The length of the trace queue. Must be a power of two, at most 128 */
+#ifdef TSCH_TRACE_CONF_QUEUE_LEN
+#define TSCH_TRACE_QUEUE_LEN TSCH_TRACE_CONF_QUEUE_LEN
+#else /* TSCH_TRACE_CONF_QUEUE_LEN */
+#define TSCH_TRACE_QUEUE_LEN 64
+#endif /* TSCH_TRACE_CONF_QUEUE_LEN */
+
+/* Trace output format:
+ * 0: binary, each frame SLIP-framed (0xc0 ... 0xc0), for UART logs
+ * 1: one "TT:<hex>" line per frame, for line-based logs such as Cooja's */
+#ifdef TSCH_TRACE_CONF_HEX
+#define TSCH_TRACE_HEX TSCH_TRACE_CONF_HEX
+#else /* TSCH_TRACE_CONF_HEX */
+#define TSCH_TRACE_HEX 0
+#endif /* TSCH_TRACE_CONF_HEX */
+
+/* Function writing one byte of trace output */
+#ifdef TSCH_TRACE_CONF_WRITEB
+#define TSCH_TRACE_WRITEB(c) TSCH_TRACE_CONF_WRITEB(c)
+#else /* TSCH_TRACE_CONF_WRITEB */
+#define TSCH_TRACE_WRITEB(c) putchar(c)
+#endif /* TSCH_TRACE_CONF_WRITEB */
+
+/************ Types ***********/
+
+#define TSCH_TRACE_VERSION   1
+#define TSCH_TRACE_FRAME_LEN 26
+
+enum tsch_trace_type {
+  TSCH_TRACE_TX = 1,
+  TSCH_TRACE_RX = 2,
+};
+
+/* Flags of a trace record */
+#define TSCH_TRACE_FLAG_UNICAST    0x01
+#define TSCH_TRACE_FLAG_DATA       0x02
+#define TSCH_TRACE_FLAG_DRIFT_USED 0x04
+
+/* A trace record, as stored in the ringbuf */
+struct tsch_trace_record {
+  struct tsch_asn_t asn;
+  uint16_t seqno;
+  uint16_t sf_handle;
+  uint16_t sf_size;
+  uint16_t timeslot;
+  uint16_t peer;
+  int16_t drift;
+  uint8_t channel_offset;
+  uint8_t type;
+  uint8_t status;
+  uint8_t num_tx;
+  uint8_t datalen;
+  uint8_t flags;
+};
+
+#if TSCH_TRACE_ENABLED
+
+/********** Functions *********/
+
+/* Prepare addition of a new record, for the current ASN and link.
+ * Returns pointer to the record if success, NULL otherwise */
+struct tsch_trace_record *tsch_trace_prepare_add(void);
+/* Actually add the previously prepared record */
+void tsch_trace_commit(void);
+/* Initialize trace module */
+void tsch_trace_init(void);
+/* Output pending trace records */
+void tsch_trace_process_pending(void);
+
+/************ Macros **********/
+
+/* Use this macro to add a record to the trace (will be output
+ * later, after leaving interrupt context) */
+#define TSCH_TRACE_ADD(trace_type, init_code) do { \
+    struct tsch_trace_record *trace = tsch_trace_prepare_add(); \
+    if(trace != NULL) { \
+      trace->type = (trace_type); \
+      init_code; \
+      tsch_trace_commit(); \
+    } \
+} while(0);
+
+#else /* TSCH_TRACE_ENABLED */
+
+#define tsch_trace_init()
+#define tsch_trace_process_pending()
+#define TSCH_TRACE_ADD(trace_type, init_code)
+
+#endif /* TSCH_TRACE_ENABLED */
+
+#endif /* __TSCH_TRACE_H__ */
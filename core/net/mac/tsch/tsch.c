@@ -52,6 +52,8 @@
 #include "net/mac/tsch/tsch-queue.h"
 #include "net/mac/tsch/tsch-private.h"
 #include "net/mac/tsch/tsch-log.h"
+#include "net/mac/tsch/tsch-trace.h"
+#include "net/mac/tsch/tsch-energest.h"
 #include "net/mac/tsch/tsch-packet.h"
 #include "net/mac/tsch/tsch-security.h"
 #include "net/mac/mac-sequence.h"
@@ -896,9 +898,10 @@ PROCESS_THREAD(tsch_pending_events_process, ev, data)
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
     tsch_log_process_pending();
+    tsch_trace_process_pending();
     tsch_rx_process_pending();
     tsch_tx_process_pending();
-    
+    tsch_schedule_process_pending();
   }
   PROCESS_END();
 }
@@ -964,6 +967,8 @@ tsch_init(void)
   tsch_queue_init();
   tsch_schedule_init();
   tsch_log_init();
+  tsch_trace_init();
+  tsch_energest_init();
   ringbufindex_init(&input_ringbuf, TSCH_MAX_INCOMING_PACKETS);
   ringbufindex_init(&dequeued_ringbuf, TSCH_DEQUEUED_ARRAY_SIZE);
 
@@ -1106,6 +1111,7 @@ turn_on(void)
   if(tsch_is_initialized == 1 && tsch_is_started == 0) {
     tsch_is_started = 1;
     /* Process tx/rx callback and log messages whenever polled */
+    process_set_priority(&tsch_pending_events_process, PROCESS_PRIORITY_HIGH);
     process_start(&tsch_pending_events_process, NULL);
     /* periodically send TSCH EBs */
     process_start(&tsch_send_eb_process, NULL);
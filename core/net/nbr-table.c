@@ -83,6 +83,17 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_HASH
+/* Open-addressing (linear probing) index over the keys on nbr_table_keys.
+ * A slot holds the neighbor index + 1, 0 marks an empty slot. */
+#if NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t nbr_table_slot_t;
+#else
+typedef uint16_t nbr_table_slot_t;
+#endif
+static nbr_table_slot_t key_hash[NBR_TABLE_HASH_SIZE];
+#endif /* NBR_TABLE_WITH_HASH */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -126,16 +137,101 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_WITH_HASH
+/* Get the home slot of a link-layer address */
+static unsigned
+hash_from_lladdr(const linkaddr_t *lladdr)
+{
+  unsigned h = 0;
+  int i;
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = (h << 5) - h + lladdr->u8[i];
+  }
+  return h & (NBR_TABLE_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Get the slot holding a link-layer address, or the empty slot ending its
+ * probe sequence. There are more slots than keys, so there always is one;
+ * returns NBR_TABLE_HASH_SIZE should the index be full all the same. */
+static unsigned
+slot_from_lladdr(const linkaddr_t *lladdr)
+{
+  unsigned slot = hash_from_lladdr(lladdr);
+  unsigned probes;
+  for(probes = 0; probes < NBR_TABLE_HASH_SIZE; probes++) {
+    if(key_hash[slot] == 0
+       || linkaddr_cmp(lladdr, &key_from_index(key_hash[slot] - 1)->lladdr)) {
+      return slot;
+    }
+    slot = (slot + 1) & (NBR_TABLE_HASH_SIZE - 1);
+  }
+  return NBR_TABLE_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a key to the hash index */
+static void
+hash_add(nbr_table_key_t *key)
+{
+  unsigned slot = slot_from_lladdr(&key->lladdr);
+  if(slot < NBR_TABLE_HASH_SIZE) {
+    key_hash[slot] = index_from_key(key) + 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the hash index. The following entries of the probe
+ * sequence are shifted back so that no tombstones are needed. */
+static void
+hash_remove(nbr_table_key_t *key)
+{
+  unsigned hole;
+  unsigned slot;
+  unsigned home;
+
+  hole = slot_from_lladdr(&key->lladdr);
+  if(hole == NBR_TABLE_HASH_SIZE || key_hash[hole] == 0) {
+    return;
+  }
+  slot = hole;
+  while(1) {
+    slot = (slot + 1) & (NBR_TABLE_HASH_SIZE - 1);
+    if(slot == hole) {
+      break;
+    }
+    if(key_hash[slot] == 0) {
+      break;
+    }
+    home = hash_from_lladdr(&key_from_index(key_hash[slot] - 1)->lladdr);
+    /* Move the entry into the hole unless its home slot lies
+     * cyclically in (hole, slot] */
+    if((slot > hole && (home <= hole || home > slot))
+       || (slot < hole && (home <= hole && home > slot))) {
+      key_hash[hole] = key_hash[slot];
+      hole = slot;
+    }
+  }
+  key_hash[hole] = 0;
+}
+#endif /* NBR_TABLE_WITH_HASH */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_WITH_HASH
+  unsigned slot;
+#else /* NBR_TABLE_WITH_HASH */
   nbr_table_key_t *key;
+#endif /* NBR_TABLE_WITH_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_HASH
+  slot = slot_from_lladdr(lladdr);
+  return slot < NBR_TABLE_HASH_SIZE && key_hash[slot] != 0 ?
+    key_hash[slot] - 1 : -1;
+#else /* NBR_TABLE_WITH_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -144,6 +240,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     key = list_item_next(key);
   }
   return -1;
+#endif /* NBR_TABLE_WITH_HASH */
 }
 /*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
@@ -195,6 +292,9 @@ remove_key(nbr_table_key_t *least_used_key)
   used_map[index_from_key(least_used_key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
+#if NBR_TABLE_WITH_HASH
+  hash_remove(least_used_key);
+#endif /* NBR_TABLE_WITH_HASH */
 }
 /*---------------------------------------------------------------------------*/
 static nbr_table_key_t *
@@ -359,6 +459,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_HASH
+    hash_add(key);
+#endif /* NBR_TABLE_WITH_HASH */
   }
 
   /* Get item in the current table */
@@ -446,11 +549,17 @@ nbr_table_update_lladdr(const linkaddr_t *old_addr, const linkaddr_t *new_addr,
     return 0;
   }
   key = key_from_index(index);
+#if NBR_TABLE_WITH_HASH
+  hash_remove(key);
+#endif /* NBR_TABLE_WITH_HASH */
   /**
    * Copy the new lladdr into the key - since we know that there is no
    * conflicting entry.
    */
   memcpy(&key->lladdr, new_addr, sizeof(linkaddr_t));
+#if NBR_TABLE_WITH_HASH
+  hash_add(key);
+#endif /* NBR_TABLE_WITH_HASH */
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -46,6 +46,39 @@
 #define NBR_TABLE_MAX_NEIGHBORS 8
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
 
+/* Index the neighbor keys with an open-addressing hash table instead of
+ * walking the key list on every lookup. Costs one or two bytes of RAM per
+ * hash slot, worth it with large neighbor tables. */
+#ifdef NBR_TABLE_CONF_WITH_HASH
+#define NBR_TABLE_WITH_HASH NBR_TABLE_CONF_WITH_HASH
+#else /* NBR_TABLE_CONF_WITH_HASH */
+#define NBR_TABLE_WITH_HASH 0
+#endif /* NBR_TABLE_CONF_WITH_HASH */
+
+/* Smallest power of two that is at least x, for 0 < x <= 65536 */
+#define NBR_TABLE_POW2_1(x) ((x) | ((x) >> 1))
+#define NBR_TABLE_POW2_2(x) (NBR_TABLE_POW2_1(x) | (NBR_TABLE_POW2_1(x) >> 2))
+#define NBR_TABLE_POW2_4(x) (NBR_TABLE_POW2_2(x) | (NBR_TABLE_POW2_2(x) >> 4))
+#define NBR_TABLE_POW2_8(x) (NBR_TABLE_POW2_4(x) | (NBR_TABLE_POW2_4(x) >> 8))
+#define NBR_TABLE_POW2(x) (NBR_TABLE_POW2_8((x) - 1) + 1)
+
+/* Number of hash slots, a power of two at least twice the table size */
+#ifdef NBR_TABLE_CONF_HASH_SIZE
+#define NBR_TABLE_HASH_SIZE NBR_TABLE_CONF_HASH_SIZE
+#else
+#define NBR_TABLE_HASH_SIZE NBR_TABLE_POW2(2 * NBR_TABLE_MAX_NEIGHBORS)
+#endif
+
+#if NBR_TABLE_WITH_HASH
+/* Linear probing needs an empty slot to end every probe sequence */
+#if NBR_TABLE_HASH_SIZE <= NBR_TABLE_MAX_NEIGHBORS
+#error "NBR_TABLE_CONF_HASH_SIZE must be larger than NBR_TABLE_CONF_MAX_NEIGHBORS"
+#endif
+#if (NBR_TABLE_HASH_SIZE & (NBR_TABLE_HASH_SIZE - 1)) != 0
+#error "NBR_TABLE_CONF_HASH_SIZE must be a power of two"
+#endif
+#endif /* NBR_TABLE_WITH_HASH */
+
 /* An item in a neighbor table */
 typedef void nbr_table_item_t;
 
@@ -70,6 +70,65 @@ struct queuebuf {
 #endif
 };
 
+#if QUEUEBUF_COMPACT
+/* The header of a queuebuf data chunk. It is followed by the values
+   of the attributes that are stored, the addresses, the types of the
+   attributes and finally the data itself. The values come first so that
+   they and the addresses are aligned. A chunk never moves or changes its
+   layout once allocated, as the MAC may be transmitting from it. */
+struct queuebuf_data {
+  uint16_t len;
+  uint8_t slab;
+  uint8_t num_attrs;
+  uint8_t max_attrs;
+};
+
+#define CHUNK_SIZE(max_attrs, len) \
+  ((max_attrs) * (sizeof(packetbuf_attr_t) + 1) + \
+   PACKETBUF_NUM_ADDRS * sizeof(linkaddr_t) + (len) + QUEUEBUF_TAILROOM)
+#define LARGE_SIZE CHUNK_SIZE(PACKETBUF_NUM_ATTRS, PACKETBUF_SIZE)
+/* Room for num_attrs attributes, plus some to set later on */
+#define WITH_ATTR_ROOM(num_attrs) \
+  MIN((num_attrs) + QUEUEBUF_ATTR_ROOM, PACKETBUF_NUM_ATTRS)
+
+struct small_chunk {
+  struct queuebuf_data hdr;
+  uint8_t bytes[QUEUEBUF_SMALL_SIZE];
+};
+struct medium_chunk {
+  struct queuebuf_data hdr;
+  uint8_t bytes[QUEUEBUF_MEDIUM_SIZE];
+};
+struct large_chunk {
+  struct queuebuf_data hdr;
+  uint8_t bytes[LARGE_SIZE];
+};
+
+#if QUEUEBUF_SMALL_NUM > 0
+MEMB(smallmem, struct small_chunk, QUEUEBUF_SMALL_NUM);
+#endif
+#if QUEUEBUF_MEDIUM_NUM > 0
+MEMB(mediummem, struct medium_chunk, QUEUEBUF_MEDIUM_NUM);
+#endif
+MEMB(largemem, struct large_chunk, QUEUEBUF_LARGE_NUM);
+
+/* The size classes, smallest first */
+static struct memb *const slabs[] = {
+#if QUEUEBUF_SMALL_NUM > 0
+  &smallmem,
+#endif
+#if QUEUEBUF_MEDIUM_NUM > 0
+  &mediummem,
+#endif
+  &largemem,
+};
+#define NUM_SLABS (sizeof(slabs) / sizeof(slabs[0]))
+
+#define ATTR_VALS(d)  ((packetbuf_attr_t *)((d) + 1))
+#define ADDRS(d)      ((linkaddr_t *)&ATTR_VALS(d)[(d)->max_attrs])
+#define ATTR_TYPES(d) ((uint8_t *)&ADDRS(d)[PACKETBUF_NUM_ADDRS])
+#define DATA(d)       (&ATTR_TYPES(d)[(d)->max_attrs])
+#else /* QUEUEBUF_COMPACT */
 /* The actual queuebuf data */
 struct queuebuf_data {
   uint8_t data[PACKETBUF_SIZE];
@@ -78,8 +137,10 @@ struct queuebuf_data {
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
-MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
 MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
+#endif /* QUEUEBUF_COMPACT */
+
+MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
 
 #if WITH_SWAP
 
@@ -134,6 +195,126 @@ LIST(queuebuf_list);
 uint8_t queuebuf_len, queuebuf_max_len;
 #endif /* QUEUEBUF_STATS */
 
+#if QUEUEBUF_COMPACT
+/*---------------------------------------------------------------------------*/
+/* Allocates a chunk from the smallest size class that has one free
+   and is large enough */
+static struct queuebuf_data *
+chunk_alloc(uint8_t max_attrs, uint16_t len)
+{
+  struct queuebuf_data *d;
+  uint16_t size;
+  uint8_t i;
+
+  size = CHUNK_SIZE(max_attrs, len);
+  for(i = 0; i < NUM_SLABS; i++) {
+    if(slabs[i]->size - sizeof(struct queuebuf_data) >= size) {
+      d = memb_alloc(slabs[i]);
+      if(d != NULL) {
+        d->slab = i;
+        d->len = len;
+        d->num_attrs = 0;
+        d->max_attrs = max_attrs;
+        return d;
+      }
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+chunk_free(struct queuebuf_data *d)
+{
+  memb_free(slabs[d->slab], d);
+}
+/*---------------------------------------------------------------------------*/
+/* Attributes that are set on packets already queued, such as the TSCH
+   link selector. They are stored even when zero, so that setting them
+   never needs more room than the queuebuf got when it was created. */
+static int
+attr_is_reserved(uint8_t type)
+{
+#if TSCH_WITH_LINK_SELECTOR
+  return type == PACKETBUF_ATTR_TSCH_SLOTFRAME
+    || type == PACKETBUF_ATTR_TSCH_TIMESLOT;
+#else /* TSCH_WITH_LINK_SELECTOR */
+  return 0;
+#endif /* TSCH_WITH_LINK_SELECTOR */
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+packetbuf_num_attrs(void)
+{
+  uint8_t type;
+  uint8_t n;
+
+  n = 0;
+  for(type = 0; type < PACKETBUF_NUM_ATTRS; type++) {
+    if(packetbuf_attr(type) != 0 || attr_is_reserved(type)) {
+      n++;
+    }
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* Stores the attributes of the packetbuf that are not zero or are
+   reserved, and its addresses. The chunk must have room for them. */
+static void
+chunk_store_attrs(struct queuebuf_data *d)
+{
+  uint8_t type;
+  uint8_t i;
+
+  d->num_attrs = 0;
+  for(type = 0; type < PACKETBUF_NUM_ATTRS; type++) {
+    if(packetbuf_attr(type) != 0 || attr_is_reserved(type)) {
+      ATTR_VALS(d)[d->num_attrs] = packetbuf_attr(type);
+      ATTR_TYPES(d)[d->num_attrs] = type;
+      d->num_attrs++;
+    }
+  }
+  for(i = 0; i < PACKETBUF_NUM_ADDRS; i++) {
+    linkaddr_copy(&ADDRS(d)[i], packetbuf_addr(PACKETBUF_ADDR_FIRST + i));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Copies the packetbuf attributes, and data if len is not negative,
+   into a queuebuf. The chunk is not grown or moved: returns 0 and
+   leaves the queuebuf as it was if it has no room for them. */
+static int
+queuebuf_store(struct queuebuf *b, int len)
+{
+  struct queuebuf_data *d;
+
+  d = b->ram_ptr;
+  if(len < 0) {
+    len = d->len;
+  }
+  if(packetbuf_num_attrs() > d->max_attrs ||
+     CHUNK_SIZE(d->max_attrs, len) >
+     slabs[d->slab]->size - sizeof(struct queuebuf_data)) {
+    PRINTF("queuebuf: no room to update queuebuf data\n");
+    return 0;
+  }
+  d->len = len;
+  chunk_store_attrs(d);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+find_attr(struct queuebuf_data *d, uint8_t type)
+{
+  uint8_t i;
+
+  for(i = 0; i < d->num_attrs; i++) {
+    if(ATTR_TYPES(d)[i] == type) {
+      return i;
+    }
+  }
+  return -1;
+}
+#endif /* QUEUEBUF_COMPACT */
+
 #if WITH_SWAP
 /*---------------------------------------------------------------------------*/
 static void
@@ -279,6 +460,9 @@ queuebuf_load_to_ram(struct queuebuf *b)
 void
 queuebuf_init(void)
 {
+#if QUEUEBUF_COMPACT
+  uint8_t i;
+#endif /* QUEUEBUF_COMPACT */
 #if WITH_SWAP
   int i;
   for(i=0; i<NQBUF_FILES; i++) {
@@ -286,7 +470,13 @@ queuebuf_init(void)
     qbuf_renew_file(i);
   }
 #endif
+#if QUEUEBUF_COMPACT
+  for(i = 0; i < NUM_SLABS; i++) {
+    memb_init(slabs[i]);
+  }
+#else /* QUEUEBUF_COMPACT */
   memb_init(&buframmem);
+#endif /* QUEUEBUF_COMPACT */
   memb_init(&bufmem);
 #if QUEUEBUF_STATS
   queuebuf_max_len = 0;
@@ -318,7 +508,12 @@ queuebuf_new_from_packetbuf(void)
     buf->line = line;
     buf->time = clock_time();
 #endif /* QUEUEBUF_DEBUG */
+#if QUEUEBUF_COMPACT
+    buf->ram_ptr = chunk_alloc(WITH_ATTR_ROOM(packetbuf_num_attrs()),
+                               packetbuf_totlen());
+#else /* QUEUEBUF_COMPACT */
     buf->ram_ptr = memb_alloc(&buframmem);
+#endif /* QUEUEBUF_COMPACT */
 #if WITH_SWAP
     /* If the allocation failed, store the qbuf in swap files */
     if(buf->ram_ptr != NULL) {
@@ -339,8 +534,13 @@ queuebuf_new_from_packetbuf(void)
     buframptr = buf->ram_ptr;
 #endif
 
+#if QUEUEBUF_COMPACT
+    packetbuf_copyto(DATA(buframptr));
+    chunk_store_attrs(buframptr);
+#else /* QUEUEBUF_COMPACT */
     buframptr->len = packetbuf_copyto(buframptr->data);
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+#endif /* QUEUEBUF_COMPACT */
 
 #if WITH_SWAP
     if(buf->location == IN_CFS) {
@@ -366,29 +566,43 @@ queuebuf_new_from_packetbuf(void)
   return buf;
 }
 /*---------------------------------------------------------------------------*/
-void
+int
 queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 {
+#if QUEUEBUF_COMPACT
+  return queuebuf_store(buf, -1);
+#else /* QUEUEBUF_COMPACT */
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
-    queuebuf_flush_tmpdata();
+    return queuebuf_flush_tmpdata() != -1;
   }
 #endif
+  return 1;
+#endif /* QUEUEBUF_COMPACT */
 }
 /*---------------------------------------------------------------------------*/
-void
+int
 queuebuf_update_from_packetbuf(struct queuebuf *buf)
 {
+#if QUEUEBUF_COMPACT
+  if(!queuebuf_store(buf, packetbuf_totlen())) {
+    return 0;
+  }
+  packetbuf_copyto(DATA(buf->ram_ptr));
+  return 1;
+#else /* QUEUEBUF_COMPACT */
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
   buframptr->len = packetbuf_copyto(buframptr->data);
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
-    queuebuf_flush_tmpdata();
+    return queuebuf_flush_tmpdata() != -1;
   }
 #endif
+  return 1;
+#endif /* QUEUEBUF_COMPACT */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -401,6 +615,8 @@ queuebuf_free(struct queuebuf *buf)
     } else {
       queuebuf_remove_from_file(buf->swap_id);
     }
+#elif QUEUEBUF_COMPACT
+    chunk_free(buf->ram_ptr);
 #else
     memb_free(&buframmem, buf->ram_ptr);
 #endif
@@ -420,8 +636,21 @@ queuebuf_to_packetbuf(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if QUEUEBUF_COMPACT
+    uint8_t i;
+
+    /* Clears the attributes, only those that are set need restoring */
+    packetbuf_copyfrom(DATA(buframptr), buframptr->len);
+    for(i = 0; i < buframptr->num_attrs; i++) {
+      packetbuf_set_attr(ATTR_TYPES(buframptr)[i], ATTR_VALS(buframptr)[i]);
+    }
+    for(i = 0; i < PACKETBUF_NUM_ADDRS; i++) {
+      packetbuf_set_addr(PACKETBUF_ADDR_FIRST + i, &ADDRS(buframptr)[i]);
+    }
+#else /* QUEUEBUF_COMPACT */
     packetbuf_copyfrom(buframptr->data, buframptr->len);
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+#endif /* QUEUEBUF_COMPACT */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -430,7 +659,11 @@ queuebuf_dataptr(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if QUEUEBUF_COMPACT
+    return DATA(buframptr);
+#else /* QUEUEBUF_COMPACT */
     return buframptr->data;
+#endif /* QUEUEBUF_COMPACT */
   }
   return NULL;
 }
@@ -446,21 +679,47 @@ linkaddr_t *
 queuebuf_addr(struct queuebuf *b, uint8_t type)
 {
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if QUEUEBUF_COMPACT
+  return &ADDRS(buframptr)[type - PACKETBUF_ADDR_FIRST];
+#else /* QUEUEBUF_COMPACT */
   return &buframptr->addrs[type - PACKETBUF_ADDR_FIRST].addr;
+#endif /* QUEUEBUF_COMPACT */
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 queuebuf_attr(struct queuebuf *b, uint8_t type)
 {
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if QUEUEBUF_COMPACT
+  int i = find_attr(buframptr, type);
+  return i < 0 ? 0 : ATTR_VALS(buframptr)[i];
+#else /* QUEUEBUF_COMPACT */
   return buframptr->attrs[type].val;
+#endif /* QUEUEBUF_COMPACT */
 }
 /*---------------------------------------------------------------------------*/
-void
+int
 set_queuebuf_attr(struct queuebuf *b, uint8_t type, packetbuf_attr_t val) //JSB
 {
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if QUEUEBUF_COMPACT
+  int i = find_attr(buframptr, type);
+  if(i < 0) {
+    if(val == 0) {
+      return 1;
+    }
+    if(buframptr->num_attrs == buframptr->max_attrs) {
+      PRINTF("set_queuebuf_attr: no room for attribute %u\n", type);
+      return 0;
+    }
+    i = buframptr->num_attrs++;
+    ATTR_TYPES(buframptr)[i] = type;
+  }
+  ATTR_VALS(buframptr)[i] = val;
+#else /* QUEUEBUF_COMPACT */
   buframptr->attrs[type].val=val;
+#endif /* QUEUEBUF_COMPACT */
+  return 1;
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -79,6 +79,87 @@
   #define WITH_SWAP 0
 #endif /* QUEUEBUFRAM_CONF_NUM */
 
+/* QUEUEBUF_COMPACT: instead of a full image of the packetbuf, each
+   queuebuf only stores the bytes in use and the attributes that are
+   not zero, in a chunk taken from the smallest of three size classes
+   that fits. The classes are QUEUEBUF_SMALL_SIZE and
+   QUEUEBUF_MEDIUM_SIZE bytes, and large enough for a full packetbuf.
+   These sizes include the attributes and addresses, which take about
+   30 bytes on a typical 802.15.4 frame. A class that runs out borrows
+   from the next larger one.
+   A large chunk is a little bigger than a fixed-layout queuebuf, as it
+   has room for every attribute, so the RAM saving comes from the small
+   and medium chunks. By default a quarter of the QUEUEBUF_NUM chunks
+   are small and a quarter medium; the large ones are left for frames
+   that do not fit a medium chunk. With QUEUEBUF_NUM 8, 17 attributes
+   and 8-byte addresses, that is 1280 bytes of chunks instead of 1440.
+   Full frames fail once the large chunks are taken, even if smaller
+   chunks are free. */
+#ifdef QUEUEBUF_CONF_COMPACT
+#define QUEUEBUF_COMPACT QUEUEBUF_CONF_COMPACT
+#else
+#define QUEUEBUF_COMPACT 0
+#endif
+
+#if QUEUEBUF_COMPACT
+#if WITH_SWAP
+#error "QUEUEBUF_CONF_COMPACT cannot be used with queuebuf swapping"
+#endif
+
+#ifdef QUEUEBUF_CONF_SMALL_SIZE
+#define QUEUEBUF_SMALL_SIZE QUEUEBUF_CONF_SMALL_SIZE
+#else
+#define QUEUEBUF_SMALL_SIZE 80
+#endif
+
+#ifdef QUEUEBUF_CONF_SMALL_NUM
+#define QUEUEBUF_SMALL_NUM QUEUEBUF_CONF_SMALL_NUM
+#else
+#define QUEUEBUF_SMALL_NUM (QUEUEBUF_NUM / 4)
+#endif
+
+#ifdef QUEUEBUF_CONF_MEDIUM_SIZE
+#define QUEUEBUF_MEDIUM_SIZE QUEUEBUF_CONF_MEDIUM_SIZE
+#else
+#define QUEUEBUF_MEDIUM_SIZE 144
+#endif
+
+#ifdef QUEUEBUF_CONF_MEDIUM_NUM
+#define QUEUEBUF_MEDIUM_NUM QUEUEBUF_CONF_MEDIUM_NUM
+#else
+#define QUEUEBUF_MEDIUM_NUM (QUEUEBUF_NUM / 4)
+#endif
+
+#ifdef QUEUEBUF_CONF_LARGE_NUM
+#define QUEUEBUF_LARGE_NUM QUEUEBUF_CONF_LARGE_NUM
+#else
+#define QUEUEBUF_LARGE_NUM (QUEUEBUF_NUM - QUEUEBUF_SMALL_NUM - QUEUEBUF_MEDIUM_NUM)
+#endif
+
+#if QUEUEBUF_LARGE_NUM < 1
+#error "QUEUEBUF_COMPACT needs at least one chunk large enough for a full frame"
+#endif
+
+/* Number of zero attributes a queuebuf has room to set later on,
+   through set_queuebuf_attr() or queuebuf_update_attr_from_packetbuf().
+   The TSCH link selector attributes always have room of their own. */
+#ifdef QUEUEBUF_CONF_ATTR_ROOM
+#define QUEUEBUF_ATTR_ROOM QUEUEBUF_CONF_ATTR_ROOM
+#else
+#define QUEUEBUF_ATTR_ROOM 2
+#endif
+
+/* Room kept after the data for trailers added in place, such as the
+   MIC TSCH appends to frames that are authenticated but not encrypted */
+#ifdef QUEUEBUF_CONF_TAILROOM
+#define QUEUEBUF_TAILROOM QUEUEBUF_CONF_TAILROOM
+#elif LLSEC802154_CONF_ENABLED
+#define QUEUEBUF_TAILROOM 16
+#else
+#define QUEUEBUF_TAILROOM 0
+#endif
+#endif /* QUEUEBUF_COMPACT */
+
 #ifdef QUEUEBUF_CONF_DEBUG
 #define QUEUEBUF_DEBUG QUEUEBUF_CONF_DEBUG
 #else /* QUEUEBUF_CONF_DEBUG */
@@ -95,12 +176,16 @@ struct queuebuf *queuebuf_new_from_packetbuf_debug(const char *file, int line);
 #else /* QUEUEBUF_DEBUG */
 struct queuebuf *queuebuf_new_from_packetbuf(void);
 #endif /* QUEUEBUF_DEBUG */
-void queuebuf_update_attr_from_packetbuf(struct queuebuf *b);
-void queuebuf_update_from_packetbuf(struct queuebuf *b);
+/* These return 0, and leave the queuebuf as it was, if it has no room
+   for the attributes or data of the packetbuf */
+int queuebuf_update_attr_from_packetbuf(struct queuebuf *b);
+int queuebuf_update_from_packetbuf(struct queuebuf *b);
 
 void queuebuf_to_packetbuf(struct queuebuf *b);
 void queuebuf_free(struct queuebuf *b);
 
+/* The data of a queuebuf stays in place until it is freed, so the MAC
+   may transmit from it */
 void *queuebuf_dataptr(struct queuebuf *b);
 int queuebuf_datalen(struct queuebuf *b);
 
@@ -108,7 +193,8 @@ linkaddr_t *queuebuf_addr(struct queuebuf *b, uint8_t type);
 packetbuf_attr_t queuebuf_attr(struct queuebuf *b, uint8_t type);
 
 
-void set_queuebuf_attr(struct queuebuf *b, uint8_t type, packetbuf_attr_t val); //JSB
+/* Returns 0 if the queuebuf has no room left for the attribute */
+int set_queuebuf_attr(struct queuebuf *b, uint8_t type, packetbuf_attr_t val); //JSB
 
 
 void queuebuf_debug_print(void);
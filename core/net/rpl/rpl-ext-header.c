@@ -323,12 +323,115 @@ count_matching_bytes(const void *p1, const void *p2, size_t n)
   return n;
 }
 /*---------------------------------------------------------------------------*/
+/* Write the compressed addresses of the route to dest_node backwards
+ * from end, and return the next hop, the node whose parent is the root */
+static rpl_ns_node_t *
+write_srh_hops(uint8_t *end, rpl_ns_node_t *dest_node,
+               rpl_ns_node_t *root_node, uint8_t cmpri)
+{
+  rpl_ns_node_t *node;
+  uip_ipaddr_t node_addr;
+
+  node = dest_node;
+  while(node != NULL && node->parent != root_node) {
+    rpl_ns_get_node_global_addr(&node_addr, node);
+
+    end -= (16 - cmpri);
+    memcpy(end, ((uint8_t*)&node_addr) + cmpri, 16 - cmpri);
+
+    node = node->parent;
+  }
+  return node;
+}
+/*---------------------------------------------------------------------------*/
+/* Compute the number of addresses in the source route to dest_node and
+ * how many bytes all of them have in common with the destination
+ * (we use cmpri == cmpre). Returns -1 if there is no route. */
+static int
+srh_path(rpl_dag_t *dag, rpl_ns_node_t *dest_node,
+         rpl_ns_node_t *root_node, uint8_t *cmpr)
+{
+  int path_len;
+  rpl_ns_node_t *node;
+  uip_ipaddr_t node_addr;
+
+  if(!rpl_ns_is_node_reachable(dag, &UIP_IP_BUF->destipaddr)) {
+    PRINTF("RPL: SRH no path found to destination\n");
+    return -1;
+  }
+
+  path_len = 0;
+  node = dest_node->parent;
+  *cmpr = 15;
+
+  while(node != NULL && node != root_node) {
+
+    rpl_ns_get_node_global_addr(&node_addr, node);
+
+    /* How many bytes in common between all nodes in the path? */
+    *cmpr = MIN(*cmpr, count_matching_bytes(&node_addr, &UIP_IP_BUF->destipaddr, 16));
+
+    PRINTF("RPL: SRH Hop ");
+    PRINT6ADDR(&node_addr);
+    PRINTF("\n");
+    node = node->parent;
+    path_len++;
+  }
+  return path_len;
+}
+/*---------------------------------------------------------------------------*/
+#if RPL_NS_SRH_CACHE_SIZE
+/* Source route to a recent destination, valid as long as
+   rpl_ns_version() has not changed since it was computed */
+struct srh_cache_entry {
+  rpl_ns_node_t *dest;
+  rpl_ns_node_t *next_hop;
+  uint32_t version;
+  uint8_t path_len;
+  uint8_t cmpr;
+  uint8_t hops[RPL_NS_SRH_CACHE_HOPS_LEN];
+};
+
+static struct srh_cache_entry srh_cache[RPL_NS_SRH_CACHE_SIZE];
+
+static struct srh_cache_entry *
+srh_cache_slot(const rpl_ns_node_t *dest_node)
+{
+  unsigned h;
+  int i;
+
+  h = 0;
+  for(i = 0; i < 8; i++) {
+    h = (h << 5) - h + dest_node->link_identifier[i];
+  }
+  return &srh_cache[h % RPL_NS_SRH_CACHE_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static void
+srh_cache_put(struct srh_cache_entry *entry, rpl_ns_node_t *dest_node,
+              rpl_ns_node_t *root_node, int path_len, uint8_t cmpr)
+{
+  entry->dest = NULL;
+  if(path_len < 0 || path_len * (16 - cmpr) > RPL_NS_SRH_CACHE_HOPS_LEN) {
+    return;
+  }
+  if(path_len > 0) {
+    entry->next_hop = write_srh_hops(entry->hops + path_len * (16 - cmpr),
+                                     dest_node, root_node, cmpr);
+  }
+  entry->dest = dest_node;
+  entry->version = rpl_ns_version();
+  entry->path_len = path_len;
+  entry->cmpr = cmpr;
+}
+#endif /* RPL_NS_SRH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
 static int
 insert_srh_header(void)
 {
   /* Implementation of RFC6554 */
   uint8_t temp_len;
-  uint8_t path_len;
+  int path_len;
   uint8_t ext_len;
   uint8_t cmpri, cmpre; /* ComprI and ComprE fields of the RPL Source Routing Header */
   uint8_t *hop_ptr;
@@ -338,6 +441,9 @@ insert_srh_header(void)
   rpl_ns_node_t *node;
   rpl_dag_t *dag;
   uip_ipaddr_t node_addr;
+#if RPL_NS_SRH_CACHE_SIZE
+  struct srh_cache_entry *entry;
+#endif /* RPL_NS_SRH_CACHE_SIZE */
 
   PRINTF("RPL: SRH creating source routing header with destination ");
   PRINT6ADDR(&UIP_IP_BUF->destipaddr);
@@ -365,38 +471,30 @@ insert_srh_header(void)
     return 0;
   }
 
-  if(!rpl_ns_is_node_reachable(dag, &UIP_IP_BUF->destipaddr)) {
-    PRINTF("RPL: SRH no path found to destination\n");
-    return 0;
+  /* Compute path length and compression factors */
+#if RPL_NS_SRH_CACHE_SIZE
+  entry = srh_cache_slot(dest_node);
+  if(entry->dest == dest_node && entry->version == rpl_ns_version()) {
+    path_len = entry->path_len;
+    cmpri = entry->cmpr;
+  } else {
+    path_len = srh_path(dag, dest_node, root_node, &cmpri);
+    srh_cache_put(entry, dest_node, root_node, path_len, cmpri);
   }
+#else /* RPL_NS_SRH_CACHE_SIZE */
+  path_len = srh_path(dag, dest_node, root_node, &cmpri);
+#endif /* RPL_NS_SRH_CACHE_SIZE */
+  cmpre = cmpri;
 
-  /* Compute path length and compression factors (we use cmpri == cmpre) */
-  path_len = 0;
-  node = dest_node->parent;
-  /* For simplicity, we use cmpri = cmpre */
-  cmpri = 15;
-  cmpre = 15;
+  if(path_len < 0) {
+    return 0;
+  }
 
-  if(node == root_node) {
+  if(path_len == 0) {
     PRINTF("RPL: SRH no need to insert SRH\n");
     return 1;
   }
 
-  while(node != NULL && node != root_node) {
-
-    rpl_ns_get_node_global_addr(&node_addr, node);
-
-    /* How many bytes in common between all nodes in the path? */
-    cmpri = MIN(cmpri, count_matching_bytes(&node_addr, &UIP_IP_BUF->destipaddr, 16));
-    cmpre = cmpri;
-
-    PRINTF("RPL: SRH Hop ");
-    PRINT6ADDR(&node_addr);
-    PRINTF("\n");
-    node = node->parent;
-    path_len++;
-  }
-
   /* Extension header length: fixed headers + (n-1) * (16-ComprI) + (16-ComprE)*/
   ext_len = RPL_RH_LEN + RPL_SRH_LEN
       + (path_len - 1) * (16 - cmpre)
@@ -434,17 +532,15 @@ insert_srh_header(void)
 
   /* Initialize addresses field (the actual source route).
    * From last to first. */
-  node = dest_node;
   hop_ptr = ((uint8_t *)UIP_RH_BUF) + ext_len - padding; /* Pointer where to write the next hop compressed address */
-
-  while(node != NULL && node->parent != root_node) {
-    rpl_ns_get_node_global_addr(&node_addr, node);
-
-    hop_ptr -= (16 - cmpri);
-    memcpy(hop_ptr, ((uint8_t*)&node_addr) + cmpri, 16 - cmpri);
-
-    node = node->parent;
-  }
+#if RPL_NS_SRH_CACHE_SIZE
+  if(entry->dest == dest_node) {
+    memcpy(hop_ptr - path_len * (16 - cmpri), entry->hops,
+           path_len * (16 - cmpri));
+    node = entry->next_hop;
+  } else
+#endif /* RPL_NS_SRH_CACHE_SIZE */
+  node = write_srh_hops(hop_ptr, dest_node, root_node, cmpri);
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
   rpl_ns_get_node_global_addr(&node_addr, node);
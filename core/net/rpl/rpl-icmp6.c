@@ -986,8 +986,10 @@ dao_input_storing(void)
       linkaddr_t * nbr_lladdr=nbr_table_get_lladdr(ds6_neighbors,nbr);
       reset_nbr(nbr_lladdr,0,1);
 
+      tsch_schedule_begin();
       remove_tx(prefix_id);
       remove_rx(prefix_id);
+      tsch_schedule_commit();
       //tsch_schedule_print_proposed();
 
       break;
@@ -63,6 +63,16 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, rpl_ns_node_t, RPL_NS_LINK_NUM);
 
+#if RPL_NS_HASH
+static rpl_ns_node_t *node_hash[RPL_NS_HASH_SIZE];
+#endif /* RPL_NS_HASH */
+
+#if RPL_NS_SRH_CACHE_SIZE
+/* Incremented whenever a parent changes or a node goes away, which
+   invalidates all source routes computed before */
+static uint32_t version;
+#endif /* RPL_NS_SRH_CACHE_SIZE */
+
 /*---------------------------------------------------------------------------*/
 int
 rpl_ns_num_nodes(void)
@@ -70,6 +80,44 @@ rpl_ns_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_NS_HASH
+static unsigned
+node_hash_index(const unsigned char *link_identifier)
+{
+  unsigned h;
+  int i;
+
+  h = 0;
+  for(i = 0; i < 8; i++) {
+    h = (h << 5) - h + link_identifier[i];
+  }
+  return h & (RPL_NS_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+node_hash_remove(rpl_ns_node_t *node)
+{
+  rpl_ns_node_t **n;
+
+  for(n = &node_hash[node_hash_index(node->link_identifier)];
+      *n != NULL;
+      n = &(*n)->hash_next) {
+    if(*n == node) {
+      *n = node->hash_next;
+      break;
+    }
+  }
+}
+#endif /* RPL_NS_HASH */
+/*---------------------------------------------------------------------------*/
+#if RPL_NS_SRH_CACHE_SIZE
+uint32_t
+rpl_ns_version(void)
+{
+  return version;
+}
+#endif /* RPL_NS_SRH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(const rpl_dag_t *dag, const rpl_ns_node_t *node, const uip_ipaddr_t *addr)
 {
@@ -85,7 +133,16 @@ rpl_ns_node_t *
 rpl_ns_get_node(const rpl_dag_t *dag, const uip_ipaddr_t *addr)
 {
   rpl_ns_node_t *l;
+#if RPL_NS_HASH
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = node_hash[node_hash_index(((const unsigned char *)addr) + 8)];
+      l != NULL;
+      l = l->hash_next) {
+#else /* RPL_NS_HASH */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+#endif /* RPL_NS_HASH */
     /* Compare prefix and node identifier */
     if(node_matches_address(dag, l, addr)) {
       return l;
@@ -114,6 +171,9 @@ rpl_ns_expire_parent(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr
   /* Check if parent matches */
   if(l != NULL && node_matches_address(dag, l->parent, parent)) {
     l->lifetime = RPL_NOPATH_REMOVAL_DELAY;
+#if RPL_NS_SRH_CACHE_SIZE
+    version++;
+#endif /* RPL_NS_SRH_CACHE_SIZE */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -144,7 +204,15 @@ rpl_ns_update_node(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr_t
     child_node->parent = NULL;
     list_add(nodelist, child_node);
     num_nodes++;
+#if RPL_NS_HASH
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+    child_node->hash_next = node_hash[node_hash_index(child_node->link_identifier)];
+    node_hash[node_hash_index(child_node->link_identifier)] = child_node;
+#endif /* RPL_NS_HASH */
   }
+#if RPL_NS_SRH_CACHE_SIZE
+  old_parent_node = child_node->parent;
+#endif /* RPL_NS_SRH_CACHE_SIZE */
 
   /* Initialize node */
   child_node->dag = dag;
@@ -167,6 +235,12 @@ rpl_ns_update_node(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr_t
     child_node->parent = parent_node;
   }
 
+#if RPL_NS_SRH_CACHE_SIZE
+  if(child_node->parent != old_parent_node) {
+    version++;
+  }
+#endif /* RPL_NS_SRH_CACHE_SIZE */
+
   return child_node;
 }
 /*---------------------------------------------------------------------------*/
@@ -176,6 +250,12 @@ rpl_ns_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if RPL_NS_HASH
+  memset(node_hash, 0, sizeof(node_hash));
+#endif /* RPL_NS_HASH */
+#if RPL_NS_SRH_CACHE_SIZE
+  version++;
+#endif /* RPL_NS_SRH_CACHE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 rpl_ns_node_t *
@@ -220,6 +300,12 @@ rpl_ns_periodic(void)
         }
       }
       /* No child found, deallocate node */
+#if RPL_NS_HASH
+      node_hash_remove(l);
+#endif /* RPL_NS_HASH */
+#if RPL_NS_SRH_CACHE_SIZE
+      version++;
+#endif /* RPL_NS_SRH_CACHE_SIZE */
       list_remove(nodelist, l);
       memb_free(&nodememb, l);
       num_nodes--;
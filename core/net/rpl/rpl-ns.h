@@ -49,6 +49,44 @@
 #define RPL_NS_LINK_NUM 32
 #endif /* RPL_NS_CONF_LINK_NUM */
 
+/* Look nodes up through a hash table on the link identifier instead
+   of walking the node list */
+#ifdef RPL_NS_CONF_HASH
+#define RPL_NS_HASH RPL_NS_CONF_HASH
+#else /* RPL_NS_CONF_HASH */
+#define RPL_NS_HASH 0
+#endif /* RPL_NS_CONF_HASH */
+
+/* Number of hash buckets, must be a power of two */
+#ifdef RPL_NS_CONF_HASH_SIZE
+#define RPL_NS_HASH_SIZE RPL_NS_CONF_HASH_SIZE
+#elif RPL_NS_LINK_NUM <= 16
+#define RPL_NS_HASH_SIZE 16
+#elif RPL_NS_LINK_NUM <= 64
+#define RPL_NS_HASH_SIZE 64
+#elif RPL_NS_LINK_NUM <= 256
+#define RPL_NS_HASH_SIZE 256
+#else
+#define RPL_NS_HASH_SIZE 1024
+#endif
+
+/* Number of destinations for which the root keeps the compressed
+   source routing header of the last packet; 0 to build the header
+   from the node list for every packet */
+#ifdef RPL_NS_CONF_SRH_CACHE_SIZE
+#define RPL_NS_SRH_CACHE_SIZE RPL_NS_CONF_SRH_CACHE_SIZE
+#else /* RPL_NS_CONF_SRH_CACHE_SIZE */
+#define RPL_NS_SRH_CACHE_SIZE 0
+#endif /* RPL_NS_CONF_SRH_CACHE_SIZE */
+
+/* Room for compressed addresses in a cached header. Longer routes
+   are not cached. */
+#ifdef RPL_NS_CONF_SRH_CACHE_HOPS_LEN
+#define RPL_NS_SRH_CACHE_HOPS_LEN RPL_NS_CONF_SRH_CACHE_HOPS_LEN
+#else /* RPL_NS_CONF_SRH_CACHE_HOPS_LEN */
+#define RPL_NS_SRH_CACHE_HOPS_LEN 128
+#endif /* RPL_NS_CONF_SRH_CACHE_HOPS_LEN */
+
 typedef struct rpl_ns_node {
   struct rpl_ns_node *next;
   uint32_t lifetime;
@@ -56,6 +94,9 @@ typedef struct rpl_ns_node {
   /* Store only IPv6 link identifiers as all nodes in the DAG share the same prefix */
   unsigned char link_identifier[8];
   struct rpl_ns_node *parent;
+#if RPL_NS_HASH
+  struct rpl_ns_node *hash_next;
+#endif /* RPL_NS_HASH */
 } rpl_ns_node_t;
 
 int rpl_ns_num_nodes(void);
@@ -68,5 +109,9 @@ rpl_ns_node_t *rpl_ns_get_node(const rpl_dag_t *dag, const uip_ipaddr_t *addr);
 int rpl_ns_is_node_reachable(const rpl_dag_t *dag, const uip_ipaddr_t *addr);
 void rpl_ns_get_node_global_addr(uip_ipaddr_t *addr, rpl_ns_node_t *node);
 void rpl_ns_periodic(void);
+#if RPL_NS_SRH_CACHE_SIZE
+/* Changes whenever the route to any node may have changed */
+uint32_t rpl_ns_version(void);
+#endif /* RPL_NS_SRH_CACHE_SIZE */
 
 #endif /* RPL_NS_H */
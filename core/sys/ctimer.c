@@ -46,6 +46,8 @@
 #include "contiki.h"
 #include "lib/list.h"
 
+#include <stddef.h>
+
 LIST(ctimer_list);
 
 static char initialized;
@@ -67,11 +69,30 @@ PROCESS_THREAD(ctimer_process, ev, data)
 
   for(c = list_head(ctimer_list); c != NULL; c = c->next) {
     etimer_set(&c->etimer, c->etimer.timer.interval);
+#if ETIMER_WITH_HEAP
+    c->armed = 1;
+#endif /* ETIMER_WITH_HEAP */
   }
   initialized = 1;
+#if ETIMER_WITH_HEAP
+  /* From now on the etimer heap keeps track of running ctimers */
+  list_init(ctimer_list);
+#endif /* ETIMER_WITH_HEAP */
 
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+#if ETIMER_WITH_HEAP
+    /* Only ctimers set etimers on behalf of this process */
+    c = (struct ctimer *)((char *)data - offsetof(struct ctimer, etimer));
+    if(c->armed) {
+      c->armed = 0;
+      PROCESS_CONTEXT_BEGIN(c->p);
+      if(c->f != NULL) {
+        c->f(c->ptr);
+      }
+      PROCESS_CONTEXT_END(c->p);
+    }
+#else /* ETIMER_WITH_HEAP */
     for(c = list_head(ctimer_list); c != NULL; c = c->next) {
       if(&c->etimer == data) {
 	list_remove(ctimer_list, c);
@@ -83,6 +104,7 @@ PROCESS_THREAD(ctimer_process, ev, data)
 	break;
       }
     }
+#endif /* ETIMER_WITH_HEAP */
   }
   PROCESS_END();
 }
@@ -114,8 +136,16 @@ ctimer_set_with_process(struct ctimer *c, clock_time_t t,
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_set(&c->etimer, t);
     PROCESS_CONTEXT_END(&ctimer_process);
+#if ETIMER_WITH_HEAP
+    c->armed = 1;
+    return;
+#endif /* ETIMER_WITH_HEAP */
   } else {
     c->etimer.timer.interval = t;
+#if ETIMER_WITH_HEAP
+    /* Not in the etimer heap until ctimer_process sets it */
+    c->etimer.in_heap = NULL;
+#endif /* ETIMER_WITH_HEAP */
   }
 
   list_add(ctimer_list, c);
@@ -128,6 +158,10 @@ ctimer_reset(struct ctimer *c)
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_reset(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+#if ETIMER_WITH_HEAP
+    c->armed = 1;
+    return;
+#endif /* ETIMER_WITH_HEAP */
   }
 
   list_add(ctimer_list, c);
@@ -140,6 +174,10 @@ ctimer_restart(struct ctimer *c)
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_restart(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+#if ETIMER_WITH_HEAP
+    c->armed = 1;
+    return;
+#endif /* ETIMER_WITH_HEAP */
   }
 
   list_add(ctimer_list, c);
@@ -150,6 +188,10 @@ ctimer_stop(struct ctimer *c)
 {
   if(initialized) {
     etimer_stop(&c->etimer);
+#if ETIMER_WITH_HEAP
+    c->armed = 0;
+    return;
+#endif /* ETIMER_WITH_HEAP */
   } else {
     c->etimer.next = NULL;
     c->etimer.p = PROCESS_NONE;
@@ -62,6 +62,11 @@ struct ctimer {
   struct process *p;
   void (*f)(void *);
   void *ptr;
+#if ETIMER_WITH_HEAP
+  /* With the etimer heap, running ctimers are not kept on a list: this
+     tells if the callback is still due when the timer event arrives */
+  uint8_t armed;
+#endif /* ETIMER_WITH_HEAP */
 };
 
 /**
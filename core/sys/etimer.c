@@ -53,6 +53,134 @@ static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
+#if ETIMER_WITH_HEAP
+/*---------------------------------------------------------------------------*/
+/* With the heap, timerlist is the root of a pairing heap: the pending
+   timer that expires first. Timers are ordered by the time left until
+   they expire, expired timers counting as zero. As all timers age at the
+   same pace, that order does not change over time, and unlike absolute
+   expiration times it is safe across clock wraps. */
+static clock_time_t heap_now;
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+time_left(struct etimer *t)
+{
+  if((clock_time_t)(heap_now - t->timer.start) >= t->timer.interval) {
+    return 0;
+  }
+  return t->timer.start + t->timer.interval - heap_now;
+}
+#define EXPIRES_BEFORE(a, b) (time_left(a) < time_left(b))
+/*---------------------------------------------------------------------------*/
+/* Link two heaps, a and b must not have siblings */
+static struct etimer *
+heap_meld(struct etimer *a, struct etimer *b)
+{
+  struct etimer *t;
+
+  if(a == NULL) {
+    return b;
+  }
+  if(b == NULL) {
+    return a;
+  }
+  if(EXPIRES_BEFORE(b, a)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+  /* b becomes the first child of a */
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Two-pass pairing of a list of sibling heaps into a single heap */
+static struct etimer *
+heap_merge_pairs(struct etimer *first)
+{
+  struct etimer *a, *b;
+  struct etimer *paired;
+  struct etimer *root;
+
+  /* Meld siblings pairwise, left to right, onto a reversed list */
+  paired = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+      a = heap_meld(a, b);
+    }
+    a->next = paired;
+    paired = a;
+  }
+
+  /* Meld the pairs right to left */
+  root = NULL;
+  while(paired != NULL) {
+    a = paired;
+    paired = a->next;
+    a->next = NULL;
+    root = heap_meld(root, a);
+  }
+  return root;
+}
+/*---------------------------------------------------------------------------*/
+/* Does not follow any link of t, which may be a timer that was never
+   set and holds garbage */
+static int
+heap_contains(struct etimer *t)
+{
+  return t->in_heap == t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_insert(struct etimer *t)
+{
+  t->next = t->prev = t->child = NULL;
+  t->in_heap = t;
+  timerlist = heap_meld(timerlist, t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *t)
+{
+  struct etimer *sub;
+
+  sub = heap_merge_pairs(t->child);
+  t->child = NULL;
+  if(t == timerlist) {
+    timerlist = sub;
+  } else {
+    /* Unlink t from its parent or previous sibling */
+    if(t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
+    }
+    if(t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    timerlist = heap_meld(timerlist, sub);
+  }
+  t->next = t->prev = NULL;
+  t->in_heap = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_time(void)
+{
+  next_expiration = timerlist != NULL ?
+    timerlist->timer.start + timerlist->timer.interval : 0;
+}
+#else /* ETIMER_WITH_HEAP */
 /*---------------------------------------------------------------------------*/
 static void
 update_time(void)
@@ -76,6 +204,7 @@ update_time(void)
     next_expiration = now + tdist;
   }
 }
+#endif /* ETIMER_WITH_HEAP */
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
@@ -88,6 +217,51 @@ PROCESS_THREAD(etimer_process, ev, data)
   while(1) {
     PROCESS_YIELD();
 
+#if ETIMER_WITH_HEAP
+    if(ev == PROCESS_EVENT_EXITED) {
+      struct process *p = data;
+
+      /* Drain the heap and put back the timers of other processes */
+      heap_now = clock_time();
+      u = NULL;
+      while(timerlist != NULL) {
+        t = timerlist;
+        heap_remove(t);
+        t->next = u;
+        u = t;
+      }
+      while(u != NULL) {
+        t = u;
+        u = t->next;
+        if(t->p != p) {
+          heap_insert(t);
+        } else {
+          t->next = NULL;
+        }
+      }
+      update_time();
+      continue;
+    } else if(ev != PROCESS_EVENT_POLL) {
+      continue;
+    }
+
+    /* Expired timers are all at the top of the heap */
+    heap_now = clock_time();
+    while(timerlist != NULL && timer_expired(&timerlist->timer)) {
+      t = timerlist;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        t->p = PROCESS_NONE;
+        heap_remove(t);
+      } else {
+        etimer_request_poll();
+        break;
+      }
+    }
+    update_time();
+#else /* ETIMER_WITH_HEAP */
     if(ev == PROCESS_EVENT_EXITED) {
       struct process *p = data;
 
@@ -135,6 +309,7 @@ PROCESS_THREAD(etimer_process, ev, data)
       }
       u = t;
     }
+#endif /* ETIMER_WITH_HEAP */
     
   }
   
@@ -150,6 +325,20 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
+#if ETIMER_WITH_HEAP
+  etimer_request_poll();
+
+  heap_now = clock_time();
+  if(heap_contains(timer)) {
+    /* Timer already in the heap: its expiration time may have changed */
+    heap_remove(timer);
+  }
+
+  timer->p = PROCESS_CURRENT();
+  heap_insert(timer);
+
+  update_time();
+#else /* ETIMER_WITH_HEAP */
   struct etimer *t;
 
   etimer_request_poll();
@@ -171,6 +360,7 @@ add_timer(struct etimer *timer)
   timerlist = timer;
 
   update_time();
+#endif /* ETIMER_WITH_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -205,7 +395,18 @@ etimer_restart(struct etimer *et)
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
+#if ETIMER_WITH_HEAP
+  if(heap_contains(et)) {
+    heap_now = clock_time();
+    heap_remove(et);
+    et->timer.start += timediff;
+    heap_insert(et);
+  } else {
+    et->timer.start += timediff;
+  }
+#else /* ETIMER_WITH_HEAP */
   et->timer.start += timediff;
+#endif /* ETIMER_WITH_HEAP */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -242,6 +443,13 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
+#if ETIMER_WITH_HEAP
+  if(heap_contains(et)) {
+    heap_now = clock_time();
+    heap_remove(et);
+    update_time();
+  }
+#else /* ETIMER_WITH_HEAP */
   struct etimer *t;
 
   /* First check if et is the first event timer on the list. */
@@ -262,6 +470,7 @@ etimer_stop(struct etimer *et)
       update_time();
     }
   }
+#endif /* ETIMER_WITH_HEAP */
 
   /* Remove the next pointer from the item to be removed. */
   et->next = NULL;
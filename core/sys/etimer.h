@@ -65,6 +65,18 @@
 #include "sys/timer.h"
 #include "sys/process.h"
 
+/**
+ * Keep pending event timers in a pairing heap ordered by expiration
+ * time instead of an unsorted list. Arming and stopping a timer and
+ * finding the next one to expire then no longer scan every pending
+ * timer, at the cost of two more pointers per timer.
+ */
+#ifdef ETIMER_CONF_WITH_HEAP
+#define ETIMER_WITH_HEAP ETIMER_CONF_WITH_HEAP
+#else /* ETIMER_CONF_WITH_HEAP */
+#define ETIMER_WITH_HEAP 0
+#endif /* ETIMER_CONF_WITH_HEAP */
+
 /**
  * A timer.
  *
@@ -77,6 +89,15 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_WITH_HEAP
+  /* Heap links: next is the next sibling, prev the previous sibling or
+     the parent of a first child, child the first child */
+  struct etimer *prev;
+  struct etimer *child;
+  /* Points to the timer itself while it is in the heap, which a timer
+     that was never set is all but certain not to hold */
+  struct etimer *in_heap;
+#endif /* ETIMER_WITH_HEAP */
 };
 
 /**
@@ -63,16 +63,51 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+#if PROCESS_WITH_PRIORITY
+  process_num_events_t next;
+#endif /* PROCESS_WITH_PRIORITY */
 };
 
-static process_num_events_t nevents, fevent;
+static process_num_events_t nevents;
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
-#if PROCESS_CONF_STATS
-process_num_events_t process_maxevents;
+#if PROCESS_WITH_PRIORITY
+#if PROCESS_CONF_NUMEVENTS > 255
+#error PROCESS_CONF_NUMEVENTS must be below 256 with PROCESS_CONF_WITH_PRIORITY
 #endif
+/* The events entries are shared by one FIFO per priority class,
+   chained through their next field. Unused entries are kept on a
+   free list. */
+#define EVENT_NONE PROCESS_CONF_NUMEVENTS
+static process_num_events_t event_head[PROCESS_PRIORITY_CLASSES];
+static process_num_events_t event_tail[PROCESS_PRIORITY_CLASSES];
+static process_num_events_t event_free;
+
+/* One flag per class rather than a queue of processes, so that
+   process_poll() remains a single store that is safe to call from
+   interrupts. process_list is sorted by class, which bounds the walk
+   to the processes of the polled class and those above it. */
+static volatile unsigned char poll_requested[PROCESS_PRIORITY_CLASSES];
+
+/* The queues and flags above are indexed by the rank of a class, with
+   the highest class first. PROCESS_PRIORITY_NORMAL is zero rather than
+   the highest class, so that zero-initialised processes are normal. */
+static const unsigned char priority_rank[PROCESS_PRIORITY_CLASSES] = {
+  1, /* PROCESS_PRIORITY_NORMAL */
+  0, /* PROCESS_PRIORITY_HIGH */
+  2, /* PROCESS_PRIORITY_LOW */
+};
+#define RANK(p) priority_rank[(p)->priority]
+#else /* PROCESS_WITH_PRIORITY */
+static process_num_events_t fevent;
 
 static volatile unsigned char poll_requested;
+#endif /* PROCESS_WITH_PRIORITY */
+
+#if PROCESS_CONF_STATS
+process_num_events_t process_maxevents;
+unsigned short process_dropevents;
+#endif
 
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
@@ -95,6 +130,48 @@ process_alloc_event(void)
   return lastevent++;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_WITH_PRIORITY
+/* Insert p ahead of the other processes of its class */
+static void
+link_process(struct process *p)
+{
+  struct process **q;
+
+  for(q = &process_list;
+      *q != NULL && RANK(*q) < RANK(p);
+      q = &(*q)->next);
+  p->next = *q;
+  *q = p;
+}
+/*---------------------------------------------------------------------------*/
+static int
+unlink_process(struct process *p)
+{
+  struct process **q;
+
+  for(q = &process_list; *q != NULL; q = &(*q)->next) {
+    if(*q == p) {
+      *q = p->next;
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned char
+polls_pending(void)
+{
+  unsigned char c;
+
+  for(c = 0; c < PROCESS_PRIORITY_CLASSES; c++) {
+    if(poll_requested[c]) {
+      return 1;
+    }
+  }
+  return 0;
+}
+#endif /* PROCESS_WITH_PRIORITY */
+/*---------------------------------------------------------------------------*/
 void
 process_start(struct process *p, process_data_t data)
 {
@@ -109,8 +186,12 @@ process_start(struct process *p, process_data_t data)
     return;
   }
   /* Put on the procs list.*/
+#if PROCESS_WITH_PRIORITY
+  link_process(p);
+#else /* PROCESS_WITH_PRIORITY */
   p->next = process_list;
   process_list = p;
+#endif /* PROCESS_WITH_PRIORITY */
   p->state = PROCESS_STATE_RUNNING;
   PT_INIT(&p->pt);
 
@@ -209,14 +290,95 @@ process_init(void)
 {
   lastevent = PROCESS_EVENT_MAX;
 
+#if PROCESS_WITH_PRIORITY
+  {
+    process_num_events_t i;
+
+    nevents = 0;
+    for(i = 0; i < PROCESS_CONF_NUMEVENTS; i++) {
+      events[i].next = i + 1;
+    }
+    event_free = 0;
+    for(i = 0; i < PROCESS_PRIORITY_CLASSES; i++) {
+      event_head[i] = event_tail[i] = EVENT_NONE;
+      poll_requested[i] = 0;
+    }
+  }
+#else /* PROCESS_WITH_PRIORITY */
   nevents = fevent = 0;
+#endif /* PROCESS_WITH_PRIORITY */
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+  process_dropevents = 0;
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_WITH_PRIORITY
+/*
+ * Call the poll handlers of the processes in the class of rank maxclass
+ * and in the classes above it.
+ */
+static void
+do_poll(unsigned char maxclass)
+{
+  struct process *p;
+  unsigned char c;
+
+  for(c = 0; c <= maxclass; c++) {
+    if(poll_requested[c]) {
+      poll_requested[c] = 0;
+      for(p = process_list; p != NULL && RANK(p) <= c; p = p->next) {
+        if(RANK(p) == c && p->needspoll) {
+          p->state = PROCESS_STATE_RUNNING;
+          p->needspoll = 0;
+          call_process(p, PROCESS_EVENT_POLL, NULL);
+        }
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Deliver the first event of a class.
+ */
+static void
+do_event(unsigned char c)
+{
+  process_event_t ev;
+  process_data_t data;
+  struct process *receiver;
+  struct process *p;
+  process_num_events_t i;
+
+  i = event_head[c];
+  ev = events[i].ev;
+  data = events[i].data;
+  receiver = events[i].p;
+
+  event_head[c] = events[i].next;
+  if(event_head[c] == EVENT_NONE) {
+    event_tail[c] = EVENT_NONE;
+  }
+  events[i].next = event_free;
+  event_free = i;
+  --nevents;
+
+  if(receiver == PROCESS_BROADCAST) {
+    for(p = process_list; p != NULL; p = p->next) {
+      /* Only polls that outrank the broadcast itself may interrupt it */
+      do_poll(c);
+      call_process(p, ev, data);
+    }
+  } else {
+    if(ev == PROCESS_EVENT_INIT) {
+      receiver->state = PROCESS_STATE_RUNNING;
+    }
+    call_process(receiver, ev, data);
+  }
+}
+#else /* PROCESS_WITH_PRIORITY */
 /*
  * Call each process' poll handler.
  */
@@ -297,10 +459,31 @@ do_event(void)
     }
   }
 }
+#endif /* PROCESS_WITH_PRIORITY */
 /*---------------------------------------------------------------------------*/
 int
 process_run(void)
 {
+#if PROCESS_WITH_PRIORITY
+  unsigned char batch;
+  unsigned char c;
+
+  for(batch = 0; batch < PROCESS_BATCH; batch++) {
+    /* Find the highest class with a waiting event, and run the polls
+       of that class and above before delivering it */
+    for(c = 0;
+        c < PROCESS_PRIORITY_CLASSES && event_head[c] == EVENT_NONE;
+        c++);
+    if(c == PROCESS_PRIORITY_CLASSES) {
+      do_poll(PROCESS_PRIORITY_CLASSES - 1);
+      break;
+    }
+    do_poll(c);
+    do_event(c);
+  }
+
+  return nevents + polls_pending();
+#else /* PROCESS_WITH_PRIORITY */
   /* Process poll events. */
   if(poll_requested) {
     do_poll();
@@ -310,12 +493,17 @@ process_run(void)
   do_event();
 
   return nevents + poll_requested;
+#endif /* PROCESS_WITH_PRIORITY */
 }
 /*---------------------------------------------------------------------------*/
 int
 process_nevents(void)
 {
+#if PROCESS_WITH_PRIORITY
+  return nevents + polls_pending();
+#else /* PROCESS_WITH_PRIORITY */
   return nevents + poll_requested;
+#endif /* PROCESS_WITH_PRIORITY */
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -340,13 +528,39 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
       printf("soft panic: event queue is full when event %d was posted to %s from %s\n", ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
     }
 #endif /* DEBUG */
+#if PROCESS_CONF_STATS
+    process_dropevents++;
+#endif /* PROCESS_CONF_STATS */
     return PROCESS_ERR_FULL;
   }
   
+#if PROCESS_WITH_PRIORITY
+  {
+    unsigned char c;
+
+    snum = event_free;
+    event_free = events[snum].next;
+    events[snum].ev = ev;
+    events[snum].data = data;
+    events[snum].p = p;
+    events[snum].next = EVENT_NONE;
+
+    /* Broadcasts reach every class, so they are queued as normal */
+    c = p == PROCESS_BROADCAST ?
+      priority_rank[PROCESS_PRIORITY_NORMAL] : RANK(p);
+    if(event_tail[c] == EVENT_NONE) {
+      event_head[c] = snum;
+    } else {
+      events[event_tail[c]].next = snum;
+    }
+    event_tail[c] = snum;
+  }
+#else /* PROCESS_WITH_PRIORITY */
   snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
+#endif /* PROCESS_WITH_PRIORITY */
   ++nevents;
 
 #if PROCESS_CONF_STATS
@@ -374,11 +588,35 @@ process_poll(struct process *p)
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
       p->needspoll = 1;
+#if PROCESS_WITH_PRIORITY
+      poll_requested[RANK(p)] = 1;
+#else /* PROCESS_WITH_PRIORITY */
       poll_requested = 1;
+#endif /* PROCESS_WITH_PRIORITY */
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_WITH_PRIORITY
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+  if(p->priority == priority) {
+    return;
+  }
+  if(unlink_process(p)) {
+    p->priority = priority;
+    link_process(p);
+  } else {
+    p->priority = priority;
+  }
+  /* A pending poll follows the process to its new class */
+  if(p->needspoll) {
+    poll_requested[priority_rank[priority]] = 1;
+  }
+}
+#endif /* PROCESS_WITH_PRIORITY */
+/*---------------------------------------------------------------------------*/
 int
 process_is_running(struct process *p)
 {
@@ -88,6 +88,36 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \name Priority scheduling
+ *
+ * With PROCESS_CONF_WITH_PRIORITY, every process belongs to one of
+ * PROCESS_PRIORITY_CLASSES classes. Polls and events of a higher
+ * class are always dispatched before those of a lower class, and
+ * process_run() delivers up to PROCESS_BATCH events per call. Without
+ * it, all processes are equal and process_run() delivers one event.
+ * @{
+ */
+#ifdef PROCESS_CONF_WITH_PRIORITY
+#define PROCESS_WITH_PRIORITY PROCESS_CONF_WITH_PRIORITY
+#else
+#define PROCESS_WITH_PRIORITY 0
+#endif /* PROCESS_CONF_WITH_PRIORITY */
+
+/* Normal is zero, so that processes initialised without PROCESS(),
+   such as the subprocesses of subprocess.h, are normal */
+#define PROCESS_PRIORITY_NORMAL       0
+#define PROCESS_PRIORITY_HIGH         1
+#define PROCESS_PRIORITY_LOW          2
+#define PROCESS_PRIORITY_CLASSES      3
+
+#ifdef PROCESS_CONF_BATCH
+#define PROCESS_BATCH PROCESS_CONF_BATCH
+#else
+#define PROCESS_BATCH 4
+#endif /* PROCESS_CONF_BATCH */
+/** @} */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -323,6 +353,9 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_WITH_PRIORITY
+  unsigned char priority;
+#endif /* PROCESS_WITH_PRIORITY */
 };
 
 /**
@@ -519,6 +552,29 @@ CCIF int process_is_running(struct process *p);
  */
 int process_nevents(void);
 
+/**
+ * Set the priority class of a process.
+ *
+ * Processes are PROCESS_PRIORITY_NORMAL unless told otherwise. The
+ * call has no effect unless PROCESS_CONF_WITH_PRIORITY is set.
+ *
+ * \param p The process.
+ * \param priority One of PROCESS_PRIORITY_HIGH, PROCESS_PRIORITY_NORMAL
+ * or PROCESS_PRIORITY_LOW.
+ */
+#if PROCESS_WITH_PRIORITY
+void process_set_priority(struct process *p, unsigned char priority);
+#else
+#define process_set_priority(p, priority)
+#endif /* PROCESS_WITH_PRIORITY */
+
+#if PROCESS_CONF_STATS
+/** Highest number of events that were waiting at the same time */
+extern process_num_events_t process_maxevents;
+/** Number of events that process_post() dropped on a full queue */
+extern unsigned short process_dropevents;
+#endif /* PROCESS_CONF_STATS */
+
 /** @} */
 
 CCIF extern struct process *process_list;
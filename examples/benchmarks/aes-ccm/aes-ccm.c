@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for AES-128 and CCM*: cost of securing and
+ *         unsecuring a 127-byte frame in software.
+ *
+ *         Build with AES_TTABLE=0 to compare against the byte-wise
+ *         AES-128.
+ */
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/aes-128-ttable.h"
+#include "lib/ccm-star.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A 127-byte frame: header and auxiliary security header, payload,
+   and a 4-byte MIC, as with security level 5 */
+#define HDR_LEN      23
+#define MIC_LEN       4
+#define PAYLOAD_LEN  (127 - HDR_LEN - MIC_LEN)
+
+#define FRAMES 50000
+
+#if defined(__i386__) || defined(__x86_64__)
+#define CYCLES() __builtin_ia32_rdtsc()
+#else
+#define CYCLES() 0ULL
+#endif
+
+/* The byte-wise reference, whichever driver AES_128 is */
+extern const struct aes_128_driver aes_128_driver;
+
+static uint8_t key[AES_128_KEY_LENGTH];
+static uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+static uint8_t frame[127];
+
+PROCESS(ccm_star_process, "CCM* benchmark");
+AUTOSTART_PROCESSES(&ccm_star_process);
+/*---------------------------------------------------------------------------*/
+/* Checks the selected AES-128 against the FIPS-197 example and the
+   byte-wise driver */
+static int
+check_aes(void)
+{
+  static const uint8_t expected[AES_128_BLOCK_SIZE] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+  };
+  uint8_t a[AES_128_BLOCK_SIZE];
+  uint8_t b[AES_128_BLOCK_SIZE];
+  int i;
+  int j;
+
+  for(i = 0; i < AES_128_BLOCK_SIZE; i++) {
+    key[i] = i;
+    a[i] = i * 0x11;
+  }
+  AES_128.set_key(key);
+  AES_128.encrypt(a);
+  if(memcmp(a, expected, AES_128_BLOCK_SIZE) != 0) {
+    return 0;
+  }
+
+  for(i = 0; i < 1000; i++) {
+    for(j = 0; j < AES_128_BLOCK_SIZE; j++) {
+      key[j] = rand();
+      a[j] = b[j] = rand();
+    }
+    AES_128.set_key(key);
+    AES_128.encrypt(a);
+    aes_128_driver.set_key(key);
+    aes_128_driver.encrypt(b);
+    if(memcmp(a, b, AES_128_BLOCK_SIZE) != 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_result(const char *what, clock_time_t elapsed,
+             unsigned long long cycles)
+{
+  printf("%-10s %6lu ns/frame", what,
+         (unsigned long)(elapsed * (1000000000ULL / CLOCK_SECOND) / FRAMES));
+  if(cycles != 0) {
+    printf(" %7lu cycles/frame", (unsigned long)(cycles / FRAMES));
+  }
+  printf("\n");
+}
+/*---------------------------------------------------------------------------*/
+/* Secures or unsecures FRAMES frames, setting the key for each one as
+   tsch-security.c does */
+static void
+run(const char *what, int forward)
+{
+  unsigned long long cycles;
+  clock_time_t start;
+  int i;
+
+  start = clock_time();
+  cycles = CYCLES();
+  for(i = 0; i < FRAMES; i++) {
+    nonce[12] = i;
+    CCM_STAR.set_key(key);
+    CCM_STAR.aead(nonce, frame + HDR_LEN, PAYLOAD_LEN, frame, HDR_LEN,
+                  frame + HDR_LEN + PAYLOAD_LEN, MIC_LEN, forward);
+  }
+  cycles = CYCLES() - cycles;
+  print_result(what, clock_time() - start, cycles);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ccm_star_process, ev, data)
+{
+  uint8_t mic[MIC_LEN];
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Start measuring from the main loop, once the system is up */
+  PROCESS_PAUSE();
+
+#ifdef AES_128_CONF
+  printf("AES-128 T-table\n");
+#else /* AES_128_CONF */
+  printf("AES-128 byte-wise\n");
+#endif /* AES_128_CONF */
+  if(!check_aes()) {
+    printf("AES-128 self-test failed\n");
+    exit(1);
+  }
+
+  for(i = 0; i < sizeof(frame); i++) {
+    frame[i] = i;
+  }
+  for(i = 0; i < sizeof(nonce); i++) {
+    nonce[i] = i;
+  }
+
+  run("secure", 1);
+  run("unsecure", 0);
+
+  /* Round trip */
+  nonce[12] = 0;
+  CCM_STAR.set_key(key);
+  CCM_STAR.aead(nonce, frame + HDR_LEN, PAYLOAD_LEN, frame, HDR_LEN,
+                mic, MIC_LEN, 1);
+  CCM_STAR.aead(nonce, frame + HDR_LEN, PAYLOAD_LEN, frame, HDR_LEN,
+                frame + HDR_LEN + PAYLOAD_LEN, MIC_LEN, 0);
+  if(memcmp(mic, frame + HDR_LEN + PAYLOAD_LEN, MIC_LEN) != 0) {
+    printf("CCM* round trip failed\n");
+    exit(1);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
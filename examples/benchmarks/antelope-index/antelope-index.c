@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for Antelope indexes on Coffee, on the native xmem
+ *         backend: the cost of inserting 10000 tuples with increasing
+ *         timestamps into an indexed relation, and the rate of range
+ *         queries over 50 timestamps.
+ *
+ *         Build with INDEX=MAXHEAP or NONE to compare the B+-tree
+ *         against the MaxHeap index and full scans.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+#include "cfs/cfs-coffee.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The queries are repeated for at least this long */
+#define RUN_TIME (CLOCK_SECOND)
+#define TUPLES   10000
+/* Two tuples per timestamp */
+#define RANGE    50
+
+PROCESS(antelope_index_process, "Antelope index benchmark");
+AUTOSTART_PROCESSES(&antelope_index_process);
+/*---------------------------------------------------------------------------*/
+static void
+query(const char *q)
+{
+  if(DB_ERROR(db_query(NULL, q))) {
+    printf("query failed: %s\n", q);
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+range_query(long start)
+{
+  db_handle_t handle;
+  db_result_t result;
+  unsigned long rows;
+
+  if(DB_ERROR(db_query(&handle,
+                       "SELECT time, value FROM samples WHERE time >= %ld AND time < %ld;",
+                       start, start + RANGE))) {
+    printf("range query failed\n");
+    exit(1);
+  }
+
+  rows = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      rows++;
+    } else if(result != DB_OK) {
+      if(DB_ERROR(result)) {
+        printf("processing failed: %s\n", db_get_result_message(result));
+        exit(1);
+      }
+      break;
+    }
+  }
+  db_free(&handle);
+
+  return rows;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_index_process, ev, data)
+{
+  clock_time_t start, elapsed;
+  unsigned long queries;
+  unsigned long rows;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("antelope index %s\n", INDEX_TYPE);
+
+  cfs_coffee_format();
+  db_init();
+  query("CREATE RELATION samples;");
+  query("CREATE ATTRIBUTE time DOMAIN LONG IN samples;");
+  query("CREATE ATTRIBUTE value DOMAIN INT IN samples;");
+  if(strcmp(INDEX_TYPE, "NONE") != 0) {
+    if(DB_ERROR(db_query(NULL, "CREATE INDEX samples.time TYPE %s;",
+                         INDEX_TYPE))) {
+      printf("could not create the index\n");
+      exit(1);
+    }
+  }
+
+  start = clock_time();
+  for(i = 0; i < TUPLES; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%ld, %d) INTO samples;",
+                         (long)i / 2, rand() % 1000))) {
+      printf("insert failed\n");
+      exit(1);
+    }
+  }
+  elapsed = clock_time() - start;
+  printf("insert: %8lu tuples/s\n",
+         (unsigned long)TUPLES * CLOCK_SECOND / (elapsed ? elapsed : 1));
+
+  srand(1);
+  queries = 0;
+  start = clock_time();
+  do {
+    rows = range_query(rand() % (TUPLES / 2 - RANGE));
+    if(rows != 2 * RANGE) {
+      printf("range query returned %lu tuples instead of %d\n",
+             rows, 2 * RANGE);
+      exit(1);
+    }
+    queries++;
+    elapsed = clock_time() - start;
+  } while(elapsed < RUN_TIME);
+  printf("range: %8lu queries/s\n", queries * CLOCK_SECOND / elapsed);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for Antelope: full-relation scans with a range
+ *         predicate, as a plain selection and as MEAN and MAX
+ *         aggregations, over 20000 tuples stored through cfs-posix.
+ *
+ *         Build with SCAN_BATCH=1 to compare against the tuple-at-a-time
+ *         scan.
+ */
+
+#include "contiki.h"
+#include "antelope.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Each query is repeated for at least this long */
+#define RUN_TIME (CLOCK_SECOND)
+#define TUPLES   20000
+
+static const char * const queries[] = {
+  "SELECT id, temp FROM samples WHERE temp > 250 AND temp < 500;",
+  "SELECT MEAN(temp) FROM samples WHERE temp > 250 AND temp < 500;",
+  "SELECT MAX(id) FROM samples WHERE temp > 250 AND temp < 500;",
+};
+
+PROCESS(antelope_scan_process, "Antelope scan benchmark");
+AUTOSTART_PROCESSES(&antelope_scan_process);
+/*---------------------------------------------------------------------------*/
+static void
+query(const char *q)
+{
+  if(DB_ERROR(db_query(NULL, q))) {
+    printf("query failed: %s\n", q);
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Run a selection to its end, and return the number of result tuples.
+   The value of the last one is stored in last. */
+static unsigned long
+scan(const char *q, long *last)
+{
+  db_handle_t handle;
+  db_result_t result;
+  attribute_value_t value;
+  unsigned long rows;
+
+  if(DB_ERROR(db_query(&handle, q))) {
+    printf("query failed: %s\n", q);
+    exit(1);
+  }
+
+  rows = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      rows++;
+      if(db_get_value(&value, &handle, 0) == DB_OK) {
+        *last = value.domain == DOMAIN_LONG ?
+          VALUE_LONG(&value) : VALUE_INT(&value);
+      }
+    } else if(result != DB_OK) {
+      if(DB_ERROR(result)) {
+        printf("processing failed: %s\n", db_get_result_message(result));
+        exit(1);
+      }
+      break;
+    }
+  }
+  db_free(&handle);
+
+  return rows;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(antelope_scan_process, ev, data)
+{
+  clock_time_t start, elapsed;
+  unsigned long scans;
+  unsigned long rows;
+  long last;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("antelope scan batch %d\n", DB_SCAN_BATCH_SIZE);
+
+  db_init();
+  db_query(NULL, "REMOVE RELATION samples;");
+  query("CREATE RELATION samples;");
+  query("CREATE ATTRIBUTE id DOMAIN INT IN samples;");
+  query("CREATE ATTRIBUTE temp DOMAIN INT IN samples;");
+  query("CREATE ATTRIBUTE light DOMAIN LONG IN samples;");
+
+  srand(1);
+  for(i = 0; i < TUPLES; i++) {
+    if(DB_ERROR(db_query(NULL, "INSERT (%d, %d, %ld) INTO samples;",
+                         i, rand() % 1000, (long)rand() % 100000))) {
+      printf("insert failed\n");
+      exit(1);
+    }
+  }
+
+  for(i = 0; i < sizeof(queries) / sizeof(queries[0]); i++) {
+    scans = 0;
+    last = 0;
+    start = clock_time();
+    do {
+      rows = scan(queries[i], &last);
+      scans++;
+      elapsed = clock_time() - start;
+    } while(elapsed < RUN_TIME);
+
+    printf("%-64s %8lu rows/s (%lu results, last %ld)\n", queries[i],
+           scans * TUPLES * CLOCK_SECOND / elapsed, rows, last);
+  }
+
+  db_query(NULL, "REMOVE RELATION samples;");
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
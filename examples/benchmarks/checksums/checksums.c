@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote
+ *    products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the uIP TCP/IP stack.
+ *
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for crc16_data() and uip_chksum_add(): throughput on
+ *         frame-sized and packet-sized buffers, next to byte-at-a-time
+ *         versions of the same computations.
+ *
+ *         Build with CRC16_SLICES=0, 1 or 4 to compare the CRC16
+ *         variants.
+ */
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+#include "net/ip/uip-chksum.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Bytes processed per measurement, to get well above the 1 ms native
+   clock resolution */
+#define TOTAL_BYTES (64UL * 1024 * 1024)
+
+static const int lengths[] = { 127, 1280 };
+
+/* One extra byte to run unaligned */
+static uint8_t buf[1280 + 1];
+
+/* Keeps the results alive */
+static volatile unsigned short sink;
+
+PROCESS(checksums_process, "Checksum benchmark");
+AUTOSTART_PROCESSES(&checksums_process);
+/*---------------------------------------------------------------------------*/
+static unsigned short
+bytewise_crc16(const uint8_t *data, int len, unsigned short acc)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    acc ^= data[i];
+    acc = (acc >> 8) | (acc << 8);
+    acc ^= (acc & 0xff00) << 4;
+    acc ^= (acc >> 8) >> 4;
+    acc ^= (acc & 0xff00) >> 5;
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+bytewise_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  uint16_t i;
+
+  for(i = 0; i + 1 < len; i += 2) {
+    t = (data[i] << 8) + data[i + 1];
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  if(i < len) {
+    t = data[i] << 8;
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_result(const char *what, int len, clock_time_t elapsed)
+{
+  if(elapsed == 0) {
+    elapsed = 1;
+  }
+  printf("%-16s %4d bytes: %6lu MB/s\n", what, len,
+         (unsigned long)(TOTAL_BYTES * CLOCK_SECOND / elapsed / 1000000));
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int len, int offset)
+{
+  const uint8_t *data;
+  clock_time_t start;
+  unsigned long i;
+  unsigned long n;
+
+  data = buf + offset;
+  n = TOTAL_BYTES / len;
+
+  start = clock_time();
+  for(i = 0; i < n; i++) {
+    sink = bytewise_crc16(data, len, sink);
+  }
+  print_result("crc16 bytewise", len, clock_time() - start);
+
+  start = clock_time();
+  for(i = 0; i < n; i++) {
+    sink = crc16_data(data, len, sink);
+  }
+  print_result("crc16_data", len, clock_time() - start);
+
+  start = clock_time();
+  for(i = 0; i < n; i++) {
+    sink = bytewise_chksum(sink, data, len);
+  }
+  print_result("chksum bytewise", len, clock_time() - start);
+
+  start = clock_time();
+  for(i = 0; i < n; i++) {
+    sink = uip_chksum_add(sink, data, len);
+  }
+  print_result("uip_chksum_add", len, clock_time() - start);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(checksums_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Start measuring from the main loop, once the system is up */
+  PROCESS_PAUSE();
+
+  for(i = 0; i < sizeof(buf); i++) {
+    buf[i] = random_rand();
+  }
+
+  printf("CRC16_SLICES %d\n", CRC16_SLICES);
+
+  for(i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    printf("aligned:\n");
+    run(lengths[i], 0);
+    printf("unaligned:\n");
+    run(lengths[i], 1);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
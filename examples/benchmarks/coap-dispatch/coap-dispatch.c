@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/**
+ * \file
+ *         Benchmark for CoAP request dispatch: GET requests per second
+ *         through coap_receive(), CON and NON, with 10, 50 and 200
+ *         resources on LwM2M-style object/instance/resource paths.
+ *
+ *         Build with REST_ENGINE_TRIE=0 to compare against the
+ *         resource list walk, and with COAP_NON_GET_FAST_PATH=0 to
+ *         answer NON requests through a transaction.
+ */
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "rest-engine.h"
+#include "er-coap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Each measurement runs batches of requests for at least this long */
+#define RUN_TIME (CLOCK_SECOND / 2)
+#define BATCH    1000
+
+#define MAX_RESOURCES 200
+
+static const int resource_counts[] = { 10, 50, MAX_RESOURCES };
+
+static resource_t resources[MAX_RESOURCES];
+static char paths[MAX_RESOURCES][20];
+
+static uip_ipaddr_t client_addr;
+static unsigned long handled;
+
+PROCESS_NAME(coap_engine);
+PROCESS(coap_dispatch_process, "CoAP dispatch benchmark");
+AUTOSTART_PROCESSES(&coap_dispatch_process);
+/*---------------------------------------------------------------------------*/
+static void
+res_get_handler(void *request, void *response, uint8_t *buffer,
+                uint16_t preferred_size, int32_t *offset)
+{
+  handled++;
+  REST.set_header_content_type(response, REST.type.TEXT_PLAIN);
+  REST.set_response_payload(response, "21.5", 4);
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_path(char *path, int i)
+{
+  /* Ten objects with twenty resources each, in one instance */
+  sprintf(path, "%d/0/%d", 3300 + i / 20, 5700 + i % 20);
+}
+/*---------------------------------------------------------------------------*/
+static void
+receive(int resource, coap_message_type_t type, uint16_t mid)
+{
+  static coap_packet_t request[1];
+  static const uint8_t token[] = { 0xca, 0xfe };
+  char path[20];
+
+  set_path(path, resource);
+  coap_init_message(request, type, COAP_GET, mid);
+  coap_set_token(request, token, sizeof(token));
+  coap_set_header_uri_path(request, path);
+
+  /* Lay the request out in uip_buf as the UDP input would have done */
+  uip_appdata = &uip_buf[UIP_LLH_LEN + UIP_IPUDPH_LEN];
+  uip_len = coap_serialize_message(request, uip_appdata);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &client_addr);
+  UIP_UDP_BUF->srcport = UIP_HTONS(COAP_DEFAULT_PORT + 1);
+  uip_flags = UIP_NEWDATA;
+
+  process_post_synch(&coap_engine, tcpip_event, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int num_resources, coap_message_type_t type)
+{
+  clock_time_t start, elapsed;
+  unsigned long requests;
+  int i;
+
+  requests = 0;
+  handled = 0;
+  start = clock_time();
+  do {
+    for(i = 0; i < BATCH; i++, requests++) {
+      receive((requests * 37) % num_resources, type, requests);
+    }
+    elapsed = clock_time() - start;
+  } while(elapsed < RUN_TIME);
+
+  if(handled != requests) {
+    printf("%lu of %lu requests handled\n", handled, requests);
+    exit(1);
+  }
+  printf("resources %3d, %s: %lu requests/s\n",
+         num_resources, type == COAP_TYPE_CON ? "CON" : "NON",
+         requests * CLOCK_SECOND / elapsed);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_dispatch_process, ev, data)
+{
+  static uip_lladdr_t lladdr = { { 0x02, 0x12, 0x74, 0, 0, 0, 0, 0x01 } };
+  int added;
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Responses go out to a known neighbor, without address resolution */
+  uip_ip6addr(&client_addr, 0xfe80, 0, 0, 0, 0x0212, 0x7400, 0, 0x0001);
+  if(uip_ds6_nbr_add(&client_addr, &lladdr, 1, NBR_REACHABLE,
+                     NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+    printf("could not add client neighbor\n");
+    exit(1);
+  }
+
+  printf("dispatch trie %s, NON fast path %s\n",
+         REST_ENGINE_TRIE ? "enabled" : "disabled",
+         COAP_NON_GET_FAST_PATH ? "enabled" : "disabled");
+
+  rest_init_engine();
+
+  added = 0;
+  for(i = 0; i < sizeof(resource_counts) / sizeof(resource_counts[0]); i++) {
+    for(; added < resource_counts[i]; added++) {
+      resources[added].get_handler = res_get_handler;
+      set_path(paths[added], added);
+      rest_activate_resource(&resources[added], paths[added]);
+    }
+    run(resource_counts[i], COAP_TYPE_CON);
+    run(resource_counts[i], COAP_TYPE_NON);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/**
+ * \file
+ *         Benchmark for Coffee on the native xmem backend: the cost of
+ *         mounting, and of opening existing and missing files, with 16,
+ *         64 and 256 files on the file system.
+ *
+ *         Build with COFFEE_INDEX=0 to compare against the header scan.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Each measurement runs batches of operations for at least this long */
+#define RUN_TIME (CLOCK_SECOND / 2)
+#define BATCH    100
+
+static const int file_counts[] = { 16, 64, 256 };
+
+PROCESS(coffee_process, "Coffee benchmark");
+AUTOSTART_PROCESSES(&coffee_process);
+/*---------------------------------------------------------------------------*/
+static void
+set_name(char *name, int i)
+{
+  sprintf(name, "file-%d", i);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+run(int num_files, int op)
+{
+  char name[16];
+  clock_time_t start, elapsed;
+  unsigned long ops;
+  int fd;
+  int i;
+
+  ops = 0;
+  start = clock_time();
+  do {
+    for(i = 0; i < BATCH; i++, ops++) {
+      if(op == 0) {
+        cfs_coffee_mount();
+        continue;
+      }
+      /* Stride through the files so that the open file cache does not
+         get a hit every time */
+      set_name(name, op == 1 ? (ops * 37) % num_files : num_files);
+      fd = cfs_open(name, CFS_READ);
+      if((fd >= 0) != (op == 1)) {
+        printf("unexpected open result for %s\n", name);
+        exit(1);
+      }
+      cfs_close(fd);
+    }
+    elapsed = clock_time() - start;
+  } while(elapsed < RUN_TIME);
+
+  /* ns per operation */
+  return elapsed * (1000000000UL / CLOCK_SECOND) / ops;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_process, ev, data)
+{
+  char name[16];
+  int added;
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("coffee index %s\n", COFFEE_CONF_INDEX ? "enabled" : "disabled");
+
+  cfs_coffee_format();
+
+  added = 0;
+  for(i = 0; i < sizeof(file_counts) / sizeof(file_counts[0]); i++) {
+    for(; added < file_counts[i]; added++) {
+      set_name(name, added);
+      if(cfs_coffee_reserve(name, 64) < 0) {
+        printf("could not reserve %s\n", name);
+        exit(1);
+      }
+    }
+    printf("files %3d: mount %6lu ns, open %6lu ns, open missing %6lu ns\n",
+           file_counts[i], run(file_counts[i], 0),
+           run(file_counts[i], 1), run(file_counts[i], 2));
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         A loadable module for the elf-load benchmark: 128 global
+ *         functions that call each other and the C library, so that
+ *         most relocations refer to named symbols, local or global.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define FUNCTIONS \
+  F(0, 1) F(1, 38) F(2, 75) F(3, 112) F(4, 21) F(5, 58) F(6, 95) F(7, 4) \
+  F(8, 41) F(9, 78) F(10, 115) F(11, 24) F(12, 61) F(13, 98) F(14, 7) \
+  F(15, 44) F(16, 81) F(17, 118) F(18, 27) F(19, 64) F(20, 101) F(21, 10) \
+  F(22, 47) F(23, 84) F(24, 121) F(25, 30) F(26, 67) F(27, 104) F(28, 13) \
+  F(29, 50) F(30, 87) F(31, 124) F(32, 33) F(33, 70) F(34, 107) F(35, 16) \
+  F(36, 53) F(37, 90) F(38, 127) F(39, 36) F(40, 73) F(41, 110) F(42, 19) \
+  F(43, 56) F(44, 93) F(45, 2) F(46, 39) F(47, 76) F(48, 113) F(49, 22) \
+  F(50, 59) F(51, 96) F(52, 5) F(53, 42) F(54, 79) F(55, 116) F(56, 25) \
+  F(57, 62) F(58, 99) F(59, 8) F(60, 45) F(61, 82) F(62, 119) F(63, 28) \
+  F(64, 65) F(65, 102) F(66, 11) F(67, 48) F(68, 85) F(69, 122) F(70, 31) \
+  F(71, 68) F(72, 105) F(73, 14) F(74, 51) F(75, 88) F(76, 125) F(77, 34) \
+  F(78, 71) F(79, 108) F(80, 17) F(81, 54) F(82, 91) F(83, 0) F(84, 37) \
+  F(85, 74) F(86, 111) F(87, 20) F(88, 57) F(89, 94) F(90, 3) F(91, 40) \
+  F(92, 77) F(93, 114) F(94, 23) F(95, 60) F(96, 97) F(97, 6) F(98, 43) \
+  F(99, 80) F(100, 117) F(101, 26) F(102, 63) F(103, 100) F(104, 9) \
+  F(105, 46) F(106, 83) F(107, 120) F(108, 29) F(109, 66) F(110, 103) \
+  F(111, 12) F(112, 49) F(113, 86) F(114, 123) F(115, 32) F(116, 69) \
+  F(117, 106) F(118, 15) F(119, 52) F(120, 89) F(121, 126) F(122, 35) \
+  F(123, 72) F(124, 109) F(125, 18) F(126, 55) F(127, 92)
+
+int calls[128];
+char buf[32];
+const char *names[] = { "zero", "one", "two", "three",
+                        "four", "five", "six", "seven" };
+
+#define F(n, m) int f##n(int x);
+FUNCTIONS
+#undef F
+
+#define F(n, m)                                 \
+  int                                           \
+  f##n(int x)                                   \
+  {                                             \
+    calls[n] += x;                              \
+    if(x <= 0) {                                \
+      return (int)strlen(names[n % 8]);         \
+    }                                           \
+    memset(buf, n, sizeof(buf));                \
+    return f##m(x - 1) + calls[m] + (int)clock_time(); \
+  }
+FUNCTIONS
+#undef F
+
+PROCESS(calls_process, "Calls");
+AUTOSTART_PROCESSES(&calls_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(calls_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("%d\n", f0(10));
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for the ELF loader: the time to load hello-world,
+ *         the module of regression-tests/07-elfloader, and calls, a
+ *         module with 128 functions, from files through CFS.
+ *
+ *         The global symbol table is the one of this binary, from
+ *         tools/make-symbols-nm. The loaded code is never run, so the
+ *         relocations are applied as plain 32-bit values. A checksum
+ *         of the relocations, with global symbols replaced by their
+ *         names, must be the same whatever ELFLOADER_BUFFERED and
+ *         SYMTAB_HASH.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "loader/elfloader-arch.h"
+#include "loader/symbols.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RUNS        5
+#define RUN_TIME    (CLOCK_SECOND / 10)
+
+static char ram[0x4000];
+static char rom[0x10000];
+
+static int checking;
+static unsigned long relocations;
+static unsigned long checksum;
+
+PROCESS(elf_load_process, "ELF load benchmark");
+AUTOSTART_PROCESSES(&elf_load_process);
+/*---------------------------------------------------------------------------*/
+void *
+elfloader_arch_allocate_ram(int size)
+{
+  return size <= sizeof(ram) ? ram : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void *
+elfloader_arch_allocate_rom(int size)
+{
+  return size <= sizeof(rom) ? rom : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+elfloader_arch_write_rom(int fd, unsigned short textoff, unsigned int size,
+                         char *mem)
+{
+  cfs_seek(fd, textoff, CFS_SEEK_SET);
+  cfs_read(fd, (unsigned char *)mem, size);
+}
+/*---------------------------------------------------------------------------*/
+/* The value of addr that does not depend on where this binary and its
+   buffers are: an offset in the module, or the name of a global. */
+static unsigned long
+relocation_value(const char *addr)
+{
+  unsigned long h;
+  const char *p;
+  int i;
+
+  if(addr >= ram && addr < ram + sizeof(ram)) {
+    return addr - ram;
+  }
+  if(addr >= rom && addr < rom + sizeof(rom)) {
+    return 0x10000 + (addr - rom);
+  }
+  for(i = 0; i < symbols_nelts - 1; i++) {
+    if(symbols[i].value == addr) {
+      h = 0;
+      for(p = symbols[i].name; *p != 0; p++) {
+        h = h * 31 + (unsigned char)*p;
+      }
+      return h;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+elfloader_arch_relocate(int fd, unsigned int sectionoffset,
+                        char *sectionaddr,
+                        struct elf32_rela *rela, char *addr)
+{
+  uint32_t value;
+
+  value = (uint32_t)(uintptr_t)(addr + rela->r_addend);
+  if((sectionaddr >= ram && sectionaddr + rela->r_offset + 4 <= ram + sizeof(ram)) ||
+     (sectionaddr >= rom && sectionaddr + rela->r_offset + 4 <= rom + sizeof(rom))) {
+    memcpy(sectionaddr + rela->r_offset, &value, sizeof(value));
+  }
+  if(checking) {
+    relocations++;
+    checksum = checksum * 31 + sectionoffset + rela->r_offset +
+      rela->r_info + rela->r_addend + relocation_value(addr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+load(const char *file)
+{
+  int fd;
+  int ret;
+
+  fd = cfs_open(file, CFS_READ);
+  if(fd < 0) {
+    printf("%s: cannot open\n", file);
+    exit(1);
+  }
+  ret = elfloader_load(fd);
+  cfs_close(fd);
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+static void
+measure(const char *file)
+{
+  clock_time_t start, elapsed;
+  unsigned long loads;
+  unsigned long best;
+  int ret;
+  int run;
+
+  checking = 1;
+  relocations = 0;
+  checksum = 0;
+  ret = load(file);
+  checking = 0;
+  if(ret != ELFLOADER_OK) {
+    printf("%s: error %d %s\n", file, ret, elfloader_unknown);
+    exit(1);
+  }
+
+  best = 0;
+  for(run = 0; run < RUNS; run++) {
+    loads = 0;
+    start = clock_time();
+    do {
+      load(file);
+      loads++;
+      elapsed = clock_time() - start;
+    } while(elapsed < RUN_TIME);
+    if(loads * CLOCK_SECOND / elapsed > best) {
+      best = loads * CLOCK_SECOND / elapsed;
+    }
+  }
+
+  printf("  %-16s %4lu relocations, checksum %08lx: %lu us per load\n",
+         file, relocations, checksum & 0xffffffff, 1000000 / best);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(elf_load_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  PROCESS_PAUSE();
+
+  elfloader_init();
+
+  printf("elfloader %s, symtab %s, %d global symbols\n",
+         ELFLOADER_BUFFERED ? "buffered" : "unbuffered",
+         SYMTAB_CONF_HASH ? "hash" : "binary search", symbols_nelts - 1);
+  measure("hello-world.elf32");
+  measure("calls.elf32");
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,487 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark and fuzz harness for the 802.15.4e frame parser:
+ *         frames per second through frame802154_parse() followed by
+ *         frame802154e_parse_information_elements(), as TSCH does for
+ *         every EB and EACK, over a corpus of EACKs, EBs and data
+ *         frames. Extra frames can be given in a file, one frame in hex
+ *         per line, e.g. from a sniffer capture:
+ *
+ *             ./frame-parse.native frames.txt
+ *
+ *         The fuzz rounds then run mutated frames through the parser,
+ *         and fail on any frame whose result depends on the bytes after
+ *         its end. Build with SANITIZE=1 to also have AddressSanitizer
+ *         catch every read past the end of a frame.
+ */
+
+#include "contiki.h"
+#include "net/mac/frame802154.h"
+#include "net/mac/frame802154e-ie.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_FRAMES   64
+#define FRAME_LEN    127
+/* Each measurement is the best of RUNS runs of batches of frames, each
+   run lasting at least RUN_TIME */
+#define RUNS         5
+#define RUN_TIME     (CLOCK_SECOND / 10)
+#define BATCH        10000
+
+struct corpus_frame {
+  const char *name;
+  uint8_t len;
+  uint8_t buf[FRAME_LEN];
+};
+
+static struct corpus_frame corpus[MAX_FRAMES];
+static int corpus_len;
+
+/* Result of a parse, compared between copies of a frame */
+struct parse_result {
+  int ret;
+  uint8_t hdr_len;
+  int payload_offset;
+  frame802154_t frame;
+  struct ieee802154_ies ies;
+};
+
+extern int contiki_argc;
+extern char **contiki_argv;
+
+PROCESS(frame_parse_process, "Frame parse benchmark");
+AUTOSTART_PROCESSES(&frame_parse_process);
+/*---------------------------------------------------------------------------*/
+/* The parse of tsch_packet_parse_eack() and tsch_packet_parse_eb(). The
+   IEs are parsed from ie_buf, which holds the same frame as buf */
+static int
+parse_frame(const uint8_t *buf, const uint8_t *ie_buf, int len,
+            frame802154_t *frame, struct ieee802154_ies *ies,
+            uint8_t *hdr_len)
+{
+  int curr_len;
+  int mic_len;
+  int ret;
+
+  if((ret = frame802154_parse((uint8_t *)buf, len, frame)) == 0) {
+    return 0;
+  }
+  *hdr_len = ret;
+  curr_len = ret;
+
+  memset(ies, 0, sizeof(struct ieee802154_ies));
+  if(frame->fcf.ie_list_present) {
+    mic_len = 0;
+#if LLSEC802154_ENABLED
+    if(frame->fcf.security_enabled) {
+      mic_len = 2 << (frame->aux_hdr.security_control.security_level & 0x03);
+    }
+    if(len < curr_len + mic_len) {
+      return 0;
+    }
+#endif /* LLSEC802154_ENABLED */
+    if((ret = frame802154e_parse_information_elements(ie_buf + curr_len,
+                                                      len - curr_len - mic_len, ies)) == -1) {
+      return 0;
+    }
+    curr_len += ret;
+  }
+  *hdr_len += ies->ie_payload_ie_offset;
+
+  return curr_len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+parse(const uint8_t *buf, const uint8_t *ie_buf, int len,
+      struct parse_result *r)
+{
+  memset(r, 0, sizeof(*r));
+  r->ret = parse_frame(buf, ie_buf, len, &r->frame, &r->ies, &r->hdr_len);
+  if(r->ret == 0) {
+    /* Fields of a rejected frame are unspecified */
+    memset(r, 0, sizeof(*r));
+    return;
+  }
+  r->payload_offset = r->frame.payload - buf;
+  r->frame.payload = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct corpus_frame *
+corpus_add(const char *name)
+{
+  struct corpus_frame *f;
+
+  if(corpus_len == MAX_FRAMES) {
+    return NULL;
+  }
+  f = &corpus[corpus_len++];
+  memset(f, 0, sizeof(*f));
+  f->name = name;
+  return f;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init_frame(frame802154_t *p, int type, int dest_mode, int src_mode)
+{
+  static uint8_t seqno;
+  int i;
+
+  memset(p, 0, sizeof(*p));
+  p->fcf.frame_type = type;
+  p->fcf.frame_version = FRAME802154_IEEE802154E_2012;
+  p->fcf.dest_addr_mode = dest_mode;
+  p->fcf.src_addr_mode = src_mode;
+  p->seq = ++seqno;
+  p->dest_pid = IEEE802154_PANID;
+  p->src_pid = IEEE802154_PANID;
+  for(i = 0; i < 8; i++) {
+    p->dest_addr[i] = 0x10 + i;
+    p->src_addr[i] = 0x20 + i;
+  }
+  if(dest_mode == FRAME802154_SHORTADDRMODE) {
+    p->dest_addr[0] = p->dest_addr[1] = 0xff;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+secure_frame(frame802154_t *p, int level)
+{
+  p->fcf.security_enabled = 1;
+  p->aux_hdr.security_control.security_level = level;
+  p->aux_hdr.security_control.key_id_mode = FRAME802154_1_BYTE_KEY_ID_MODE;
+  p->aux_hdr.security_control.frame_counter_suppression = 1;
+  p->aux_hdr.security_control.frame_counter_size = 1;
+  p->aux_hdr.key_index = 1;
+}
+/*---------------------------------------------------------------------------*/
+/* An enhanced ACK, as built by tsch_packet_create_eack() */
+static void
+add_eack(const char *name, int level)
+{
+  struct corpus_frame *f;
+  struct ieee802154_ies ies;
+  frame802154_t p;
+
+  f = corpus_add(name);
+  init_frame(&p, FRAME802154_ACKFRAME, FRAME802154_LONGADDRMODE,
+             FRAME802154_NOADDR);
+  p.fcf.ie_list_present = 1;
+  if(level) {
+    secure_frame(&p, level);
+  }
+  f->len = frame802154_create(&p, f->buf);
+
+  memset(&ies, 0, sizeof(ies));
+  ies.ie_time_correction = -42;
+  f->len += frame80215e_create_ie_header_ack_nack_time_correction(
+    f->buf + f->len, FRAME_LEN - f->len, &ies);
+  if(level) {
+    /* Room for the MIC */
+    f->len += 2 << (level & 0x03);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* An enhanced beacon, as built by tsch_packet_create_eb() */
+static void
+add_eb(const char *name)
+{
+  static const uint8_t hopping_sequence[] = { 15, 25, 26, 20 };
+  struct corpus_frame *f;
+  struct ieee802154_ies ies;
+  frame802154_t p;
+  int mlme_offset;
+  int i;
+
+  f = corpus_add(name);
+  init_frame(&p, FRAME802154_BEACONFRAME, FRAME802154_SHORTADDRMODE,
+             FRAME802154_LONGADDRMODE);
+  p.fcf.ie_list_present = 1;
+  p.fcf.sequence_number_suppression = 1;
+  f->len = frame802154_create(&p, f->buf);
+
+  memset(&ies, 0, sizeof(ies));
+  ies.ie_asn.ls4b = 0x12345678;
+  ies.ie_asn.ms1b = 0x9a;
+  ies.ie_join_priority = 1;
+  ies.ie_tsch_timeslot_id = 1;
+  for(i = 0; i < tsch_ts_elements_count; i++) {
+    ies.ie_tsch_timeslot[i] = 100 * i;
+  }
+  ies.ie_channel_hopping_sequence_id = 1;
+  ies.ie_hopping_sequence_len = sizeof(hopping_sequence);
+  memcpy(ies.ie_hopping_sequence_list, hopping_sequence,
+         sizeof(hopping_sequence));
+  ies.ie_tsch_slotframe_and_link.num_slotframes = 1;
+  ies.ie_tsch_slotframe_and_link.slotframe_size = 397;
+  ies.ie_tsch_slotframe_and_link.num_links = 1;
+  ies.ie_tsch_slotframe_and_link.links[0].link_options = 0x0f;
+
+  f->len += frame80215e_create_ie_header_list_termination_1(
+    f->buf + f->len, FRAME_LEN - f->len, &ies);
+  mlme_offset = f->len;
+  f->len += 2;
+  f->len += frame80215e_create_ie_tsch_synchronization(
+    f->buf + f->len, FRAME_LEN - f->len, &ies);
+  f->len += frame80215e_create_ie_tsch_timeslot(
+    f->buf + f->len, FRAME_LEN - f->len, &ies);
+  f->len += frame80215e_create_ie_tsch_channel_hopping_sequence(
+    f->buf + f->len, FRAME_LEN - f->len, &ies);
+  f->len += frame80215e_create_ie_tsch_slotframe_and_link(
+    f->buf + f->len, FRAME_LEN - f->len, &ies);
+  ies.ie_mlme_len = f->len - mlme_offset - 2;
+  frame80215e_create_ie_mlme(f->buf + mlme_offset,
+                             FRAME_LEN - mlme_offset, &ies);
+}
+/*---------------------------------------------------------------------------*/
+/* A data frame with a payload of payload_len bytes */
+static void
+add_data(const char *name, int dest_mode, int payload_len)
+{
+  struct corpus_frame *f;
+  frame802154_t p;
+  int i;
+
+  f = corpus_add(name);
+  init_frame(&p, FRAME802154_DATAFRAME, dest_mode, FRAME802154_LONGADDRMODE);
+  p.fcf.panid_compression = 1;
+  p.fcf.ack_required = dest_mode == FRAME802154_LONGADDRMODE;
+  f->len = frame802154_create(&p, f->buf);
+  for(i = 0; i < payload_len; i++) {
+    f->buf[f->len++] = i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Add the frames of a file, one frame in hex per line */
+static void
+load_corpus(const char *path)
+{
+  struct corpus_frame *f;
+  char line[2 * FRAME_LEN + 16];
+  unsigned byte;
+  char *p;
+  FILE *fp;
+  int loaded;
+
+  fp = fopen(path, "r");
+  if(fp == NULL) {
+    perror(path);
+    exit(1);
+  }
+  loaded = 0;
+  while(fgets(line, sizeof(line), fp) != NULL) {
+    if(line[0] == '#' || line[0] == '\n' || (f = corpus_add(path)) == NULL) {
+      continue;
+    }
+    for(p = line; f->len < FRAME_LEN && sscanf(p, "%2x", &byte) == 1; p += 2) {
+      f->buf[f->len++] = byte;
+    }
+    loaded++;
+  }
+  fclose(fp);
+  printf("%d frames loaded from %s\n", loaded, path);
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+measure(const struct corpus_frame *f)
+{
+  static frame802154_t frame;
+  static struct ieee802154_ies ies;
+  static volatile int sink;
+  clock_time_t start, elapsed;
+  unsigned long parsed;
+  unsigned long best;
+  uint8_t hdr_len;
+  int run;
+  int i;
+
+  best = 0;
+  for(run = 0; run < RUNS; run++) {
+    parsed = 0;
+    start = clock_time();
+    do {
+      for(i = 0; i < BATCH; i++, parsed++) {
+        sink += parse_frame(f->buf, f->buf, f->len, &frame, &ies, &hdr_len);
+      }
+      elapsed = clock_time() - start;
+    } while(elapsed < RUN_TIME);
+    if(parsed * CLOCK_SECOND / elapsed > best) {
+      best = parsed * CLOCK_SECOND / elapsed;
+    }
+  }
+
+  return best;
+}
+/*---------------------------------------------------------------------------*/
+/* Apply one to four random mutations to a frame */
+static int
+mutate(uint8_t *buf, int len)
+{
+  int n;
+
+  for(n = 1 + random() % 4; n > 0; n--) {
+    switch(random() % 5) {
+    case 0:
+      /* Flip a bit */
+      if(len > 0) {
+        buf[random() % len] ^= 1 << (random() % 8);
+      }
+      break;
+    case 1:
+      /* Replace a byte */
+      if(len > 0) {
+        buf[random() % len] = random();
+      }
+      break;
+    case 2:
+      /* Truncate */
+      len = random() % (len + 1);
+      break;
+    case 3:
+      /* Extend with random bytes */
+      while(len < FRAME_LEN && random() % 4) {
+        buf[len++] = random();
+      }
+      break;
+    default:
+      /* Replace an IE descriptor-sized field with a small length */
+      if(len > 1) {
+        buf[random() % (len - 1)] = random() % 32;
+      }
+      break;
+    }
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+fuzz(unsigned long rounds)
+{
+  static uint8_t padded[2][2 * FRAME_LEN];
+  struct parse_result a, b, c;
+  const struct corpus_frame *f;
+  unsigned long accepted, failures;
+  unsigned long round;
+  uint8_t frame[FRAME_LEN];
+  uint8_t *exact;
+  int len;
+  int i;
+
+  accepted = failures = 0;
+  for(round = 0; round < rounds; round++) {
+    if(round % 16 == 0) {
+      /* Now and then, a random frame rather than a mutated one */
+      len = random() % (FRAME_LEN + 1);
+      for(i = 0; i < len; i++) {
+        frame[i] = random();
+      }
+    } else {
+      f = &corpus[random() % corpus_len];
+      memcpy(frame, f->buf, f->len);
+      len = mutate(frame, f->len);
+    }
+
+    /* frame802154_parse() reads the whole MAC header before it checks
+       the frame length, so the header is parsed from copies of the frame
+       followed by two different paddings: any use of the bytes past the
+       end shows as a different result. The IEs are parsed from a buffer
+       of exactly the frame length, where AddressSanitizer catches any
+       read past the end */
+    memset(padded[0], 0x00, sizeof(padded[0]));
+    memset(padded[1], 0xff, sizeof(padded[1]));
+    memcpy(padded[0], frame, len);
+    memcpy(padded[1], frame, len);
+    exact = malloc(len > 0 ? len : 1);
+    memcpy(exact, frame, len);
+    parse(padded[0], exact, len, &a);
+    parse(padded[1], exact, len, &b);
+    parse(padded[1], padded[1], len, &c);
+    free(exact);
+
+    if(a.ret > len) {
+      printf("round %lu: parsed %d bytes of a %d-byte frame\n",
+             round, a.ret, len);
+      failures++;
+    } else if(memcmp(&a, &b, sizeof(a)) != 0 || memcmp(&a, &c, sizeof(a)) != 0) {
+      if(failures < 10) {
+        printf("round %lu: read past the end of a %d-byte frame\n",
+               round, len);
+      }
+      failures++;
+    }
+    if(a.ret > 0) {
+      accepted++;
+    }
+  }
+
+  printf("fuzz: %lu frames, %lu accepted, %lu failures\n",
+         rounds, accepted, failures);
+  return failures != 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(frame_parse_process, ev, data)
+{
+  int failed;
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Start measuring from the main loop, once the system is up */
+  PROCESS_PAUSE();
+
+  add_eack("EACK", 0);
+  add_eack("EACK, MIC-32", FRAME802154_SECURITY_LEVEL_MIC_32);
+  add_eb("EB");
+  add_data("unicast data", FRAME802154_LONGADDRMODE, 80);
+  add_data("broadcast data", FRAME802154_SHORTADDRMODE, 40);
+  if(contiki_argc > 1) {
+    load_corpus(contiki_argv[1]);
+  }
+
+  for(i = 0; i < corpus_len; i++) {
+    printf("%-16s %3u bytes: %9lu frames/s\n",
+           corpus[i].name, corpus[i].len, measure(&corpus[i]));
+  }
+
+  srandom(1);
+  failed = fuzz(FUZZ_ROUNDS);
+
+  exit(failed);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for the native main loop: wakeups per second while
+ *         idle with a 1 s etimer, and the latency of packets written
+ *         every 2 ms to a registered fd, from the write until a process
+ *         polled from the fd callback runs.
+ *
+ *         Build with EPOLL=0 to measure the select() loop instead.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#define IDLE_SECONDS 3
+#define PACKETS      1000
+#define PACKET_SIZE  64
+#define INTERVAL_NS  2000000L
+
+static int fds[2];
+static uint64_t sent_at;
+static uint64_t latency_sum;
+static uint64_t latency_max;
+static int received;
+
+PROCESS(main_loop_process, "Main loop benchmark");
+AUTOSTART_PROCESSES(&main_loop_process);
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static long
+wakeups(void)
+{
+  struct rusage ru;
+
+  /* Every sleep in the main loop is a voluntary context switch */
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_nvcsw;
+}
+/*---------------------------------------------------------------------------*/
+static int
+set_fd(fd_set *rset, fd_set *wset)
+{
+  FD_SET(fds[0], rset);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_fd(fd_set *rset, fd_set *wset)
+{
+  uint8_t packet[PACKET_SIZE];
+
+  if(FD_ISSET(fds[0], rset)) {
+    if(read(fds[0], packet, sizeof(packet)) == sizeof(packet)) {
+      memcpy(&sent_at, packet, sizeof(sent_at));
+      process_poll(&main_loop_process);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const struct select_callback packet_callback = { set_fd, handle_fd };
+/*---------------------------------------------------------------------------*/
+static void
+pollhandler(void)
+{
+  uint64_t latency;
+
+  latency = now_ns() - sent_at;
+  latency_sum += latency;
+  if(latency > latency_max) {
+    latency_max = latency;
+  }
+  received++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packets(void)
+{
+  uint8_t packet[PACKET_SIZE];
+  struct timespec interval;
+  uint64_t t;
+  int i;
+
+  memset(packet, 0, sizeof(packet));
+  interval.tv_sec = 0;
+  interval.tv_nsec = INTERVAL_NS;
+  for(i = 0; i < PACKETS; i++) {
+    nanosleep(&interval, NULL);
+    t = now_ns();
+    memcpy(packet, &t, sizeof(t));
+    if(write(fds[1], packet, sizeof(packet)) != sizeof(packet)) {
+      perror("write");
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(main_loop_process, ev, data)
+{
+  static struct etimer et;
+  static uint64_t start;
+  static long start_wakeups;
+  static int ticks;
+  pid_t pid;
+
+  PROCESS_POLLHANDLER(pollhandler());
+
+  PROCESS_BEGIN();
+
+  /* Start measuring from the main loop, once the system is up. stdin
+     may be always readable, which would keep the loop busy. */
+  PROCESS_PAUSE();
+  select_set_callback(STDIN_FILENO, NULL);
+
+  printf("main loop: %s\n", SELECT_CONF_EPOLL ? "epoll" : "select");
+
+  /* Idle, with one periodic etimer */
+  start = now_ns();
+  start_wakeups = wakeups();
+  etimer_set(&et, CLOCK_SECOND);
+  for(ticks = 0; ticks < IDLE_SECONDS; ticks++) {
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+    etimer_reset(&et);
+  }
+  etimer_stop(&et);
+  printf("idle:    %6lu wakeups/s\n",
+         (unsigned long)((wakeups() - start_wakeups) * 1000000000ULL /
+                         (now_ns() - start)));
+
+  /* Packets from another process */
+  if(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) < 0) {
+    perror("socketpair");
+    exit(1);
+  }
+  if(!select_set_callback(fds[0], &packet_callback)) {
+    printf("fd %d above SELECT_MAX\n", fds[0]);
+    exit(1);
+  }
+  pid = fork();
+  if(pid == 0) {
+    send_packets();
+    _exit(0);
+  }
+  start = now_ns();
+  start_wakeups = wakeups();
+  PROCESS_WAIT_EVENT_UNTIL(received >= PACKETS);
+  printf("packets: %6lu wakeups/s, latency %lu us mean, %lu us max\n",
+         (unsigned long)((wakeups() - start_wakeups) * 1000000000ULL /
+                         (now_ns() - start)),
+         (unsigned long)(latency_sum / PACKETS / 1000),
+         (unsigned long)(latency_max / 1000));
+  waitpid(pid, NULL, 0);
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
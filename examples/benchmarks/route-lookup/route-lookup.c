@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Microbenchmark for uip_ds6_route_lookup(): lookups per second
+ *         with 64, 256 and 1024 host routes installed.
+ *
+ *         Build with ROUTE_INDEX=0 to compare against the list walk.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Each measurement runs batches of lookups for at least this long */
+#define RUN_TIME (CLOCK_SECOND / 2)
+#define BATCH    1000
+
+static const int route_counts[] = { 64, 256, 1024 };
+
+PROCESS(route_lookup_process, "Route lookup benchmark");
+AUTOSTART_PROCESSES(&route_lookup_process);
+/*---------------------------------------------------------------------------*/
+static void
+set_dest(uip_ipaddr_t *addr, int i)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x7400, (i >> 8) + 1, i & 0xff);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int num_routes)
+{
+  uip_ipaddr_t dest;
+  clock_time_t start, elapsed;
+  unsigned long lookups;
+  unsigned long found;
+  int i;
+
+  lookups = 0;
+  found = 0;
+  start = clock_time();
+  do {
+    for(i = 0; i < BATCH; i++, lookups++) {
+      /* Stride through the table so that the move-to-front reordering
+         of the list walk does not get a free hit every time */
+      set_dest(&dest, (lookups * 37) % num_routes);
+      if(uip_ds6_route_lookup(&dest) != NULL) {
+        found++;
+      }
+    }
+    elapsed = clock_time() - start;
+  } while(elapsed < RUN_TIME);
+
+  printf("routes %4d: %lu/%lu found, %lu lookups/s\n",
+         num_routes, found, lookups,
+         lookups * CLOCK_SECOND / elapsed);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(route_lookup_process, ev, data)
+{
+  static uip_ipaddr_t nexthop;
+  static uip_lladdr_t lladdr = { { 0x02, 0x12, 0x74, 0, 0, 0, 0, 0x01 } };
+  uip_ipaddr_t dest;
+  int added;
+  int i;
+
+  PROCESS_BEGIN();
+
+  uip_ip6addr(&nexthop, 0xfe80, 0, 0, 0, 0x0212, 0x7400, 0, 0x0001);
+  if(uip_ds6_nbr_add(&nexthop, &lladdr, 1, NBR_REACHABLE,
+                     NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+    printf("could not add next hop neighbor\n");
+    exit(1);
+  }
+
+  printf("route index %s\n", UIP_DS6_ROUTE_INDEX ? "enabled" : "disabled");
+
+  added = 0;
+  for(i = 0; i < sizeof(route_counts) / sizeof(route_counts[0]); i++) {
+    for(; added < route_counts[i]; added++) {
+      set_dest(&dest, added);
+      if(uip_ds6_route_add(&dest, 128, &nexthop) == NULL) {
+        printf("could not add route %d\n", added);
+        exit(1);
+      }
+    }
+    run(route_counts[i]);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Microbenchmark for the source routing header inserted by a
+ *         RPL non-storing root: downward packets per second through
+ *         rpl_update_header() with 50, 200 and 800 nodes in a binary
+ *         tree, with a static topology and with a parent change every
+ *         100 packets.
+ *
+ *         Build with SRH_CACHE=0 to compare against the source route
+ *         built for every packet, and with NS_HASH=0 to compare against
+ *         the node list walk.
+ */
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/rpl/rpl.h"
+#include "net/rpl/rpl-private.h"
+#include "net/rpl/rpl-dag-root.h"
+#include "net/rpl/rpl-ns.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UIP_IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+/* Each measurement runs batches of packets for at least this long */
+#define RUN_TIME (CLOCK_SECOND / 2)
+#define BATCH    1000
+
+#define PAYLOAD_LEN 32
+
+static const int node_counts[] = { 50, 200, 800 };
+
+static rpl_dag_t *dag;
+
+PROCESS(srh_insert_process, "SRH insertion benchmark");
+AUTOSTART_PROCESSES(&srh_insert_process);
+/*---------------------------------------------------------------------------*/
+static void
+set_node_addr(uip_ipaddr_t *addr, int i)
+{
+  /* Node 0 is the root */
+  if(i == 0) {
+    uip_ipaddr_copy(addr, &dag->dag_id);
+    return;
+  }
+  memcpy(addr, &dag->dag_id, 8);
+  addr->u16[4] = UIP_HTONS(0x0212);
+  addr->u16[5] = UIP_HTONS(0x7400);
+  addr->u16[6] = UIP_HTONS(i >> 8);
+  addr->u16[7] = UIP_HTONS(i & 0xff);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_node(int i, int parent)
+{
+  uip_ipaddr_t child_addr;
+  uip_ipaddr_t parent_addr;
+
+  set_node_addr(&child_addr, i);
+  set_node_addr(&parent_addr, parent);
+  if(rpl_ns_update_node(dag, &child_addr, &parent_addr,
+                        RPL_DEFAULT_LIFETIME) == NULL) {
+    printf("could not add node %d\n", i);
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_packet(int dest)
+{
+  memset(UIP_IP_BUF, 0, UIP_IPH_LEN + UIP_UDPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  UIP_IP_BUF->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &dag->dag_id);
+  set_node_addr(&UIP_IP_BUF->destipaddr, dest);
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uip_ext_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int num_nodes, int churn)
+{
+  clock_time_t start, elapsed;
+  unsigned long packets;
+  unsigned long srh;
+  int i;
+
+  packets = 0;
+  srh = 0;
+  start = clock_time();
+  do {
+    for(i = 0; i < BATCH; i++, packets++) {
+      if(churn && packets % 100 == 0) {
+        /* Move a node between two parents at the same depth */
+        add_node(num_nodes - 1, (num_nodes - 2) / 2 - (packets / 100) % 2);
+      }
+      /* Stride through the nodes, skipping the root */
+      make_packet(1 + (packets * 37) % (num_nodes - 1));
+      if(!rpl_update_header()) {
+        printf("no route to node\n");
+        exit(1);
+      }
+      if(UIP_IP_BUF->proto == UIP_PROTO_ROUTING) {
+        srh++;
+      }
+    }
+    elapsed = clock_time() - start;
+  } while(elapsed < RUN_TIME);
+
+  printf("nodes %3d%s: %lu/%lu with SRH, %lu packets/s\n",
+         num_nodes, churn ? ", parent changes" : "", srh, packets,
+         packets * CLOCK_SECOND / elapsed);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(srh_insert_process, ev, data)
+{
+  int added;
+  int i;
+  int j;
+
+  PROCESS_BEGIN();
+
+  /* Let the platform finish its initialization first */
+  PROCESS_PAUSE();
+
+  if(rpl_dag_root_init_dag_immediately() != 0) {
+    printf("could not create the DAG\n");
+    exit(1);
+  }
+  dag = rpl_get_any_dag();
+
+  printf("SRH cache %d entries, node hash %s\n", RPL_NS_SRH_CACHE_SIZE,
+         RPL_NS_HASH ? "enabled" : "disabled");
+
+  added = 1;
+  for(i = 0; i < sizeof(node_counts) / sizeof(node_counts[0]); i++) {
+    for(; added < node_counts[i]; added++) {
+      add_node(added, (added - 1) / 2);
+    }
+    for(j = 0; j <= 1; j++) {
+      run(node_counts[i], j);
+    }
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
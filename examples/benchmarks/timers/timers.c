@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for etimer and ctimer: cost of arming, stopping and
+ *         expiring thousands of timers.
+ *
+ *         Build with TIMER_HEAP=0 to compare against the etimer list.
+ */
+
+#include "contiki.h"
+#include "sys/etimer.h"
+#include "sys/ctimer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_TIMERS 4000
+/* Each measurement is repeated over this many timers in total, to get
+   well above the 1 ms native clock resolution */
+#define TOTAL_TIMERS 40000
+
+static struct ctimer ctimers[MAX_TIMERS];
+static struct etimer etimers[MAX_TIMERS];
+static int fired;
+
+static const int timer_counts[] = { 100, 1000, 4000 };
+
+PROCESS(timers_process, "Timer benchmark");
+PROCESS(sink_process, "Timer event sink");
+AUTOSTART_PROCESSES(&sink_process, &timers_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == PROCESS_EVENT_TIMER) {
+      fired++;
+    }
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+callback(void *ptr)
+{
+  fired++;
+}
+/*---------------------------------------------------------------------------*/
+/* Run the scheduler until n timers have fired */
+static void
+run_until_fired(int n)
+{
+  while(fired < n) {
+    etimer_request_poll();
+    process_run();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_result(const char *what, int n, clock_time_t elapsed)
+{
+  printf("%-16s %5d timers: %7lu ns/timer\n", what, n,
+         (unsigned long)(elapsed * (1000000000UL / CLOCK_SECOND) /
+                         ((unsigned long)n * (TOTAL_TIMERS / n))));
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int n)
+{
+  clock_time_t arm, stop, expire, start;
+  int round;
+  int i;
+
+  /* Arm and stop ctimers that do not expire during the test */
+  arm = stop = 0;
+  for(round = 0; round < TOTAL_TIMERS / n; round++) {
+    start = clock_time();
+    for(i = 0; i < n; i++) {
+      ctimer_set(&ctimers[i], 1000 * CLOCK_SECOND + (i * 7919) % n,
+                 callback, NULL);
+    }
+    arm += clock_time() - start;
+    start = clock_time();
+    for(i = 0; i < n; i++) {
+      ctimer_stop(&ctimers[i]);
+    }
+    stop += clock_time() - start;
+  }
+  print_result("ctimer arm", n, arm);
+  print_result("ctimer stop", n, stop);
+
+  /* All ctimers expire at once */
+  expire = 0;
+  for(round = 0; round < TOTAL_TIMERS / n; round++) {
+    for(i = 0; i < n; i++) {
+      ctimer_set(&ctimers[i], 0, callback, NULL);
+    }
+    fired = 0;
+    start = clock_time();
+    run_until_fired(n);
+    expire += clock_time() - start;
+  }
+  print_result("ctimer expire", n, expire);
+
+  /* All etimers expire at once, posting events to the sink process */
+  expire = 0;
+  for(round = 0; round < TOTAL_TIMERS / n; round++) {
+    PROCESS_CONTEXT_BEGIN(&sink_process);
+    for(i = 0; i < n; i++) {
+      etimer_set(&etimers[i], 0);
+    }
+    PROCESS_CONTEXT_END(&sink_process);
+    fired = 0;
+    start = clock_time();
+    run_until_fired(n);
+    expire += clock_time() - start;
+  }
+  print_result("etimer expire", n, expire);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(timers_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Start measuring from the main loop, once the system is up */
+  PROCESS_PAUSE();
+
+  printf("etimer heap %s\n", ETIMER_WITH_HEAP ? "enabled" : "disabled");
+
+  for(i = 0; i < sizeof(timer_counts) / sizeof(timer_counts[0]); i++) {
+    run(timer_counts[i]);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for the uip6 UDP demultiplexing: datagrams per
+ *         second through uip_input() with 10, 100 and 1000 UDP
+ *         connections, each bound to its own ephemeral port, and the
+ *         cost of allocating these connections with udp_new().
+ *
+ *         Build with CONN_HASH=0 to measure the connection array walk.
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/ipv6/uip-ds6.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UIP_IP_BUF  ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_UDP_BUF ((struct uip_udp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+
+#define PAYLOAD_LEN  16
+#define PACKET_LEN   (UIP_IPUDPH_LEN + PAYLOAD_LEN)
+/* Each measurement runs batches of datagrams for at least this long */
+#define RUN_TIME     (CLOCK_SECOND / 2)
+#define BATCH        1000
+/* Connections allocated in total for each udp_new measurement */
+#define TOTAL_CONNS  100000
+
+static const int conn_counts[] = { 10, 100, 1000 };
+
+static struct uip_udp_conn *conns[UIP_UDP_CONNS];
+static uint8_t packets[UIP_UDP_CONNS][PACKET_LEN];
+static unsigned long received;
+
+PROCESS(udp_demux_process, "UDP demux benchmark");
+PROCESS(sink_process, "UDP sink");
+AUTOSTART_PROCESSES(&sink_process, &udp_demux_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == tcpip_event && uip_newdata()) {
+      received++;
+    }
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Build a datagram from a neighbor to the local port of conn */
+static void
+build_packet(uint8_t *packet, struct uip_udp_conn *conn)
+{
+  uint16_t sum;
+
+  memset(uip_buf, 0, UIP_LLH_LEN + PACKET_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = PACKET_LEN - UIP_IPH_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfe80, 0, 0, 0, 0x0212, 0x7402, 2, 2);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr,
+                  &uip_ds6_get_link_local(-1)->ipaddr);
+  UIP_UDP_BUF->srcport = UIP_HTONS(5683);
+  UIP_UDP_BUF->destport = conn->lport;
+  UIP_UDP_BUF->udplen = UIP_HTONS(PACKET_LEN - UIP_IPH_LEN);
+  uip_len = PACKET_LEN;
+  sum = ~uip_udpchksum();
+  UIP_UDP_BUF->udpchksum = sum == 0 ? 0xffff : sum;
+  memcpy(packet, &uip_buf[UIP_LLH_LEN], PACKET_LEN);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(int num_conns)
+{
+  clock_time_t start, elapsed;
+  unsigned long sent;
+  int round;
+  int i;
+
+  /* Allocate the connections on behalf of the sink, repeatedly to get
+     well above the 1 ms native clock resolution */
+  start = clock_time();
+  PROCESS_CONTEXT_BEGIN(&sink_process);
+  for(round = 0; round < TOTAL_CONNS / num_conns; round++) {
+    if(round > 0) {
+      for(i = 0; i < num_conns; i++) {
+        uip_udp_remove(conns[i]);
+      }
+    }
+    for(i = 0; i < num_conns; i++) {
+      conns[i] = udp_new(NULL, 0, NULL);
+    }
+  }
+  PROCESS_CONTEXT_END(&sink_process);
+  elapsed = clock_time() - start;
+  printf("%4d connections: udp_new %6lu ns/conn, ", num_conns,
+         (unsigned long)(elapsed * (1000000000UL / CLOCK_SECOND) /
+                         ((unsigned long)num_conns * (TOTAL_CONNS / num_conns))));
+
+  for(i = 0; i < num_conns; i++) {
+    build_packet(packets[i], conns[i]);
+  }
+
+  sent = 0;
+  received = 0;
+  start = clock_time();
+  do {
+    for(i = 0; i < BATCH; i++, sent++) {
+      /* Stride through the connections */
+      memcpy(&uip_buf[UIP_LLH_LEN], packets[(sent * 37) % num_conns],
+             PACKET_LEN);
+      uip_len = PACKET_LEN;
+      uip_input();
+    }
+    elapsed = clock_time() - start;
+  } while(elapsed < RUN_TIME);
+
+  printf("%8lu datagrams/s%s\n", sent * CLOCK_SECOND / elapsed,
+         received == sent ? "" : " (datagrams lost)");
+
+  for(i = 0; i < num_conns; i++) {
+    uip_udp_remove(conns[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(udp_demux_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Start measuring from the main loop, once the system is up */
+  PROCESS_PAUSE();
+
+  printf("connection hash %s\n", UIP_CONN_HASH ? "enabled" : "disabled");
+
+  for(i = 0; i < sizeof(conn_counts) / sizeof(conn_counts[0]); i++) {
+    run(conn_counts[i]);
+  }
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
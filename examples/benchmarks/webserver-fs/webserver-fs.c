@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Benchmark for the httpd-fs lookup: httpd_fs_open() calls per
+ *         second for files that exist and for missing files, on a
+ *         generated site of SITE_FILES css, html, js and png files each.
+ *
+ *         With the hash index (the default), every file except .shtml
+ *         scripts must carry a precomputed header whose Content-Length
+ *         matches the file. Build with FS_INDEX=0 to compare against the
+ *         file list walk.
+ */
+
+#include "contiki.h"
+#include "httpd-fs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAMES       (4 * SITE_FILES)
+#define NAME_LEN    20
+#define BATCH       1000
+#define RUNS        5
+#define RUN_TIME    (CLOCK_SECOND / 10)
+
+static char hits[NAMES][NAME_LEN];
+static char misses[NAMES][NAME_LEN];
+
+PROCESS(webserver_fs_process, "Webserver fs benchmark");
+AUTOSTART_PROCESSES(&webserver_fs_process);
+/*---------------------------------------------------------------------------*/
+static void
+make_names(void)
+{
+  int i;
+
+  for(i = 0; i < SITE_FILES; i++) {
+    sprintf(hits[4 * i], "/css/style%d.css", i);
+    sprintf(hits[4 * i + 1], "/page%d.html", i);
+    sprintf(hits[4 * i + 2], "/js/app%d.js", i);
+    sprintf(hits[4 * i + 3], "/img/icon%d.png", i);
+    sprintf(misses[4 * i], "/css/style%d.cs", i);
+    sprintf(misses[4 * i + 1], "/page%d.htm", i);
+    sprintf(misses[4 * i + 2], "/js/lib%d.js", i);
+    sprintf(misses[4 * i + 3], "/icon%d.png", i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of bytes served for the site, or -1 on error */
+static long
+check(void)
+{
+  struct httpd_fs_file file;
+  long bytes;
+  int i;
+#if HTTPD_FS_INDEX
+  char length[32];
+#endif /* HTTPD_FS_INDEX */
+
+  bytes = 0;
+  for(i = 0; i < NAMES; i++) {
+    if(!httpd_fs_open(hits[i], &file)) {
+      printf("%s: not found\n", hits[i]);
+      return -1;
+    }
+    if(httpd_fs_open(misses[i], &file)) {
+      printf("%s: found\n", misses[i]);
+      return -1;
+    }
+    httpd_fs_open(hits[i], &file);
+#if HTTPD_FS_INDEX
+    sprintf(length, "Content-Length: %d\r\n", file.len);
+    if(file.header_len == 0 ||
+       strncmp(file.data - file.header_len, "HTTP/1.0 200 OK\r\n", 17) != 0 ||
+       strstr(file.data - file.header_len, length) == NULL) {
+      printf("%s: bad header\n", hits[i]);
+      return -1;
+    }
+    bytes += file.header_len;
+#endif /* HTTPD_FS_INDEX */
+    bytes += file.len;
+  }
+  return bytes;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+measure(char names[NAMES][NAME_LEN])
+{
+  static struct httpd_fs_file file;
+  static volatile int sink;
+  clock_time_t start, elapsed;
+  unsigned long opened;
+  unsigned long best;
+  int run;
+  int i;
+
+  best = 0;
+  for(run = 0; run < RUNS; run++) {
+    opened = 0;
+    start = clock_time();
+    do {
+      for(i = 0; i < BATCH; i++, opened++) {
+        sink += httpd_fs_open(names[i % NAMES], &file);
+      }
+      elapsed = clock_time() - start;
+    } while(elapsed < RUN_TIME);
+    if(opened * CLOCK_SECOND / elapsed > best) {
+      best = opened * CLOCK_SECOND / elapsed;
+    }
+  }
+
+  return best;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(webserver_fs_process, ev, data)
+{
+  long bytes;
+
+  PROCESS_BEGIN();
+
+  PROCESS_PAUSE();
+
+  httpd_fs_init();
+  make_names();
+
+  bytes = check();
+  if(bytes < 0) {
+    exit(1);
+  }
+  printf("httpd-fs %s, %d files, %ld bytes served\n",
+         HTTPD_FS_INDEX ? "hash index" : "list walk", NAMES, bytes);
+  printf("  hits:   %lu opens/s\n", measure(hits));
+  printf("  misses: %lu opens/s\n", measure(misses));
+
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -316,6 +316,10 @@ mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
     DBG("APP - Publishing complete.\n");
     break;
   }
+  case MQTT_EVENT_PUBACK_TIMEOUT_ERROR: {
+    DBG("APP - No PUBACK for message %u\n", *((uint16_t *)data));
+    break;
+  }
   default:
     DBG("APP - Application got a unhandled MQTT event: %i\n", event);
     break;
@@ -46,6 +46,9 @@
 
 /* If undefined, the demo will attempt to connect to IBM's quickstart */
 #define MQTT_DEMO_BROKER_IP_ADDR "fd00::1"
+
+/* Queue publishes instead of dropping those made while one is in progress */
+#define MQTT_CONF_PUBLISH_QUEUE_SIZE 4
 /*---------------------------------------------------------------------------*/
 #endif /* PROJECT_CONF_H_ */
 /*---------------------------------------------------------------------------*/
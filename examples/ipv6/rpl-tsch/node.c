@@ -218,6 +218,15 @@ print_network_status(void)
   }
 #endif
 
+#if TSCH_LOCK_STATS
+  PRINTF("- TSCH lock: %lu locks, %lu busy waits (%lu ticks, max %lu), %lu skipped slots\n",
+         (unsigned long)tsch_lock_stats.locks,
+         (unsigned long)tsch_lock_stats.busy_waits,
+         (unsigned long)tsch_lock_stats.wait_ticks,
+         (unsigned long)tsch_lock_stats.max_wait_ticks,
+         (unsigned long)tsch_lock_stats.skipped_slots);
+#endif /* TSCH_LOCK_STATS */
+
   PRINTF("----------------------\n");
 }
 /*---------------------------------------------------------------------------*/
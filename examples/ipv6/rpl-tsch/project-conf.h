@@ -218,6 +218,7 @@ struct app_data {
 #define UIP_CONF_MAX_ROUTES TESTBED_SIZE /* No need for routes */
 #undef NBR_TABLE_CONF_MAX_NEIGHBORS
 #define NBR_TABLE_CONF_MAX_NEIGHBORS TESTBED_SIZE/2
+#define NBR_TABLE_CONF_WITH_HASH 1 /* Neighbor table scales with TESTBED_SIZE */
 #undef RPL_CONF_MOP
 #define RPL_CONF_MOP RPL_MOP_STORING_NO_MULTICAST /* Mode of operation*/
 #undef QUEUEBUF_CONF_NUM
@@ -225,6 +226,15 @@ struct app_data {
 
 #define TSCH_CONF_MAX_INCOMING_PACKETS 8
 
+/* OST and TESLA keep several ctimers per neighbor */
+#define ETIMER_CONF_WITH_HEAP 1
+
+/* Run TSCH pending events and tcpip ahead of the shell and webserver */
+#define PROCESS_CONF_WITH_PRIORITY 1
+
+/* Reassemble fragments in place, in any order */
+#define SICSLOWPAN_CONF_REASS_IN_PLACE 1
+
 #undef TSCH_CONF_MAC_MAX_FRAME_RETRIES
 #define TSCH_CONF_MAC_MAX_FRAME_RETRIES 8
 
@@ -436,6 +446,12 @@ struct app_data {
 #undef LLSEC802154_CONF_USES_FRAME_COUNTER
 #define LLSEC802154_CONF_USES_FRAME_COUNTER 0
 
+#if IOT_LAB_M3
+/* No AES driver for the M3; use the table-driven AES, which suits its
+   32-bit core */
+#define AES_128_CONF aes_128_ttable_driver
+#endif /* IOT_LAB_M3 */
+
 #endif /* WITH_SECURITY */
 
 #if WITH_ORCHESTRA
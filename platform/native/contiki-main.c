@@ -78,15 +78,87 @@
 #define SELECT_MAX 8
 #endif
 
+/* Wait for fds and timers with epoll instead of select (Linux only).
+   The loop then sleeps until the next etimer expires or until a
+   registered fd becomes ready, and only the callbacks of ready fds
+   are run. */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#else
+#define SELECT_EPOLL 0
+#endif
+
+/* Longest sleep with epoll, in ms (-1 for no limit). Bounds how late
+   set_fd() callbacks that depend on plain timers are polled. */
+#ifdef SELECT_CONF_EPOLL_MAX_WAIT
+#define SELECT_EPOLL_MAX_WAIT SELECT_CONF_EPOLL_MAX_WAIT
+#else
+#define SELECT_EPOLL_MAX_WAIT 1000
+#endif
+
+#if SELECT_EPOLL
+#ifndef __linux__
+#error SELECT_CONF_EPOLL requires Linux
+#endif /* __linux__ */
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif /* SELECT_EPOLL */
+
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+#if SELECT_EPOLL
+static int epoll_fd = -1;
+static int timer_fd = -1;
+static clock_time_t timer_deadline;
+/* The epoll events currently requested for each fd */
+static uint32_t select_events[SELECT_MAX];
+/* Fds that epoll cannot wait for, such as regular files, are always
+   ready and are handled on every iteration instead */
+static uint8_t select_always_ready[SELECT_MAX];
+#endif /* SELECT_EPOLL */
+
 SENSORS(&pir_sensor, &vib_sensor, &button_sensor);
 
 static uint8_t serial_id[] = {0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08};
 #if !NETSTACK_CONF_WITH_IPV6
 static uint16_t node_id = 0x0102;
 #endif /* !NETSTACK_CONF_WITH_IPV6 */
+#if SELECT_EPOLL
+/*---------------------------------------------------------------------------*/
+static void
+epoll_init(void)
+{
+  struct epoll_event ev;
+
+  if(epoll_fd >= 0) {
+    return;
+  }
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(epoll_fd < 0) {
+    perror("epoll_create1");
+    exit(1);
+  }
+
+  /* Armed with the time left to the next etimer expiration, so that
+     it neither follows wall clock changes nor depends on the width of
+     clock_time_t */
+  timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if(timer_fd < 0) {
+    perror("timerfd_create");
+    exit(1);
+  }
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = timer_fd;
+  if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) < 0) {
+    perror("epoll_ctl");
+    exit(1);
+  }
+  timer_deadline = 0;
+}
+#endif /* SELECT_EPOLL */
 /*---------------------------------------------------------------------------*/
 int
 select_set_callback(int fd, const struct select_callback *callback)
@@ -99,6 +171,28 @@ select_set_callback(int fd, const struct select_callback *callback)
       callback = NULL;
     }
 
+#if SELECT_EPOLL
+    if(select_callback[fd] != NULL && !select_always_ready[fd]) {
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    }
+    select_events[fd] = 0;
+    select_always_ready[fd] = 0;
+    if(callback != NULL) {
+      struct epoll_event ev;
+
+      epoll_init();
+      memset(&ev, 0, sizeof(ev));
+      ev.data.fd = fd;
+      if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        if(errno != EPERM) {
+          perror("epoll_ctl");
+          return 0;
+        }
+        select_always_ready[fd] = 1;
+      }
+    }
+#endif /* SELECT_EPOLL */
+
     select_callback[fd] = callback;
 
     /* Update fd max */
@@ -139,6 +233,142 @@ stdin_handle_fd(fd_set *rset, fd_set *wset)
 const static struct select_callback stdin_fd = {
   stdin_set_fd, stdin_handle_fd
 };
+#if SELECT_EPOLL
+/*---------------------------------------------------------------------------*/
+/* Arm the timerfd for the next etimer expiration, if it has changed */
+static void
+epoll_update_timer(void)
+{
+  struct itimerspec its;
+  clock_time_t deadline;
+  clock_time_t now;
+
+  deadline = etimer_pending() ? etimer_next_expiration_time() : 0;
+  if(deadline == timer_deadline) {
+    return;
+  }
+  timer_deadline = deadline;
+
+  memset(&its, 0, sizeof(its));
+  if(deadline != 0) {
+    now = clock_time();
+    if((long)(deadline - now) > 0) {
+      its.it_value.tv_sec = (deadline - now) / 1000;
+      its.it_value.tv_nsec = ((deadline - now) % 1000) * 1000000;
+    } else {
+      /* Already expired: fire right away, as a zero value disarms */
+      its.it_value.tv_nsec = 1;
+    }
+  }
+  /* A zero it_value, when no etimer is pending, disarms the timer */
+  timerfd_settime(timer_fd, 0, &its, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Ask the callbacks which fds they wait for, and pass the changes on
+   to epoll. Returns the number of always ready fds waited for. */
+static int
+epoll_update_fds(void)
+{
+  fd_set fdr;
+  fd_set fdw;
+  struct epoll_event ev;
+  int always_ready;
+  int i;
+
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  always_ready = 0;
+  for(i = 0; i <= select_max; i++) {
+    if(select_callback[i] == NULL) {
+      continue;
+    }
+    memset(&ev, 0, sizeof(ev));
+    if(select_callback[i]->set_fd(&fdr, &fdw)) {
+      if(FD_ISSET(i, &fdr)) {
+        ev.events |= EPOLLIN;
+      }
+      if(FD_ISSET(i, &fdw)) {
+        ev.events |= EPOLLOUT;
+      }
+    }
+    if(select_always_ready[i]) {
+      always_ready += ev.events != 0;
+    } else if(ev.events != select_events[i]) {
+      ev.data.fd = i;
+      if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, i, &ev) < 0) {
+        perror("epoll_ctl");
+      }
+    }
+    select_events[i] = ev.events;
+  }
+  return always_ready;
+}
+/*---------------------------------------------------------------------------*/
+static void
+epoll_handle_fd(int fd, uint32_t events)
+{
+  fd_set fdr;
+  fd_set fdw;
+
+  if(fd < 0 || fd >= SELECT_MAX || select_callback[fd] == NULL) {
+    return;
+  }
+  /* As with select(), errors and hangups make the fd ready for
+     whatever it was waited for */
+  if(events & (EPOLLERR | EPOLLHUP)) {
+    events |= select_events[fd];
+  }
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  if(events & EPOLLIN) {
+    FD_SET(fd, &fdr);
+  }
+  if(events & EPOLLOUT) {
+    FD_SET(fd, &fdw);
+  }
+  select_callback[fd]->handle_fd(&fdr, &fdw);
+}
+/*---------------------------------------------------------------------------*/
+static void
+epoll_wait_events(int pending)
+{
+  struct epoll_event events[SELECT_MAX + 1];
+  uint64_t expirations;
+  int always_ready;
+  int n;
+  int i;
+
+  epoll_update_timer();
+  always_ready = epoll_update_fds();
+
+  n = epoll_wait(epoll_fd, events, SELECT_MAX + 1,
+                 pending || always_ready ? 0 : SELECT_EPOLL_MAX_WAIT);
+  if(n < 0) {
+    if(errno != EINTR) {
+      perror("epoll_wait");
+    }
+    n = 0;
+  }
+
+  for(i = 0; i < n; i++) {
+    if(events[i].data.fd == timer_fd) {
+      if(read(timer_fd, &expirations, sizeof(expirations)) < 0) {
+        /* Already read, or rearmed since */
+      }
+    } else {
+      epoll_handle_fd(events[i].data.fd, events[i].events);
+    }
+  }
+
+  if(always_ready) {
+    for(i = 0; i <= select_max; i++) {
+      if(select_always_ready[i] && select_events[i] != 0) {
+        epoll_handle_fd(i, select_events[i]);
+      }
+    }
+  }
+}
+#endif /* SELECT_EPOLL */
 /*---------------------------------------------------------------------------*/
 static void
 set_rime_addr(void)
@@ -249,17 +479,25 @@ main(int argc, char **argv)
   /* Make standard output unbuffered. */
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
 
+#if SELECT_EPOLL
+  epoll_init();
+#endif /* SELECT_EPOLL */
   select_set_callback(STDIN_FILENO, &stdin_fd);
   while(1) {
+    int retval;
+#if !SELECT_EPOLL
     fd_set fdr;
     fd_set fdw;
     int maxfd;
     int i;
-    int retval;
     struct timeval tv;
+#endif /* !SELECT_EPOLL */
 
     retval = process_run();
 
+#if SELECT_EPOLL
+    epoll_wait_events(retval);
+#else /* SELECT_EPOLL */
     tv.tv_sec = 0;
     tv.tv_usec = retval ? 1 : 1000;
 
@@ -285,6 +523,7 @@ main(int argc, char **argv)
         }
       }
     }
+#endif /* SELECT_EPOLL */
 
     etimer_request_poll();
 
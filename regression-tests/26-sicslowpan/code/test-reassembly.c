@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         Replays 6lowpan fragment traces, in and out of order, through
+ *         the in-place reassembly of sicslowpan-reass.c
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "net/ipv6/sicslowpan-reass.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+PROCESS(test_process, "sicslowpan-reass.c test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* First fragment, as uncompressed, then the size of the others */
+#define FIRST_LEN    112
+#define FRAG_LEN      48
+#define DATAGRAM_LEN (FIRST_LEN + 5 * FRAG_LEN + 40)
+#define NUM_FRAGS      7
+
+struct frag {
+  uint16_t offset;
+  uint16_t len;
+};
+
+static uint8_t datagram[DATAGRAM_LEN];
+static struct frag frags[NUM_FRAGS];
+static const linkaddr_t sender_a = { { 0x0a } };
+static const linkaddr_t sender_b = { { 0x0b } };
+static const linkaddr_t sender_c = { { 0x0c } };
+static struct etimer et;
+
+UNIT_TEST_REGISTER(in_order, "Fragments in order");
+UNIT_TEST_REGISTER(reverse_order, "Fragments in reverse order");
+UNIT_TEST_REGISTER(shuffled, "Shuffled fragments with duplicates");
+UNIT_TEST_REGISTER(overlap, "Overlapping fragment discards the datagram");
+UNIT_TEST_REGISTER(extraneous, "Extraneous bytes in the last fragment");
+UNIT_TEST_REGISTER(interleaved, "Interleaved datagrams");
+UNIT_TEST_REGISTER(no_context, "No free context");
+UNIT_TEST_REGISTER(timeout, "Context expiry");
+
+/*---------------------------------------------------------------------------*/
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: at line %u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_trace(uint8_t seed)
+{
+  int i;
+
+  for(i = 0; i < DATAGRAM_LEN; i++) {
+    datagram[i] = seed + i * 7;
+  }
+  frags[0].offset = 0;
+  frags[0].len = FIRST_LEN;
+  for(i = 1; i < NUM_FRAGS; i++) {
+    frags[i].offset = frags[i - 1].offset + frags[i - 1].len;
+    frags[i].len = FRAG_LEN;
+  }
+  /* The last fragment is a short one */
+  frags[NUM_FRAGS - 1].len = DATAGRAM_LEN - frags[NUM_FRAGS - 1].offset;
+}
+/*---------------------------------------------------------------------------*/
+/* Deliver a fragment the way sicslowpan.c does: the first one is
+   uncompressed in place, the others are copied from the frame */
+static int
+deliver(const linkaddr_t *sender, uint16_t tag, const struct frag *f)
+{
+  int context;
+
+  context = sicslowpan_reass_find(sender, tag, DATAGRAM_LEN);
+  if(context < 0) {
+    return -1;
+  }
+  if(f->offset == 0) {
+    memcpy(sicslowpan_reass_buf(context), datagram, f->len);
+    return sicslowpan_reass_add(context, 0, NULL, f->len);
+  }
+  return sicslowpan_reass_add(context, f->offset,
+                              datagram + f->offset, f->len);
+}
+/*---------------------------------------------------------------------------*/
+/* Check the reassembled datagram and free its context */
+static int
+check_datagram(const linkaddr_t *sender, uint16_t tag)
+{
+  int context;
+  int ok;
+
+  context = sicslowpan_reass_find(sender, tag, DATAGRAM_LEN);
+  if(context < 0) {
+    return 0;
+  }
+  ok = memcmp(sicslowpan_reass_buf(context), datagram, DATAGRAM_LEN) == 0;
+  sicslowpan_reass_free(context);
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+static int
+replay(const linkaddr_t *sender, uint16_t tag, const uint8_t *order, int n)
+{
+  int i;
+  int ret;
+
+  ret = SICSLOWPAN_REASS_ERR;
+  for(i = 0; i < n; i++) {
+    ret = deliver(sender, tag, &frags[order[i]]);
+    if(i < n - 1 && ret != SICSLOWPAN_REASS_INCOMPLETE &&
+       ret != SICSLOWPAN_REASS_DUPLICATE) {
+      return -1;
+    }
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(in_order)
+{
+  static const uint8_t order[] = { 0, 1, 2, 3, 4, 5, 6 };
+
+  UNIT_TEST_BEGIN();
+
+  sicslowpan_reass_init();
+  make_trace(1);
+  UNIT_TEST_ASSERT(replay(&sender_a, 1, order, sizeof(order))
+                   == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(check_datagram(&sender_a, 1));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(reverse_order)
+{
+  static const uint8_t order[] = { 6, 5, 4, 3, 2, 1, 0 };
+
+  UNIT_TEST_BEGIN();
+
+  sicslowpan_reass_init();
+  make_trace(2);
+  UNIT_TEST_ASSERT(replay(&sender_a, 2, order, sizeof(order))
+                   == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(check_datagram(&sender_a, 2));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(shuffled)
+{
+  static const uint8_t orders[][10] = {
+    { 3, 0, 3, 6, 1, 0, 5, 2, 4, 7 },
+    { 5, 5, 2, 6, 0, 4, 1, 6, 3, 7 },
+    { 1, 4, 0, 2, 6, 2, 4, 5, 3, 7 },
+    { 6, 1, 6, 3, 5, 0, 2, 1, 4, 7 },
+  };
+  int i;
+  int j;
+  int ret;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+    sicslowpan_reass_init();
+    make_trace(3 + i);
+    ret = SICSLOWPAN_REASS_ERR;
+    /* Each trace ends with 7, which marks the end */
+    for(j = 0; orders[i][j] != 7; j++) {
+      ret = deliver(&sender_a, 3 + i, &frags[orders[i][j]]);
+      UNIT_TEST_ASSERT(ret != SICSLOWPAN_REASS_ERR &&
+                       ret != SICSLOWPAN_REASS_DISCARDED);
+    }
+    UNIT_TEST_ASSERT(ret == SICSLOWPAN_REASS_COMPLETE);
+    UNIT_TEST_ASSERT(check_datagram(&sender_a, 3 + i));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(overlap)
+{
+  static const uint8_t order[] = { 0, 2, 4 };
+  static const uint8_t rest[] = { 5, 4, 3, 2, 1, 0 };
+  struct frag f;
+
+  UNIT_TEST_BEGIN();
+
+  sicslowpan_reass_init();
+  make_trace(10);
+  UNIT_TEST_ASSERT(replay(&sender_a, 10, order, sizeof(order))
+                   == SICSLOWPAN_REASS_INCOMPLETE);
+
+  /* Same offset as fragment 2, but a different size */
+  f.offset = frags[2].offset;
+  f.len = frags[2].len - 8;
+  UNIT_TEST_ASSERT(deliver(&sender_a, 10, &f) == SICSLOWPAN_REASS_DISCARDED);
+
+  /* Straddling fragments 3 and 4 */
+  UNIT_TEST_ASSERT(replay(&sender_a, 10, order, sizeof(order))
+                   == SICSLOWPAN_REASS_INCOMPLETE);
+  f.offset = frags[3].offset + 8;
+  f.len = frags[3].len;
+  UNIT_TEST_ASSERT(deliver(&sender_a, 10, &f) == SICSLOWPAN_REASS_DISCARDED);
+
+  /* The datagram can still be received in full afterwards */
+  UNIT_TEST_ASSERT(deliver(&sender_a, 10, &frags[6])
+                   == SICSLOWPAN_REASS_INCOMPLETE);
+  UNIT_TEST_ASSERT(replay(&sender_a, 10, rest, sizeof(rest))
+                   == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(check_datagram(&sender_a, 10));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(extraneous)
+{
+  static const uint8_t order[] = { 1, 0, 2, 3, 4, 5 };
+  struct frag f;
+
+  UNIT_TEST_BEGIN();
+
+  sicslowpan_reass_init();
+  make_trace(11);
+  UNIT_TEST_ASSERT(replay(&sender_a, 11, order, sizeof(order))
+                   == SICSLOWPAN_REASS_INCOMPLETE);
+  f = frags[NUM_FRAGS - 1];
+  f.len += 4;
+  UNIT_TEST_ASSERT(deliver(&sender_a, 11, &f) == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(check_datagram(&sender_a, 11));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(interleaved)
+{
+  static const uint8_t order_a[] = { 4, 2, 0, 6, 1, 3, 5 };
+  static const uint8_t order_b[] = { 6, 5, 0, 1, 3, 2, 4 };
+  int i;
+  int ret_a;
+  int ret_b;
+
+  UNIT_TEST_BEGIN();
+
+  sicslowpan_reass_init();
+  make_trace(12);
+  ret_a = ret_b = SICSLOWPAN_REASS_ERR;
+  for(i = 0; i < NUM_FRAGS; i++) {
+    ret_a = deliver(&sender_a, 12, &frags[order_a[i]]);
+    /* Same tag, other sender */
+    ret_b = deliver(&sender_b, 12, &frags[order_b[i]]);
+  }
+  UNIT_TEST_ASSERT(ret_a == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(ret_b == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(check_datagram(&sender_a, 12));
+  UNIT_TEST_ASSERT(check_datagram(&sender_b, 12));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(no_context)
+{
+  UNIT_TEST_BEGIN();
+
+  sicslowpan_reass_init();
+  make_trace(13);
+  UNIT_TEST_ASSERT(deliver(&sender_a, 13, &frags[1])
+                   == SICSLOWPAN_REASS_INCOMPLETE);
+  UNIT_TEST_ASSERT(deliver(&sender_b, 13, &frags[1])
+                   == SICSLOWPAN_REASS_INCOMPLETE);
+  UNIT_TEST_ASSERT(sicslowpan_reass_find(&sender_c, 13, DATAGRAM_LEN) < 0);
+  UNIT_TEST_ASSERT(sicslowpan_reass_find(&sender_a, 13,
+                                         SICSLOWPAN_REASS_BUF_SIZE + 1) < 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(timeout)
+{
+  static const uint8_t first[] = { 0, 1, 2 };
+  static const uint8_t rest[] = { 3, 4, 5, 6 };
+  static const uint8_t all[] = { 0, 1, 2, 3, 4, 5, 6 };
+
+  UNIT_TEST_BEGIN();
+
+  /* Checked once the context has timed out, see the test process */
+  UNIT_TEST_ASSERT(replay(&sender_c, 14, rest, sizeof(rest))
+                   == SICSLOWPAN_REASS_INCOMPLETE);
+  UNIT_TEST_ASSERT(replay(&sender_c, 14, first, sizeof(first))
+                   == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(check_datagram(&sender_c, 14));
+  UNIT_TEST_ASSERT(replay(&sender_c, 14, all, sizeof(all))
+                   == SICSLOWPAN_REASS_COMPLETE);
+  UNIT_TEST_ASSERT(check_datagram(&sender_c, 14));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static const uint8_t first[] = { 0, 1, 2 };
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(in_order);
+  UNIT_TEST_RUN(reverse_order);
+  UNIT_TEST_RUN(shuffled);
+  UNIT_TEST_RUN(overlap);
+  UNIT_TEST_RUN(extraneous);
+  UNIT_TEST_RUN(interleaved);
+  UNIT_TEST_RUN(no_context);
+
+  /* Start a datagram and let it time out */
+  sicslowpan_reass_init();
+  make_trace(14);
+  replay(&sender_c, 14, first, sizeof(first));
+  etimer_set(&et, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16 + CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  UNIT_TEST_RUN(timeout);
+
+  printf("=check-me= DONE\n");
+#if CONTIKI_TARGET_NATIVE
+  /* The native test runs on its own, let the Makefile go on */
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+  PROCESS_END();
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Fuzzes crc16_data() and uip_chksum_add() against straightforward
+ *         byte-at-a-time implementations, with random data, lengths,
+ *         alignments and initial values
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+#include "net/ip/uip-chksum.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+PROCESS(test_process, "Checksum fuzzer");
+AUTOSTART_PROCESSES(&test_process);
+
+#define ROUNDS   20000
+#define MAX_LEN   1500
+#define MAX_SKEW    16
+
+static uint8_t buf[MAX_LEN + MAX_SKEW];
+
+UNIT_TEST_REGISTER(crc16, "crc16_data");
+UNIT_TEST_REGISTER(chksum, "uip_chksum_add");
+UNIT_TEST_REGISTER(chksum_split, "uip_chksum_add in pieces");
+
+/*---------------------------------------------------------------------------*/
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: at line %u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned short
+ref_crc16(const uint8_t *data, int len, unsigned short acc)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    acc ^= data[i];
+    acc = (acc >> 8) | (acc << 8);
+    acc ^= (acc & 0xff00) << 4;
+    acc ^= (acc >> 8) >> 4;
+    acc ^= (acc & 0xff00) >> 5;
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+ref_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  uint16_t i;
+
+  for(i = 0; i < len; i += 2) {
+    t = data[i] << 8;
+    if(i + 1 < len) {
+      t += data[i + 1];
+    }
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+/* Fills the buffer with random bytes, or with runs of 0x00 and 0xff
+   that exercise the carries */
+static void
+fill(int round)
+{
+  int i;
+
+  for(i = 0; i < sizeof(buf); i++) {
+    switch(round % 4) {
+    case 0:
+      buf[i] = 0x00;
+      break;
+    case 1:
+      buf[i] = 0xff;
+      break;
+    default:
+      buf[i] = random_rand();
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+random_len(void)
+{
+  /* Mostly frame-sized, sometimes up to a full IPv6 packet */
+  if(random_rand() & 1) {
+    return random_rand() % 128;
+  }
+  return random_rand() % (MAX_LEN + 1);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(crc16)
+{
+  unsigned short acc;
+  uint16_t len;
+  int skew;
+  int round;
+
+  UNIT_TEST_BEGIN();
+
+  for(round = 0; round < ROUNDS; round++) {
+    if(round % 64 == 0) {
+      fill(round / 64);
+    }
+    skew = random_rand() % MAX_SKEW;
+    len = random_len();
+    acc = random_rand();
+    UNIT_TEST_ASSERT(crc16_data(buf + skew, len, acc)
+                     == ref_crc16(buf + skew, len, acc));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(chksum)
+{
+  uint16_t sum;
+  uint16_t len;
+  int skew;
+  int round;
+
+  UNIT_TEST_BEGIN();
+
+  for(round = 0; round < ROUNDS; round++) {
+    if(round % 64 == 0) {
+      fill(round / 64);
+    }
+    skew = random_rand() % MAX_SKEW;
+    len = random_len();
+    switch(round % 3) {
+    case 0:
+      sum = 0;
+      break;
+    case 1:
+      sum = 0xffff;
+      break;
+    default:
+      sum = random_rand();
+      break;
+    }
+    UNIT_TEST_ASSERT(uip_chksum_add(sum, buf + skew, len)
+                     == ref_chksum(sum, buf + skew, len));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* upper_layer_chksum() adds the pseudo-header and the payload in
+   separate calls; the pieces must add up to the sum of the whole */
+UNIT_TEST(chksum_split)
+{
+  uint16_t sum;
+  uint16_t len;
+  uint16_t cut;
+  int skew;
+  int round;
+
+  UNIT_TEST_BEGIN();
+
+  for(round = 0; round < ROUNDS; round++) {
+    if(round % 64 == 0) {
+      fill(round / 64);
+    }
+    skew = random_rand() % MAX_SKEW;
+    len = random_len() & ~1;
+    cut = len == 0 ? 0 : (random_rand() % len) & ~1;
+    sum = uip_chksum_add(0, buf + skew, cut);
+    sum = uip_chksum_add(sum, buf + skew + cut, len - cut);
+    UNIT_TEST_ASSERT(sum == ref_chksum(0, buf + skew, len));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test, CRC16_SLICES %d\n", CRC16_SLICES);
+  printf("---\n");
+
+  UNIT_TEST_RUN(crc16);
+  UNIT_TEST_RUN(chksum);
+  UNIT_TEST_RUN(chksum_split);
+
+  printf("=check-me= DONE\n");
+#if CONTIKI_TARGET_NATIVE
+  /* The native test runs on its own, let the Makefile go on */
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+  PROCESS_END();
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Round-trips packets of every length through queuebufs, and
+ *         checks that queued data stays in place and full frames fit
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+PROCESS(test_process, "Queuebuf test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define MAX_LEN     127
+#define SMALL_LEN    10
+
+/* Number of full frames that can be queued at once */
+#if QUEUEBUF_COMPACT
+#define FULL_NUM QUEUEBUF_LARGE_NUM
+#else /* QUEUEBUF_COMPACT */
+#define FULL_NUM QUEUEBUF_NUM
+#endif /* QUEUEBUF_COMPACT */
+
+UNIT_TEST_REGISTER(roundtrip, "queuebuf round-trip, lengths 0 to 127");
+UNIT_TEST_REGISTER(attr_room, "set_queuebuf_attr on a queued packet");
+UNIT_TEST_REGISTER(full_frames, "full frames in the large chunks");
+
+/*---------------------------------------------------------------------------*/
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: at line %u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_link_selector(uint8_t type)
+{
+  return type == PACKETBUF_ATTR_TSCH_SLOTFRAME
+    || type == PACKETBUF_ATTR_TSCH_TIMESLOT;
+}
+/*---------------------------------------------------------------------------*/
+/* The value of attribute type in the packet of length len, zero for
+   about two thirds of them */
+static packetbuf_attr_t
+attr_value(int len, uint8_t type)
+{
+  if(type == PACKETBUF_ATTR_NONE || is_link_selector(type)
+     || (len + type) % 3 != 0) {
+    return 0;
+  }
+  return (len << 6) + type;
+}
+/*---------------------------------------------------------------------------*/
+static void
+addr_value(int len, uint8_t type, linkaddr_t *addr)
+{
+  uint8_t i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    addr->u8[i] = len + type * 16 + i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Fills the packetbuf with the packet of length len */
+static void
+make_packet(int len)
+{
+  uint8_t data[MAX_LEN];
+  linkaddr_t addr;
+  uint8_t type;
+  int i;
+
+  for(i = 0; i < len; i++) {
+    data[i] = len ^ (i * 7);
+  }
+  packetbuf_clear();
+  packetbuf_copyfrom(data, len);
+  for(type = 0; type < PACKETBUF_NUM_ATTRS; type++) {
+    packetbuf_set_attr(type, attr_value(len, type));
+  }
+  for(type = PACKETBUF_ADDR_FIRST;
+      type < PACKETBUF_ADDR_FIRST + PACKETBUF_NUM_ADDRS; type++) {
+    addr_value(len, type, &addr);
+    packetbuf_set_addr(type, &addr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Checks that data holds the packet of length len */
+static int
+data_ok(int len, const uint8_t *data)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    if(data[i] != (uint8_t)(len ^ (i * 7))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Checks the attributes and addresses of the packet of length len,
+   with its link selector set to len + 1 and len + 2, in a queuebuf or
+   in the packetbuf if q is NULL */
+static int
+attrs_ok(int len, struct queuebuf *q)
+{
+  packetbuf_attr_t expected;
+  packetbuf_attr_t val;
+  linkaddr_t addr;
+  const linkaddr_t *a;
+  uint8_t type;
+
+  for(type = 0; type < PACKETBUF_NUM_ATTRS; type++) {
+    expected = attr_value(len, type);
+    if(type == PACKETBUF_ATTR_TSCH_SLOTFRAME) {
+      expected = len + 1;
+    } else if(type == PACKETBUF_ATTR_TSCH_TIMESLOT) {
+      expected = len + 2;
+    }
+    val = q != NULL ? queuebuf_attr(q, type) : packetbuf_attr(type);
+    if(val != expected) {
+      printf("length %d: attribute %u is %u, not %u\n",
+             len, type, val, expected);
+      return 0;
+    }
+  }
+  for(type = PACKETBUF_ADDR_FIRST;
+      type < PACKETBUF_ADDR_FIRST + PACKETBUF_NUM_ADDRS; type++) {
+    addr_value(len, type, &addr);
+    a = q != NULL ? queuebuf_addr(q, type) : packetbuf_addr(type);
+    if(!linkaddr_cmp(a, &addr)) {
+      printf("length %d: address %u differs\n", len, type);
+      return 0;
+    }
+    /* linkaddr_t may be read as a uint16_t */
+    if(((uintptr_t)a & (sizeof(uint16_t) - 1)) != 0) {
+      printf("length %d: address %u is not aligned\n", len, type);
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(roundtrip)
+{
+  struct queuebuf *q;
+  void *dataptr;
+  int len;
+
+  UNIT_TEST_BEGIN();
+
+  for(len = 0; len <= MAX_LEN; len++) {
+    make_packet(len);
+    q = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(q != NULL);
+    dataptr = queuebuf_dataptr(q);
+
+    /* OST sets the link selector of packets already queued */
+    UNIT_TEST_ASSERT(set_queuebuf_attr(q, PACKETBUF_ATTR_TSCH_SLOTFRAME,
+                                       len + 1));
+    UNIT_TEST_ASSERT(set_queuebuf_attr(q, PACKETBUF_ATTR_TSCH_TIMESLOT,
+                                       len + 2));
+    UNIT_TEST_ASSERT(queuebuf_dataptr(q) == dataptr);
+
+    UNIT_TEST_ASSERT(queuebuf_datalen(q) == len);
+    UNIT_TEST_ASSERT(data_ok(len, queuebuf_dataptr(q)));
+    UNIT_TEST_ASSERT(attrs_ok(len, q));
+
+    packetbuf_clear();
+    queuebuf_to_packetbuf(q);
+    UNIT_TEST_ASSERT(packetbuf_totlen() == len);
+    UNIT_TEST_ASSERT(data_ok(len, packetbuf_dataptr()));
+    UNIT_TEST_ASSERT(attrs_ok(len, NULL));
+
+    queuebuf_free(q);
+    UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Setting attributes that were zero on a queued packet either fits in
+   place or is refused, leaving the packet as it was */
+UNIT_TEST(attr_room)
+{
+  struct queuebuf *q;
+  void *dataptr;
+  uint8_t type;
+  int set;
+
+  UNIT_TEST_BEGIN();
+
+  packetbuf_clear();
+  packetbuf_copyfrom("0123456789", SMALL_LEN);
+  q = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(q != NULL);
+  dataptr = queuebuf_dataptr(q);
+
+  set = 0;
+  for(type = PACKETBUF_ATTR_NONE + 1; type < PACKETBUF_NUM_ATTRS; type++) {
+    if(is_link_selector(type)) {
+      continue;
+    }
+    if(set_queuebuf_attr(q, type, type)) {
+      set++;
+    } else {
+      UNIT_TEST_ASSERT(queuebuf_attr(q, type) == 0);
+    }
+    UNIT_TEST_ASSERT(queuebuf_dataptr(q) == dataptr);
+    UNIT_TEST_ASSERT(memcmp(dataptr, "0123456789", SMALL_LEN) == 0);
+  }
+#if QUEUEBUF_COMPACT
+  UNIT_TEST_ASSERT(set >= QUEUEBUF_ATTR_ROOM);
+#else /* QUEUEBUF_COMPACT */
+  UNIT_TEST_ASSERT(set == PACKETBUF_NUM_ATTRS - 3);
+#endif /* QUEUEBUF_COMPACT */
+
+  /* The link selector always has room */
+  UNIT_TEST_ASSERT(set_queuebuf_attr(q, PACKETBUF_ATTR_TSCH_SLOTFRAME, 1));
+  UNIT_TEST_ASSERT(set_queuebuf_attr(q, PACKETBUF_ATTR_TSCH_TIMESLOT, 2));
+  UNIT_TEST_ASSERT(queuebuf_attr(q, PACKETBUF_ATTR_TSCH_SLOTFRAME) == 1);
+  UNIT_TEST_ASSERT(queuebuf_attr(q, PACKETBUF_ATTR_TSCH_TIMESLOT) == 2);
+  UNIT_TEST_ASSERT(queuebuf_dataptr(q) == dataptr);
+
+  queuebuf_free(q);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Full frames fit in the large chunks, and small frames fill the
+   remaining queuebufs */
+UNIT_TEST(full_frames)
+{
+  struct queuebuf *q[QUEUEBUF_NUM];
+  int full;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(full = 0; full <= FULL_NUM; full++) {
+    for(i = 0; i < QUEUEBUF_NUM; i++) {
+      make_packet(i < full ? MAX_LEN : SMALL_LEN);
+      q[i] = queuebuf_new_from_packetbuf();
+      UNIT_TEST_ASSERT(q[i] != NULL);
+    }
+    UNIT_TEST_ASSERT(queuebuf_numfree() == 0);
+    for(i = 0; i < QUEUEBUF_NUM; i++) {
+      UNIT_TEST_ASSERT(data_ok(i < full ? MAX_LEN : SMALL_LEN,
+                               queuebuf_dataptr(q[i])));
+      queuebuf_free(q[i]);
+    }
+  }
+
+#if QUEUEBUF_COMPACT
+  /* Once the large chunks are taken, a full frame is refused */
+  for(i = 0; i <= FULL_NUM; i++) {
+    make_packet(MAX_LEN);
+    q[i] = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT((q[i] != NULL) == (i < FULL_NUM));
+  }
+  for(i = 0; i < FULL_NUM; i++) {
+    queuebuf_free(q[i]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+#endif /* QUEUEBUF_COMPACT */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test, QUEUEBUF_COMPACT %d\n", QUEUEBUF_COMPACT);
+  printf("---\n");
+
+  UNIT_TEST_RUN(roundtrip);
+  UNIT_TEST_RUN(attr_room);
+  UNIT_TEST_RUN(full_frames);
+
+  printf("=check-me= DONE\n");
+#if CONTIKI_TARGET_NATIVE
+  /* The native test runs on its own, let the Makefile go on */
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+  PROCESS_END();
+}
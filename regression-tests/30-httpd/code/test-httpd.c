@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Drives httpd requests over a simulated uIP connection, with
+ *         and without If-None-Match and Accept-Encoding headers
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "unit-test.h"
+#include "httpd.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+PROCESS(test_process, "Httpd test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Smaller than the files, so that they go out in several segments */
+#define TEST_MSS        100
+#define MAX_ROUNDS      100
+#define MAX_RESPONSE   2048
+
+UNIT_TEST_REGISTER(plain, "GET without conditional or encoding headers");
+UNIT_TEST_REGISTER(if_none_match, "If-None-Match, any case");
+UNIT_TEST_REGISTER(accept_encoding, "Accept-Encoding of a gzipped file, any case");
+UNIT_TEST_REGISTER(not_found, "GET of a missing file");
+
+/* Where and how much httpd sends, kept internal to uIP */
+extern void *uip_sappdata;
+extern uint16_t uip_slen;
+
+static struct uip_conn conn;
+static char response[MAX_RESPONSE + 1];
+static int response_len;
+static char etag[9];
+
+/*---------------------------------------------------------------------------*/
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: at line %u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Opens a connection, sends req in one segment and acks everything httpd
+   sends until it closes the connection. Returns 0 if it never does. */
+static int
+request(const char *req)
+{
+  int i;
+
+  response_len = 0;
+  response[0] = 0;
+  memset(&conn, 0, sizeof(conn));
+  conn.mss = TEST_MSS;
+  uip_conn = &conn;
+  uip_appdata = uip_sappdata = &uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN];
+  uip_len = strlen(req);
+  memcpy(uip_appdata, req, uip_len);
+  uip_flags = UIP_CONNECTED | UIP_NEWDATA;
+
+  for(i = 0; i < MAX_ROUNDS; i++) {
+    uip_slen = 0;
+    httpd_appcall(conn.appstate.state);
+    if(uip_slen > 0) {
+      if(uip_slen > TEST_MSS || response_len + uip_slen > MAX_RESPONSE) {
+        return 0;
+      }
+      memcpy(response + response_len, uip_sappdata, uip_slen);
+      response_len += uip_slen;
+      response[response_len] = 0;
+    }
+    if(uip_closed()) {
+      /* Let httpd free its state, as uIP does once the connection is
+         closed */
+      httpd_appcall(conn.appstate.state);
+      return 1;
+    }
+    uip_len = 0;
+    uip_flags = UIP_ACKDATA;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+status_is(const char *status)
+{
+  return strncmp(response, status, strlen(status)) == 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Whether the body that follows the header is as long as its
+   Content-Length says */
+static int
+body_complete(void)
+{
+  char *ptr;
+  char *body;
+
+  ptr = strstr(response, "Content-Length: ");
+  body = strstr(response, "\r\n\r\n");
+  if(ptr == NULL || body == NULL || ptr > body) {
+    return 0;
+  }
+  body += 4;
+  return atoi(ptr + 16) == response_len - (int)(body - response);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(plain)
+{
+  char *ptr;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(request("GET /index.html HTTP/1.0\r\n"
+                           "Host: contiki\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 200 OK\r\n"));
+  UNIT_TEST_ASSERT(response_len > 2 * TEST_MSS);
+  UNIT_TEST_ASSERT(body_complete());
+  UNIT_TEST_ASSERT(strstr(response, "Content-Encoding") == NULL);
+
+  ptr = strstr(response, "ETag: \"");
+  UNIT_TEST_ASSERT(ptr != NULL);
+  memcpy(etag, ptr + 7, 8);
+  etag[8] = 0;
+  UNIT_TEST_ASSERT(ptr[15] == '"');
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(if_none_match)
+{
+  char req[100];
+  char upper[9];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  sprintf(req, "GET /index.html HTTP/1.0\r\nIf-None-Match: \"%s\"\r\n\r\n",
+          etag);
+  UNIT_TEST_ASSERT(request(req));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 304 Not Modified\r\n"));
+  UNIT_TEST_ASSERT(strstr(response, "\r\n\r\n") + 4 == response + response_len);
+
+  for(i = 0; i < 9; i++) {
+    upper[i] = toupper((unsigned char)etag[i]);
+  }
+  sprintf(req, "GET /index.html HTTP/1.0\r\nif-none-match: \"%s\"\r\n\r\n",
+          upper);
+  UNIT_TEST_ASSERT(request(req));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 304 Not Modified\r\n"));
+
+  sprintf(req, "GET /index.html HTTP/1.0\r\nIF-NONE-MATCH: \"%s\"\r\n\r\n",
+          etag);
+  UNIT_TEST_ASSERT(request(req));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 304 Not Modified\r\n"));
+
+  /* Another file's tag */
+  UNIT_TEST_ASSERT(request("GET /index.html HTTP/1.0\r\n"
+                           "If-None-Match: \"00000000\"\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 200 OK\r\n"));
+  UNIT_TEST_ASSERT(body_complete());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(accept_encoding)
+{
+  UNIT_TEST_BEGIN();
+
+  /* makefsdata -z stores style.css gzipped */
+  UNIT_TEST_ASSERT(request("GET /style.css HTTP/1.0\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 406 Not Acceptable\r\n"));
+
+  UNIT_TEST_ASSERT(request("GET /style.css HTTP/1.0\r\n"
+                           "Accept-Encoding: deflate\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 406 Not Acceptable\r\n"));
+
+  UNIT_TEST_ASSERT(request("GET /style.css HTTP/1.0\r\n"
+                           "Accept-Encoding: gzip, deflate\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 200 OK\r\n"));
+  UNIT_TEST_ASSERT(strstr(response, "Content-Encoding: gzip\r\n") != NULL);
+  UNIT_TEST_ASSERT(body_complete());
+
+  UNIT_TEST_ASSERT(request("GET /style.css HTTP/1.0\r\n"
+                           "accept-encoding: deflate, GZIP\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 200 OK\r\n"));
+  UNIT_TEST_ASSERT(body_complete());
+
+  /* Files stored as they are do not depend on it */
+  UNIT_TEST_ASSERT(request("GET /index.html HTTP/1.0\r\n"
+                           "Accept-Encoding: gzip\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 200 OK\r\n"));
+  UNIT_TEST_ASSERT(strstr(response, "Content-Encoding") == NULL);
+  UNIT_TEST_ASSERT(body_complete());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(not_found)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(request("GET /missing.html HTTP/1.0\r\n\r\n"));
+  UNIT_TEST_ASSERT(status_is("HTTP/1.0 404 Not found\r\n"));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test, HTTPD_FS_INDEX %d\n", HTTPD_FS_INDEX);
+  printf("---\n");
+
+  UNIT_TEST_RUN(plain);
+  UNIT_TEST_RUN(if_none_match);
+  UNIT_TEST_RUN(accept_encoding);
+  UNIT_TEST_RUN(not_found);
+
+  printf("=check-me= DONE\n");
+#if CONTIKI_TARGET_NATIVE
+  /* The native test runs on its own, let the Makefile go on */
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+  PROCESS_END();
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * \file
+ *         Checks the Antelope B+-tree index against a reference list of
+ *         entries, under random inserts, deletes, range queries and
+ *         reloads, with several iterators at a time and until the tree
+ *         is full
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include "cfs/cfs-coffee.h"
+#include "lib/random.h"
+#include "index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+PROCESS(test_process, "B+-tree test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define MAX_IDS       32768
+#define KEY_RANGE      1000
+#define OPERATIONS    10000
+#define RELOAD_EVERY   1000
+#define FULL_ATTEMPTS  2000
+
+/* The reference: tuple ids are given in order, and each has its key
+   and whether it is in the index */
+static long ref_keys[MAX_IDS];
+static uint8_t ref_live[MAX_IDS];
+static int ref_count;
+static tuple_id_t next_id;
+
+static index_t btree_index;
+
+UNIT_TEST_REGISTER(random_ops, "random operations against a reference");
+UNIT_TEST_REGISTER(two_iterators, "two iterators advanced alternately");
+UNIT_TEST_REGISTER(full_tree, "inserts into a full tree");
+
+/*---------------------------------------------------------------------------*/
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: at line %u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_long(attribute_value_t *value, long l)
+{
+  value->domain = DOMAIN_LONG;
+  value->u.long_value = l;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_index(void)
+{
+  memset(&btree_index, 0, sizeof(btree_index));
+  btree_index.api = &index_btree;
+  btree_index.type = INDEX_BTREE;
+  memset(ref_live, 0, sizeof(ref_live));
+  ref_count = 0;
+  next_id = 0;
+  /* The index is left open by create() */
+  return !DB_ERROR(index_btree.create(&btree_index));
+}
+/*---------------------------------------------------------------------------*/
+static void
+destroy_index(void)
+{
+  index_btree.release(&btree_index);
+  index_btree.destroy(&btree_index);
+}
+/*---------------------------------------------------------------------------*/
+static int
+insert(long key)
+{
+  attribute_value_t value;
+
+  if(next_id == MAX_IDS) {
+    return 0;
+  }
+  set_long(&value, key);
+  if(DB_ERROR(index_btree.insert(&btree_index, &value, next_id))) {
+    return 0;
+  }
+  ref_keys[next_id] = key;
+  ref_live[next_id] = 1;
+  ref_count++;
+  next_id++;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+delete(long key)
+{
+  attribute_value_t value;
+  tuple_id_t id;
+
+  set_long(&value, key);
+  if(DB_ERROR(index_btree.delete(&btree_index, &value))) {
+    return 0;
+  }
+  for(id = 0; id < next_id; id++) {
+    if(ref_live[id] && ref_keys[id] == key) {
+      ref_live[id] = 0;
+      ref_count--;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+start_iterator(index_iterator_t *iterator, long min, long max)
+{
+  memset(iterator, 0, sizeof(*iterator));
+  iterator->index = &btree_index;
+  set_long(&iterator->min_value, min);
+  set_long(&iterator->max_value, max);
+}
+/*---------------------------------------------------------------------------*/
+/* Check that a range query returns every reference entry in the range
+   once, in key order */
+static int
+range_ok(long min, long max)
+{
+  static uint8_t seen[MAX_IDS];
+  index_iterator_t iterator;
+  tuple_id_t id;
+  long last_key;
+  int expected;
+  int found;
+
+  memset(seen, 0, sizeof(seen));
+  expected = 0;
+  for(id = 0; id < next_id; id++) {
+    if(ref_live[id] && ref_keys[id] >= min && ref_keys[id] <= max) {
+      expected++;
+    }
+  }
+
+  start_iterator(&iterator, min, max);
+  last_key = min;
+  found = 0;
+  while((id = index_btree.get_next(&iterator)) != INVALID_TUPLE) {
+    if(id >= next_id || !ref_live[id] || seen[id] ||
+       ref_keys[id] < last_key || ref_keys[id] > max) {
+      printf("range %ld-%ld: unexpected tuple %lu\n", min, max,
+             (unsigned long)id);
+      return 0;
+    }
+    seen[id] = 1;
+    last_key = ref_keys[id];
+    found++;
+  }
+
+  if(found != expected) {
+    printf("range %ld-%ld: %d tuples instead of %d\n", min, max,
+           found, expected);
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Inserts with duplicate keys, deletes and range queries in random
+   order, with the index released and loaded again at times */
+UNIT_TEST(random_ops)
+{
+  long min;
+  int op;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(create_index());
+
+  for(i = 0; i < OPERATIONS; i++) {
+    op = random_rand() % 10;
+    if(op < 6) {
+      UNIT_TEST_ASSERT(insert(random_rand() % KEY_RANGE));
+    } else if(op < 7) {
+      UNIT_TEST_ASSERT(delete(random_rand() % KEY_RANGE));
+    } else {
+      min = random_rand() % KEY_RANGE - 10;
+      UNIT_TEST_ASSERT(range_ok(min, min + random_rand() % 50));
+    }
+    if(i % RELOAD_EVERY == RELOAD_EVERY - 1) {
+      UNIT_TEST_ASSERT(!DB_ERROR(index_btree.release(&btree_index)));
+      UNIT_TEST_ASSERT(!DB_ERROR(index_btree.load(&btree_index)));
+    }
+  }
+  UNIT_TEST_ASSERT(range_ok(-1, KEY_RANGE));
+
+  /* Appends, as with timestamps */
+  for(i = 0; i < 1000; i++) {
+    UNIT_TEST_ASSERT(insert(KEY_RANGE + i / 3));
+  }
+  UNIT_TEST_ASSERT(range_ok(-1, KEY_RANGE + 1000));
+  UNIT_TEST_ASSERT(range_ok(KEY_RANGE + 100, KEY_RANGE + 200));
+
+  destroy_index();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Iterators over disjoint ranges must not reset each other */
+UNIT_TEST(two_iterators)
+{
+  index_iterator_t a;
+  index_iterator_t b;
+  tuple_id_t id_a;
+  tuple_id_t id_b;
+  int count_a;
+  int count_b;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(create_index());
+  for(i = 0; i < 400; i++) {
+    UNIT_TEST_ASSERT(insert(i));
+  }
+
+  start_iterator(&a, 0, 99);
+  start_iterator(&b, 200, 299);
+  count_a = count_b = 0;
+  do {
+    id_a = index_btree.get_next(&a);
+    if(id_a != INVALID_TUPLE) {
+      UNIT_TEST_ASSERT(id_a == count_a);
+      count_a++;
+    }
+    id_b = index_btree.get_next(&b);
+    if(id_b != INVALID_TUPLE) {
+      UNIT_TEST_ASSERT(id_b == 200 + count_b);
+      count_b++;
+    }
+    UNIT_TEST_ASSERT(count_a <= 100 && count_b <= 100);
+  } while(id_a != INVALID_TUPLE || id_b != INVALID_TUPLE);
+  UNIT_TEST_ASSERT(count_a == 100 && count_b == 100);
+
+  destroy_index();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+/* An insert that needs more nodes than are left fails without changing
+   the tree, which still takes inserts that need no new node */
+UNIT_TEST(full_tree)
+{
+  long key;
+  int inserted;
+  int failed;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(create_index());
+  do {
+    UNIT_TEST_ASSERT(next_id < MAX_IDS);
+    key = random_rand() % (4 * KEY_RANGE);
+  } while(insert(key));
+  printf("The tree is full with %d entries\n", ref_count);
+  UNIT_TEST_ASSERT(range_ok(-1, 4 * KEY_RANGE));
+
+  /* Keep inserting. Keys that go into leaves with room are taken,
+     and those that would split more nodes than are left are not. */
+  failed = 0;
+  for(i = 0; i < FULL_ATTEMPTS; i++) {
+    failed += !insert(random_rand() % (4 * KEY_RANGE));
+  }
+  printf("%d of %d inserts into the full tree failed\n",
+         failed, FULL_ATTEMPTS);
+  UNIT_TEST_ASSERT(failed > 0);
+  UNIT_TEST_ASSERT(range_ok(-1, 4 * KEY_RANGE));
+
+  /* Make room in the leaves, but not for new nodes. The keys go back
+     into the leaves they were deleted from, unless these are full. */
+  for(i = 0; i < KEY_RANGE; i++) {
+    UNIT_TEST_ASSERT(delete(4 * i));
+  }
+  inserted = 0;
+  for(i = 0; i < KEY_RANGE; i++) {
+    inserted += insert(4 * i);
+  }
+  UNIT_TEST_ASSERT(inserted > 0);
+  UNIT_TEST_ASSERT(range_ok(-1, 4 * KEY_RANGE));
+
+  UNIT_TEST_ASSERT(!DB_ERROR(index_btree.release(&btree_index)));
+  UNIT_TEST_ASSERT(!DB_ERROR(index_btree.load(&btree_index)));
+  UNIT_TEST_ASSERT(range_ok(-1, 4 * KEY_RANGE));
+
+  destroy_index();
+
+  /* Appends fill the nodes and split up to the root, so that the last
+     free node is taken by a leaf whose parent is full */
+  UNIT_TEST_ASSERT(create_index());
+  for(key = 0; insert(key); key++) {
+    UNIT_TEST_ASSERT(next_id < MAX_IDS);
+  }
+  printf("The tree is full with %d appended entries\n", ref_count);
+  UNIT_TEST_ASSERT(range_ok(-1, key));
+
+  destroy_index();
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test, DB_BTREE_CACHE_SIZE %d, DB_BTREE_NODE_SIZE %d\n",
+         DB_BTREE_CACHE_SIZE, DB_BTREE_NODE_SIZE);
+  printf("---\n");
+
+  random_init(1);
+  cfs_coffee_format();
+
+  UNIT_TEST_RUN(random_ops);
+  UNIT_TEST_RUN(two_iterators);
+  UNIT_TEST_RUN(full_tree);
+
+  printf("=check-me= DONE\n");
+#if CONTIKI_TARGET_NATIVE
+  /* The native test runs on its own, let the Makefile go on */
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+  PROCESS_END();
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * \file
+ *         Checks that uip6 delivers each UDP datagram to the connection
+ *         that a walk of uip_udp_conns[] finds, under random creations,
+ *         binds, removals and in-place changes of the connections
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "unit-test.h"
+#include "lib/random.h"
+#include "net/ipv6/uip-ds6.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+PROCESS(test_process, "Connection hash test");
+PROCESS(sink_process, "UDP sink");
+AUTOSTART_PROCESSES(&sink_process, &test_process);
+
+#define UIP_IP_BUF  ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_UDP_BUF ((struct uip_udp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+
+#define PAYLOAD_LEN  4
+#define PACKET_LEN   (UIP_IPUDPH_LEN + PAYLOAD_LEN)
+#define STEPS        400000
+#define PEERS        3
+/* Local and remote ports are drawn from small sets, so that they are
+   shared by several connections */
+#define PORTS        4
+
+static uip_ipaddr_t peers[PEERS];
+/* The connection that the last datagram was delivered to */
+static struct uip_udp_conn *delivered;
+
+UNIT_TEST_REGISTER(udp_demux, "UDP demultiplexing against the array walk");
+
+/*---------------------------------------------------------------------------*/
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: at line %u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == tcpip_event && uip_newdata()) {
+      delivered = uip_udp_conn;
+    }
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+random_port(void)
+{
+  return UIP_HTONS(5000 + random_rand() % PORTS);
+}
+/*---------------------------------------------------------------------------*/
+static uip_ipaddr_t *
+random_peer(void)
+{
+  return &peers[random_rand() % PEERS];
+}
+/*---------------------------------------------------------------------------*/
+/* The connection that the array walk of uip6 chooses */
+static struct uip_udp_conn *
+walk(const uip_ipaddr_t *src, uint16_t srcport, uint16_t destport)
+{
+  struct uip_udp_conn *c;
+
+  for(c = &uip_udp_conns[0]; c < &uip_udp_conns[UIP_UDP_CONNS]; c++) {
+    if(c->lport != 0 && c->lport == destport &&
+       (c->rport == 0 || c->rport == srcport) &&
+       (uip_is_addr_unspecified(&c->ripaddr) ||
+        uip_ipaddr_cmp(&c->ripaddr, src))) {
+      return c;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Send a datagram to uip6, and return the connection it reached */
+static struct uip_udp_conn *
+deliver(const uip_ipaddr_t *src, uint16_t srcport, uint16_t destport)
+{
+  uint16_t sum;
+
+  memset(uip_buf, 0, UIP_LLH_LEN + PACKET_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = PACKET_LEN - UIP_IPH_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, src);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr,
+                  &uip_ds6_get_link_local(-1)->ipaddr);
+  UIP_UDP_BUF->srcport = srcport;
+  UIP_UDP_BUF->destport = destport;
+  UIP_UDP_BUF->udplen = UIP_HTONS(PACKET_LEN - UIP_IPH_LEN);
+  uip_len = PACKET_LEN;
+  sum = ~uip_udpchksum();
+  UIP_UDP_BUF->udpchksum = sum == 0 ? 0xffff : sum;
+
+  delivered = NULL;
+  uip_input();
+  uip_clear_buf();
+  return delivered;
+}
+/*---------------------------------------------------------------------------*/
+/* A new connection gets a local port that no other connection uses */
+static int
+new_port_ok(struct uip_udp_conn *conn)
+{
+  struct uip_udp_conn *c;
+
+  for(c = &uip_udp_conns[0]; c < &uip_udp_conns[UIP_UDP_CONNS]; c++) {
+    if(c != conn && c->lport == conn->lport) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Random creations, binds to shared ports, removals and in-place
+   changes of the remote port and address, each followed by a datagram
+   to a random port */
+UNIT_TEST(udp_demux)
+{
+  struct uip_udp_conn *conn;
+  uint16_t destport;
+  uint16_t srcport;
+  uip_ipaddr_t *src;
+  unsigned long matched;
+  int step;
+
+  UNIT_TEST_BEGIN();
+
+  matched = 0;
+  for(step = 0; step < STEPS; step++) {
+    conn = &uip_udp_conns[random_rand() % UIP_UDP_CONNS];
+    switch(random_rand() % 6) {
+    case 0:
+      PROCESS_CONTEXT_BEGIN(&sink_process);
+      conn = udp_new(random_rand() % 2 ? NULL : random_peer(),
+                     random_rand() % 2 ? 0 : random_port(), NULL);
+      PROCESS_CONTEXT_END(&sink_process);
+      UNIT_TEST_ASSERT(conn == NULL || new_port_ok(conn));
+      break;
+    case 1:
+    case 2:
+      if(conn->lport != 0) {
+        udp_bind(conn, random_port());
+      }
+      break;
+    case 3:
+      if(conn->lport != 0) {
+        uip_udp_remove(conn);
+      }
+      break;
+    case 4:
+      conn->rport = random_rand() % 2 ? 0 : random_port();
+      break;
+    case 5:
+      if(random_rand() % 2) {
+        uip_create_unspecified(&conn->ripaddr);
+      } else {
+        uip_ipaddr_copy(&conn->ripaddr, random_peer());
+      }
+      break;
+    }
+
+    src = random_peer();
+    srcport = random_port();
+    if(random_rand() % 4 == 0) {
+      /* An ephemeral port, which may be in use */
+      destport = uip_udp_conns[random_rand() % UIP_UDP_CONNS].lport;
+      if(destport == 0) {
+        destport = random_port();
+      }
+    } else {
+      destport = random_port();
+    }
+    conn = walk(src, srcport, destport);
+    if(deliver(src, srcport, destport) != conn) {
+      printf("step %d: datagram to port %u delivered to the wrong connection\n",
+             step, uip_ntohs(destport));
+      UNIT_TEST_FAIL();
+    }
+    matched += conn != NULL;
+  }
+  printf("%lu of %d datagrams matched a connection\n", matched, STEPS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* Let the sink start first */
+  PROCESS_PAUSE();
+
+  printf("Run unit-test, UIP_CONN_HASH %d\n", UIP_CONN_HASH);
+  printf("---\n");
+
+  random_init(1);
+  for(i = 0; i < PEERS; i++) {
+    uip_ip6addr(&peers[i], 0xfe80, 0, 0, 0, 0x0212, 0x7400 + i, i, i);
+  }
+
+  UNIT_TEST_RUN(udp_demux);
+
+  printf("=check-me= DONE\n");
+#if CONTIKI_TARGET_NATIVE
+  /* The native test runs on its own, let the Makefile go on */
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+  PROCESS_END();
+}
@@ -0,0 +1,603 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Drives the queued PUBLISH path of the MQTT client against a
+ *         simulated broker: batching, the QoS 1 window, PUBACK expiry
+ *         and payload iterators, failing or not
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "unit-test.h"
+#include "mqtt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+PROCESS(test_process, "MQTT test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define KEEP_ALIVE      600
+#define MSS             128
+#define TOPIC           "test/queue"
+#define PAYLOAD_LEN     20
+/* Larger than the TCP output buffer, so that it needs several segments */
+#define LARGE_LEN       1500
+#define MAX_PUBLISHES   64
+#define MAX_ROUNDS      1000
+#define EVENTS_PER_ROUND  16
+#define WIRE_SIZE       4096
+/* RESPONSE_WAIT_TIMEOUT of mqtt.c */
+#define PUBACK_TIMEOUT  (CLOCK_SECOND * 10)
+
+UNIT_TEST_REGISTER(connect, "Connect to the broker");
+UNIT_TEST_REGISTER(batch, "QoS 0 messages queued together leave in one segment");
+UNIT_TEST_REGISTER(window, "QoS 1 messages beyond the window wait for a PUBACK");
+UNIT_TEST_REGISTER(expiry, "QoS 1 messages without a PUBACK expire");
+UNIT_TEST_REGISTER(iterator, "Payload iterators, and one failing in the buffer");
+UNIT_TEST_REGISTER(iterator_sent, "Payload iterator failing after a flush");
+
+/* A PUBLISH as the broker got it */
+struct publish {
+  uint8_t qos;
+  uint16_t mid;
+  uint16_t len;
+  uint8_t tag;
+  uint8_t intact;
+  int segment;
+};
+
+/* Payload iterator state: the payload is the pattern from tag, and the
+   iterator fails when asked for bytes at or past fail_at */
+struct iter {
+  uint8_t tag;
+  uint32_t fail_at;
+};
+
+static struct mqtt_connection conn;
+static int event_count[256];
+static uint16_t expired_mids[MQTT_PUBLISH_QUEUE_SIZE];
+static int expired_count;
+static uint16_t error_mid;
+
+/* The simulated TCP socket and broker */
+static struct tcp_socket *sock;
+static void *sock_ptr;
+static tcp_socket_data_callback_t sock_input;
+static tcp_socket_event_callback_t sock_event;
+static uint8_t registered;
+static uint8_t connect_pending;
+static uint8_t sent_pending;
+static uint8_t connack_pending;
+static int closes;
+static int segments;
+static uint8_t wire[WIRE_SIZE];
+static int wire_len;
+static struct publish published[MAX_PUBLISHES];
+static int published_count;
+static int garbage;
+
+/* Payload of tag t: the PAYLOAD_LEN bytes from pattern[t] */
+static uint8_t pattern[256 + PAYLOAD_LEN];
+/*---------------------------------------------------------------------------*/
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: at line %u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Replaces core/net/ip/tcp-socket.c, which is then not linked in */
+int
+tcp_socket_register(struct tcp_socket *s, void *ptr,
+                    uint8_t *input_databuf, int input_databuf_len,
+                    uint8_t *output_databuf, int output_databuf_len,
+                    tcp_socket_data_callback_t input_callback,
+                    tcp_socket_event_callback_t event_callback)
+{
+  sock = s;
+  sock_ptr = ptr;
+  sock_input = input_callback;
+  sock_event = event_callback;
+  registered = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+tcp_socket_connect(struct tcp_socket *s, const uip_ipaddr_t *ipaddr,
+                   uint16_t port)
+{
+  connect_pending = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+tcp_socket_send(struct tcp_socket *s, const uint8_t *dataptr, int datalen)
+{
+  if(wire_len + datalen > WIRE_SIZE) {
+    garbage++;
+    return -1;
+  }
+  memcpy(wire + wire_len, dataptr, datalen);
+  wire_len += datalen;
+  segments++;
+  sent_pending = 1;
+  return datalen;
+}
+/*---------------------------------------------------------------------------*/
+int
+tcp_socket_close(struct tcp_socket *s)
+{
+  if(registered) {
+    closes++;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+tcp_socket_unregister(struct tcp_socket *s)
+{
+  /* As with uIP, no more events reach a socket once it is unregistered */
+  registered = 0;
+  connect_pending = sent_pending = connack_pending = 0;
+  wire_len = 0;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+broker_packet(uint8_t fhdr, const uint8_t *p, uint32_t len)
+{
+  struct publish *pub;
+  uint32_t pos;
+  uint32_t i;
+
+  switch(fhdr & 0xf0) {
+  case 0x10:
+    /* CONNECT */
+    connack_pending = 1;
+    break;
+  case 0x30:
+    /* PUBLISH */
+    if(published_count == MAX_PUBLISHES || len < 2 + strlen(TOPIC) ||
+       memcmp(p + 2, TOPIC, strlen(TOPIC)) != 0) {
+      garbage++;
+      return;
+    }
+    pub = &published[published_count++];
+    memset(pub, 0, sizeof(*pub));
+    pub->qos = (fhdr >> 1) & 3;
+    pub->segment = segments;
+    pos = 2 + strlen(TOPIC);
+    if(pub->qos > 0) {
+      pub->mid = (p[pos] << 8) | p[pos + 1];
+      pos += 2;
+    }
+    pub->len = len - pos;
+    pub->tag = p[pos];
+    pub->intact = 1;
+    for(i = 0; i < pub->len; i++) {
+      if(p[pos + i] != (uint8_t)(pub->tag + i)) {
+        pub->intact = 0;
+      }
+    }
+    break;
+  case 0xc0:
+    /* PINGREQ */
+  case 0xe0:
+    /* DISCONNECT */
+    break;
+  default:
+    garbage++;
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Takes the complete packets off the wire */
+static void
+broker_parse(void)
+{
+  uint32_t len;
+  uint32_t multiplier;
+  int pos;
+
+  while(wire_len > 0) {
+    len = 0;
+    multiplier = 1;
+    pos = 1;
+    do {
+      if(pos == wire_len || pos > 4) {
+        return;
+      }
+      len += (wire[pos] & 0x7f) * multiplier;
+      multiplier *= 128;
+    } while(wire[pos++] & 0x80);
+    if(pos + len > wire_len) {
+      return;
+    }
+    broker_packet(wire[0], wire + pos, len);
+    wire_len -= pos + len;
+    memmove(wire, wire + pos + len, wire_len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Delivers one pending socket event, returns 0 if there was none */
+static int
+broker_step(void)
+{
+  static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+
+  if(!registered) {
+    return 0;
+  }
+  if(connect_pending) {
+    connect_pending = 0;
+    sock_event(sock, sock_ptr, TCP_SOCKET_CONNECTED);
+    return 1;
+  }
+  if(sent_pending) {
+    sent_pending = 0;
+    broker_parse();
+    sock_event(sock, sock_ptr, TCP_SOCKET_DATA_SENT);
+    return 1;
+  }
+  if(connack_pending) {
+    connack_pending = 0;
+    sock_input(sock, sock_ptr, connack, sizeof(connack));
+    return 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+broker_puback(uint16_t mid)
+{
+  uint8_t puback[4];
+
+  puback[0] = 0x40;
+  puback[1] = 0x02;
+  puback[2] = mid >> 8;
+  puback[3] = mid & 0xff;
+  sock_input(sock, sock_ptr, puback, sizeof(puback));
+}
+/*---------------------------------------------------------------------------*/
+/* Runs the MQTT process and the broker until neither has anything to do.
+   The MQTT process keeps posting itself events while it waits for the
+   socket, so the broker gets its turn after a few of them. */
+static void
+run(void)
+{
+  int i;
+  int n;
+
+  for(i = 0; i < MAX_ROUNDS; i++) {
+    for(n = 0; n < EVENTS_PER_ROUND && process_run() > 0; n++);
+    if(!broker_step() && process_nevents() == 0) {
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+wait(clock_time_t t)
+{
+  clock_time_t start;
+
+  start = clock_time();
+  while(clock_time() - start < t) {
+    usleep(10000);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
+{
+  event_count[event & 0xff]++;
+  if(event == MQTT_EVENT_PUBACK_TIMEOUT_ERROR &&
+     expired_count < MQTT_PUBLISH_QUEUE_SIZE) {
+    expired_mids[expired_count++] = *((uint16_t *)data);
+  } else if(event == MQTT_EVENT_PAYLOAD_ERROR) {
+    error_mid = *((uint16_t *)data);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static mqtt_status_t
+publish(uint8_t tag, mqtt_qos_level_t qos, uint16_t *mid)
+{
+  return mqtt_publish(&conn, mid, TOPIC, &pattern[tag], PAYLOAD_LEN, qos,
+                      MQTT_RETAIN_OFF);
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+iterate(void *ptr, uint32_t offset, uint8_t *buf, uint16_t len)
+{
+  struct iter *it = ptr;
+  uint16_t i;
+
+  if(offset + len > it->fail_at) {
+    return 0;
+  }
+  for(i = 0; i < len; i++) {
+    buf[i] = it->tag + offset + i;
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_published(int i, uint8_t tag, mqtt_qos_level_t qos, uint16_t len)
+{
+  return i < published_count && published[i].tag == tag &&
+         published[i].qos == qos && published[i].len == len &&
+         published[i].intact;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(connect)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(mqtt_register(&conn, &test_process, "test", mqtt_event,
+                                 MSS) == MQTT_STATUS_OK);
+  UNIT_TEST_ASSERT(mqtt_connect(&conn, "fd00::1", 1883,
+                                KEEP_ALIVE) == MQTT_STATUS_OK);
+  run();
+  UNIT_TEST_ASSERT(event_count[MQTT_EVENT_CONNECTED] == 1);
+  UNIT_TEST_ASSERT(mqtt_connected(&conn));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(batch)
+{
+  int first;
+  int segment;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  first = published_count;
+  segment = segments;
+  for(i = 0; i < 4; i++) {
+    UNIT_TEST_ASSERT(publish(i, MQTT_QOS_LEVEL_0, NULL) == MQTT_STATUS_OK);
+  }
+  run();
+  UNIT_TEST_ASSERT(published_count == first + 4);
+  UNIT_TEST_ASSERT(segments == segment + 1);
+  for(i = 0; i < 4; i++) {
+    UNIT_TEST_ASSERT(is_published(first + i, i, MQTT_QOS_LEVEL_0,
+                                  PAYLOAD_LEN));
+  }
+  UNIT_TEST_ASSERT(garbage == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(window)
+{
+  uint16_t mids[MQTT_PUBLISH_QUEUE_SIZE];
+  int pubacks;
+  int first;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  first = published_count;
+  pubacks = event_count[MQTT_EVENT_PUBACK];
+  for(i = 0; i < MQTT_PUBLISH_QUEUE_SIZE; i++) {
+    UNIT_TEST_ASSERT(publish(10 + i, MQTT_QOS_LEVEL_1, &mids[i]) ==
+                     MQTT_STATUS_OK);
+  }
+  UNIT_TEST_ASSERT(publish(0, MQTT_QOS_LEVEL_0, NULL) ==
+                   MQTT_STATUS_OUT_QUEUE_FULL);
+  run();
+  UNIT_TEST_ASSERT(published_count == first + MQTT_PUBLISH_WINDOW);
+
+  /* Each PUBACK lets the next message go */
+  for(i = 0; i < MQTT_PUBLISH_QUEUE_SIZE; i++) {
+    UNIT_TEST_ASSERT(is_published(first + i, 10 + i, MQTT_QOS_LEVEL_1,
+                                  PAYLOAD_LEN));
+    UNIT_TEST_ASSERT(published[first + i].mid == mids[i]);
+    broker_puback(mids[i]);
+    run();
+    UNIT_TEST_ASSERT(event_count[MQTT_EVENT_PUBACK] == pubacks + i + 1);
+    UNIT_TEST_ASSERT(published_count ==
+                     first + MIN(MQTT_PUBLISH_QUEUE_SIZE,
+                                 i + 1 + MQTT_PUBLISH_WINDOW));
+  }
+  UNIT_TEST_ASSERT(garbage == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(expiry)
+{
+  uint16_t mids[MQTT_PUBLISH_WINDOW + 1];
+  int first;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  first = published_count;
+  expired_count = 0;
+  for(i = 0; i <= MQTT_PUBLISH_WINDOW; i++) {
+    UNIT_TEST_ASSERT(publish(30 + i, MQTT_QOS_LEVEL_1, &mids[i]) ==
+                     MQTT_STATUS_OK);
+  }
+  run();
+  UNIT_TEST_ASSERT(published_count == first + MQTT_PUBLISH_WINDOW);
+
+  /* Messages are sent in order, so this one waits behind the last QoS 1 */
+  UNIT_TEST_ASSERT(publish(40, MQTT_QOS_LEVEL_0, NULL) == MQTT_STATUS_OK);
+  run();
+  UNIT_TEST_ASSERT(published_count == first + MQTT_PUBLISH_WINDOW);
+  UNIT_TEST_ASSERT(expired_count == 0);
+
+  /* Queueing a message expires those without a PUBACK, and the window
+     moves on */
+  wait(PUBACK_TIMEOUT);
+  UNIT_TEST_ASSERT(publish(41, MQTT_QOS_LEVEL_0, NULL) == MQTT_STATUS_OK);
+  UNIT_TEST_ASSERT(expired_count == MQTT_PUBLISH_WINDOW);
+  for(i = 0; i < MQTT_PUBLISH_WINDOW; i++) {
+    UNIT_TEST_ASSERT(expired_mids[i] == mids[i]);
+  }
+  run();
+  UNIT_TEST_ASSERT(published_count == first + MQTT_PUBLISH_WINDOW + 3);
+  UNIT_TEST_ASSERT(is_published(first + MQTT_PUBLISH_WINDOW,
+                                30 + MQTT_PUBLISH_WINDOW, MQTT_QOS_LEVEL_1,
+                                PAYLOAD_LEN));
+  UNIT_TEST_ASSERT(is_published(first + MQTT_PUBLISH_WINDOW + 1, 40,
+                                MQTT_QOS_LEVEL_0, PAYLOAD_LEN));
+  UNIT_TEST_ASSERT(is_published(first + MQTT_PUBLISH_WINDOW + 2, 41,
+                                MQTT_QOS_LEVEL_0, PAYLOAD_LEN));
+
+  broker_puback(mids[MQTT_PUBLISH_WINDOW]);
+  run();
+  UNIT_TEST_ASSERT(expired_count == MQTT_PUBLISH_WINDOW);
+  UNIT_TEST_ASSERT(garbage == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(iterator)
+{
+  static struct iter large = { 50, LARGE_LEN };
+  static struct iter failing = { 60, PAYLOAD_LEN / 2 };
+  uint16_t large_mid;
+  uint16_t failing_mid;
+  int errors;
+  int first;
+
+  UNIT_TEST_BEGIN();
+
+  first = published_count;
+  errors = event_count[MQTT_EVENT_PAYLOAD_ERROR];
+  UNIT_TEST_ASSERT(mqtt_publish_iter(&conn, &large_mid, TOPIC, iterate,
+                                     &large, LARGE_LEN, MQTT_QOS_LEVEL_1,
+                                     MQTT_RETAIN_OFF) == MQTT_STATUS_OK);
+  UNIT_TEST_ASSERT(publish(51, MQTT_QOS_LEVEL_0, NULL) == MQTT_STATUS_OK);
+  UNIT_TEST_ASSERT(mqtt_publish_iter(&conn, &failing_mid, TOPIC, iterate,
+                                     &failing, PAYLOAD_LEN, MQTT_QOS_LEVEL_0,
+                                     MQTT_RETAIN_OFF) == MQTT_STATUS_OK);
+  UNIT_TEST_ASSERT(publish(52, MQTT_QOS_LEVEL_0, NULL) == MQTT_STATUS_OK);
+  run();
+
+  /* The failed message is taken back from the output buffer whole, the
+     one after it goes out intact */
+  UNIT_TEST_ASSERT(event_count[MQTT_EVENT_PAYLOAD_ERROR] == errors + 1);
+  UNIT_TEST_ASSERT(error_mid == failing_mid);
+  UNIT_TEST_ASSERT(published_count == first + 3);
+  UNIT_TEST_ASSERT(is_published(first, 50, MQTT_QOS_LEVEL_1, LARGE_LEN));
+  UNIT_TEST_ASSERT(published[first].mid == large_mid);
+  UNIT_TEST_ASSERT(is_published(first + 1, 51, MQTT_QOS_LEVEL_0,
+                                PAYLOAD_LEN));
+  UNIT_TEST_ASSERT(is_published(first + 2, 52, MQTT_QOS_LEVEL_0,
+                                PAYLOAD_LEN));
+  UNIT_TEST_ASSERT(garbage == 0);
+  UNIT_TEST_ASSERT(mqtt_connected(&conn));
+
+  broker_puback(large_mid);
+  run();
+  UNIT_TEST_ASSERT(conn.publish_in_flight == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(iterator_sent)
+{
+  static struct iter failing = { 70, LARGE_LEN - PAYLOAD_LEN };
+  uint16_t failing_mid;
+  int connects;
+  int errors;
+  int first;
+
+  UNIT_TEST_BEGIN();
+
+  first = published_count;
+  errors = event_count[MQTT_EVENT_PAYLOAD_ERROR];
+  connects = event_count[MQTT_EVENT_CONNECTED];
+  UNIT_TEST_ASSERT(mqtt_publish_iter(&conn, &failing_mid, TOPIC, iterate,
+                                     &failing, LARGE_LEN, MQTT_QOS_LEVEL_0,
+                                     MQTT_RETAIN_OFF) == MQTT_STATUS_OK);
+  run();
+
+  /* The broker got part of the message: the connection is aborted, and
+     made again */
+  UNIT_TEST_ASSERT(event_count[MQTT_EVENT_PAYLOAD_ERROR] == errors + 1);
+  UNIT_TEST_ASSERT(error_mid == failing_mid);
+  UNIT_TEST_ASSERT(event_count[MQTT_EVENT_DISCONNECTED] == 1);
+  UNIT_TEST_ASSERT(closes == 1);
+  UNIT_TEST_ASSERT(published_count == first);
+  UNIT_TEST_ASSERT(event_count[MQTT_EVENT_CONNECTED] == connects + 1);
+  UNIT_TEST_ASSERT(mqtt_connected(&conn));
+
+  /* The new connection works */
+  UNIT_TEST_ASSERT(publish(71, MQTT_QOS_LEVEL_0, NULL) == MQTT_STATUS_OK);
+  run();
+  UNIT_TEST_ASSERT(published_count == first + 1);
+  UNIT_TEST_ASSERT(is_published(first, 71, MQTT_QOS_LEVEL_0, PAYLOAD_LEN));
+  UNIT_TEST_ASSERT(garbage == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test, MQTT_PUBLISH_WINDOW %d\n", MQTT_PUBLISH_WINDOW);
+  printf("---\n");
+
+  for(i = 0; i < sizeof(pattern); i++) {
+    pattern[i] = i;
+  }
+
+  UNIT_TEST_RUN(connect);
+  UNIT_TEST_RUN(batch);
+  UNIT_TEST_RUN(window);
+  UNIT_TEST_RUN(expiry);
+  UNIT_TEST_RUN(iterator);
+  UNIT_TEST_RUN(iterator_sent);
+
+  printf("=check-me= DONE\n");
+#if CONTIKI_TARGET_NATIVE
+  /* The native test runs on its own, let the Makefile go on */
+  exit(0);
+#endif /* CONTIKI_TARGET_NATIVE */
+  PROCESS_END();
+}
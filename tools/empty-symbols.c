@@ -2,3 +2,5 @@
 
 const int symbols_nelts = 0;
 const struct symbols symbols[] = {{0,0}};
+const unsigned short symbols_hash_size = 1;
+const unsigned short symbols_hash[] = {0};
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2026, agent <agent@local>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/*
+ * Decoder for the binary TSCH trace (core/net/mac/tsch/tsch-trace.h).
+ *
+ * Reads serial or Cooja logs, in which trace frames are either
+ * SLIP-framed binary or "TT:<hex>" lines, possibly interleaved with
+ * regular text output, and writes one CSV line per record. With -o,
+ * one CSV timeline per node is written to <prefix><node id>.csv.
+ * A per-node summary with record losses and MAC-level PDR is written
+ * to stderr.
+ *
+ * Usage: tsch-trace-decode [-o prefix] [file ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define TRACE_VERSION   1
+#define TRACE_FRAME_LEN 26
+
+#define TRACE_TX 1
+#define TRACE_RX 2
+
+#define FLAG_UNICAST    0x01
+#define FLAG_DATA       0x02
+#define FLAG_DRIFT_USED 0x04
+
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+
+#define LINE_LEN 512
+
+struct node {
+  struct node *next;
+  uint16_t id;
+  FILE *out;
+  int has_seqno;
+  uint16_t next_seqno;
+  unsigned long records;
+  unsigned long lost;
+  unsigned long tx;
+  unsigned long tx_ok;
+  unsigned long rx;
+};
+
+static struct node *nodes;
+static const char *prefix;
+static unsigned long bad_frames;
+
+static const char csv_header[] =
+  "node,seqno,asn,type,sf_handle,sf_size,n,timeslot,channel_offset,"
+  "peer,status,num_tx,drift,datalen,unicast,data,drift_used\n";
+
+/*---------------------------------------------------------------------------*/
+static struct node *
+node_get(uint16_t id)
+{
+  struct node *n;
+  char name[256];
+
+  for(n = nodes; n != NULL; n = n->next) {
+    if(n->id == id) {
+      return n;
+    }
+  }
+  n = calloc(1, sizeof(struct node));
+  if(n == NULL) {
+    perror("calloc");
+    exit(1);
+  }
+  n->id = id;
+  if(prefix != NULL) {
+    snprintf(name, sizeof(name), "%s%u.csv", prefix, id);
+    n->out = fopen(name, "w");
+    if(n->out == NULL) {
+      perror(name);
+      exit(1);
+    }
+    fputs(csv_header, n->out);
+  } else {
+    n->out = stdout;
+  }
+  n->next = nodes;
+  nodes = n;
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+get16(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8);
+}
+/*---------------------------------------------------------------------------*/
+/* Slotframe sizes of OST links are 2^N; -1 if not a power of two */
+static int
+log2_size(unsigned size)
+{
+  int n;
+
+  if(size == 0 || (size & (size - 1)) != 0) {
+    return -1;
+  }
+  for(n = 0; size > 1; n++) {
+    size >>= 1;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+decode(const uint8_t *frame, int len)
+{
+  struct node *n;
+  uint16_t seqno;
+  unsigned long long asn;
+  unsigned sf_size;
+  int type;
+  int flags;
+  int status;
+
+  if(len != TRACE_FRAME_LEN || frame[0] != TRACE_VERSION ||
+     (frame[1] != TRACE_TX && frame[1] != TRACE_RX)) {
+    bad_frames++;
+    return;
+  }
+
+  type = frame[1];
+  n = node_get(get16(frame + 2));
+  seqno = get16(frame + 4);
+  if(n->has_seqno) {
+    n->lost += (uint16_t)(seqno - n->next_seqno);
+  }
+  n->has_seqno = 1;
+  n->next_seqno = seqno + 1;
+
+  asn = get16(frame + 6) | ((unsigned long long)get16(frame + 8) << 16) |
+    ((unsigned long long)frame[10] << 32);
+  sf_size = get16(frame + 13);
+  status = frame[20];
+  flags = frame[25];
+
+  n->records++;
+  if(type == TRACE_TX) {
+    n->tx++;
+    if(status == 0) {
+      n->tx_ok++;
+    }
+  } else {
+    n->rx++;
+  }
+
+  fprintf(n->out, "%u,%u,%llu,%s,%u,%u,%d,%u,%u,%u,%d,%u,%d,%u,%d,%d,%d\n",
+          n->id, seqno, asn, type == TRACE_TX ? "tx" : "rx",
+          get16(frame + 11), sf_size, log2_size(sf_size), get16(frame + 15),
+          frame[17], get16(frame + 18), status, frame[21],
+          (int16_t)get16(frame + 22), frame[24],
+          (flags & FLAG_UNICAST) != 0, (flags & FLAG_DATA) != 0,
+          (flags & FLAG_DRIFT_USED) != 0);
+}
+/*---------------------------------------------------------------------------*/
+static int
+hexval(int c)
+{
+  if(c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if(c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if(c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+/* Decode the "TT:<hex>" frame of a text line, if any */
+static void
+decode_line(const char *line)
+{
+  uint8_t frame[TRACE_FRAME_LEN];
+  const char *p;
+  int hi, lo;
+  int len;
+
+  p = strstr(line, "TT:");
+  if(p == NULL) {
+    return;
+  }
+  p += 3;
+  for(len = 0; len < TRACE_FRAME_LEN; len++) {
+    hi = hexval(p[0]);
+    lo = hi < 0 ? -1 : hexval(p[1]);
+    if(lo < 0) {
+      break;
+    }
+    frame[len] = (hi << 4) | lo;
+    p += 2;
+  }
+  decode(frame, hexval(*p) < 0 ? len : -1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+decode_stream(FILE *in)
+{
+  uint8_t frame[TRACE_FRAME_LEN];
+  char line[LINE_LEN];
+  int line_len = 0;
+  int in_frame = 0;
+  int escaped = 0;
+  int len = 0;
+  int c;
+
+  while((c = getc(in)) != EOF) {
+    if(!in_frame) {
+      if(c == SLIP_END) {
+        in_frame = 1;
+        escaped = 0;
+        len = 0;
+      } else if(c == '\n') {
+        line[line_len] = '\0';
+        decode_line(line);
+        line_len = 0;
+      } else if(line_len < LINE_LEN - 1) {
+        line[line_len++] = c;
+      }
+      continue;
+    }
+
+    if(c == SLIP_END) {
+      if(len == TRACE_FRAME_LEN && frame[0] == TRACE_VERSION) {
+        decode(frame, len);
+        in_frame = 0;
+      } else {
+        /* Empty or out-of-sync frame: take this END as the start of
+           the next frame */
+        if(len != 0) {
+          bad_frames++;
+        }
+        escaped = 0;
+        len = 0;
+      }
+      continue;
+    }
+    if(c == SLIP_ESC) {
+      escaped = 1;
+      continue;
+    }
+    if(escaped) {
+      c = c == SLIP_ESC_END ? SLIP_END : c == SLIP_ESC_ESC ? SLIP_ESC : c;
+      escaped = 0;
+    }
+    if(len < TRACE_FRAME_LEN) {
+      frame[len] = c;
+    }
+    if(len <= TRACE_FRAME_LEN) {
+      len++;
+    }
+  }
+  if(line_len > 0) {
+    line[line_len] = '\0';
+    decode_line(line);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_summary(void)
+{
+  struct node *n;
+
+  fprintf(stderr, "node,records,lost,tx,tx_ok,mac_pdr,rx\n");
+  for(n = nodes; n != NULL; n = n->next) {
+    fprintf(stderr, "%u,%lu,%lu,%lu,%lu,%.3f,%lu\n",
+            n->id, n->records, n->lost, n->tx, n->tx_ok,
+            n->tx != 0 ? (double)n->tx_ok / n->tx : 0.0, n->rx);
+    if(n->out != stdout) {
+      fclose(n->out);
+    }
+  }
+  if(bad_frames != 0) {
+    fprintf(stderr, "%lu malformed frames\n", bad_frames);
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  FILE *in;
+  int c;
+  int i;
+
+  while((c = getopt(argc, argv, "o:h")) != -1) {
+    switch(c) {
+    case 'o':
+      prefix = optarg;
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-o prefix] [file ...]\n", argv[0]);
+      fprintf(stderr, " -o prefix  write one CSV per node to <prefix><node id>.csv\n");
+      return c == 'h' ? 0 : 1;
+    }
+  }
+
+  if(prefix == NULL) {
+    fputs(csv_header, stdout);
+  }
+  if(optind == argc) {
+    decode_stream(stdin);
+  }
+  for(i = optind; i < argc; i++) {
+    in = fopen(argv[i], "rb");
+    if(in == NULL) {
+      perror(argv[i]);
+      return 1;
+    }
+    decode_stream(in);
+    fclose(in);
+  }
+  print_summary();
+  return 0;
+}
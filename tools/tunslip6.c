@@ -48,6 +48,9 @@
 #include <signal.h>
 #include <termios.h>
 #include <sys/ioctl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -70,13 +73,15 @@ int slipfd = 0;
 uint16_t basedelay=0,delaymsec=0;
 uint32_t startsec,startmsec,delaystartsec,delaystartmsec;
 int timestamp = 0, flowcontrol=0, showprogress=0, flowcontrol_xonxoff=0;
+int threaded = 0;
 
 int ssystem(const char *fmt, ...)
      __attribute__((__format__ (__printf__, 1, 2)));
-void write_to_serial(int outfd, void *inbuf, int len);
+void write_to_serial(void *inbuf, int len);
 
 void slip_send(int fd, unsigned char c);
-void slip_send_char(int fd, unsigned char c);
+int slip_encode(unsigned char *dst, const unsigned char *p, int len);
+void queue_to_serial(const unsigned char *p, int len);
 
 #define PROGRESS(s) if(showprogress) fprintf(stderr, s)
 
@@ -164,213 +169,276 @@ is_sensible_string(const unsigned char *s, int len)
   return 1;
 }
 
+#define SLIP_FRAME_SIZE 2000
+/* Large enough for several encoded frames, which are then written to
+   the serial line at once */
+#define SLIP_BUF_SIZE   16384
+/* Worst case of one frame after escaping */
+#define SLIP_MAX_ENCODED (2 * SLIP_FRAME_SIZE + 1)
+
+static unsigned char inbuf[SLIP_FRAME_SIZE];
+static int inbufptr = 0;
+
 /*
- * Read from serial, when we have a packet write it to tun. No output
- * buffering, input buffered by stdio.
+ * Handle a complete SLIP frame from serial: a control message, a debug
+ * string or a packet for tun.
  */
-void
-serial_to_tun(FILE *inslip, int outfd)
+static void
+frame_input(int outfd)
 {
-  static union {
-    unsigned char inbuf[2000];
-  } uip;
-  static int inbufptr = 0;
-  int ret,i;
-  unsigned char c;
-
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) err(1, "serial_to_tun: read");
-  goto after_fread;
-#endif
+  int i;
 
- read_more:
-  if(inbufptr >= sizeof(uip.inbuf)) {
-     if(timestamp) stamptime();
-     fprintf(stderr, "*** dropping large %d byte packet\n",inbufptr);
-	 inbufptr = 0;
-  }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
- after_fread:
-#endif
-  if(ret == -1) {
-    err(1, "serial_to_tun: read");
-  }
-  if(ret == 0) {
-    clearerr(inslip);
-    return;
-  }
-  PROGRESS(".");
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      if(uip.inbuf[0] == '!') {
-	if(uip.inbuf[1] == 'M') {
-	  /* Read gateway MAC address and autoconfigure tap0 interface */
-	  char macs[24];
-	  int i, pos;
-	  for(i = 0, pos = 0; i < 16; i++) {
-	    macs[pos++] = uip.inbuf[2 + i];
-	    if((i & 1) == 1 && i < 14) {
-	      macs[pos++] = ':';
-	    }
-	  }
-          if(timestamp) stamptime();
-	  macs[pos] = '\0';
-//	  printf("*** Gateway's MAC address: %s\n", macs);
-	  fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s down", tundev);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
-          if (timestamp) stamptime();
-	  ssystem("ifconfig %s up", tundev);
-	}
-      } else if(uip.inbuf[0] == '?') {
-	if(uip.inbuf[1] == 'P') {
-          /* Prefix info requested */
-          struct in6_addr addr;
-	  int i;
-	  char *s = strchr(ipaddr, '/');
-	  if(s != NULL) {
-	    *s = '\0';
-	  }
-          inet_pton(AF_INET6, ipaddr, &addr);
-          if(timestamp) stamptime();
-          fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
-		 ipaddr,
-		 addr.s6_addr[0], addr.s6_addr[1],
-		 addr.s6_addr[2], addr.s6_addr[3],
-		 addr.s6_addr[4], addr.s6_addr[5],
-		 addr.s6_addr[6], addr.s6_addr[7]);
-	  slip_send(slipfd, '!');
-	  slip_send(slipfd, 'P');
-	  for(i = 0; i < 8; i++) {
-	    /* need to call the slip_send_char for stuffing */
-	    slip_send_char(slipfd, addr.s6_addr[i]);
-	  }
-	  slip_send(slipfd, SLIP_END);
+  if(inbuf[0] == '!') {
+    if(inbuf[1] == 'M') {
+      /* Read gateway MAC address and autoconfigure tap0 interface */
+      char macs[24];
+      int i, pos;
+      for(i = 0, pos = 0; i < 16; i++) {
+        macs[pos++] = inbuf[2 + i];
+        if((i & 1) == 1 && i < 14) {
+          macs[pos++] = ':';
         }
+      }
+      if(timestamp) stamptime();
+      macs[pos] = '\0';
+//      printf("*** Gateway's MAC address: %s\n", macs);
+      fprintf(stderr,"*** Gateway's MAC address: %s\n", macs);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s down", tundev);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s hw ether %s", tundev, &macs[6]);
+      if (timestamp) stamptime();
+      ssystem("ifconfig %s up", tundev);
+    }
+  } else if(inbuf[0] == '?') {
+    if(inbuf[1] == 'P') {
+      /* Prefix info requested */
+      struct in6_addr addr;
+      unsigned char reply[2 + 2 * 8 + 1];
+      int len;
+      char *s = strchr(ipaddr, '/');
+      if(s != NULL) {
+        *s = '\0';
+      }
+      inet_pton(AF_INET6, ipaddr, &addr);
+      if(timestamp) stamptime();
+      fprintf(stderr,"*** Address:%s => %02x%02x:%02x%02x:%02x%02x:%02x%02x\n",
+             ipaddr,
+             addr.s6_addr[0], addr.s6_addr[1],
+             addr.s6_addr[2], addr.s6_addr[3],
+             addr.s6_addr[4], addr.s6_addr[5],
+             addr.s6_addr[6], addr.s6_addr[7]);
+      reply[0] = '!';
+      reply[1] = 'P';
+      /* slip_encode() does the stuffing and the SLIP_END */
+      len = 2 + slip_encode(reply + 2, addr.s6_addr, 8);
+      queue_to_serial(reply, len);
+    }
 #define DEBUG_LINE_MARKER '\r'
-      } else if(uip.inbuf[0] == DEBUG_LINE_MARKER) {
-	fwrite(uip.inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(uip.inbuf, inbufptr)) {
-        if(verbose==1) {   /* strings already echoed below for verbose>1 */
-          if (timestamp) stamptime();
-          fwrite(uip.inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(verbose>2) {
-          if (timestamp) stamptime();
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if (verbose>4) {
+  } else if(inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
+  } else if(is_sensible_string(inbuf, inbufptr)) {
+    if(verbose==1) {   /* strings already echoed below for verbose>1 */
+      if (timestamp) stamptime();
+      fwrite(inbuf, inbufptr, 1, stdout);
+    }
+  } else {
+    if(verbose>2) {
+      if (timestamp) stamptime();
+      printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
+      if (verbose>4) {
 #if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-	        for(i = 0; i < inbufptr; i++) printf(" %02x",uip.inbuf[i]);
+        printf("0000");
+        for(i = 0; i < inbufptr; i++) printf(" %02x",inbuf[i]);
 #else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", uip.inbuf[i]);
-              if((i & 3) == 3) printf(" ");
-              if((i & 15) == 15) printf("\n         ");
-            }
-#endif
-            printf("\n");
-          }
+        printf("         ");
+        for(i = 0; i < inbufptr; i++) {
+          printf("%02x", inbuf[i]);
+          if((i & 3) == 3) printf(" ");
+          if((i & 15) == 15) printf("\n         ");
         }
-	if(write(outfd, uip.inbuf, inbufptr) != inbufptr) {
-	  err(1, "serial_to_tun: write");
-	}
+#endif
+        printf("\n");
       }
+    }
+    /* tun takes one packet per write */
+    if(write(outfd, inbuf, inbufptr) != inbufptr) {
+      err(1, "serial_to_tun: write");
+    }
+  }
+}
+
+/*
+ * Add decoded bytes to the frame being received.
+ */
+static void
+frame_append(const unsigned char *p, int len)
+{
+  int n;
+
+  while(len > 0) {
+    if(inbufptr >= (int)sizeof(inbuf)) {
+      if(timestamp) stamptime();
+      fprintf(stderr, "*** dropping large %d byte packet\n",inbufptr);
       inbufptr = 0;
     }
-    break;
+    n = sizeof(inbuf) - inbufptr;
+    if(n > len) {
+      n = len;
+    }
+    memcpy(inbuf + inbufptr, p, n);
+    inbufptr += n;
+    p += n;
+    len -= n;
+  }
+}
 
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
+static void
+frame_append_char(unsigned char c)
+{
+  frame_append(&c, 1);
+
+  /* Echo lines as they are received for verbose=2,3,5+ */
+  /* Echo all printable characters for verbose==4 */
+  if((verbose==2) || (verbose==3) || (verbose>4)) {
+    if(c=='\n') {
+      if(is_sensible_string(inbuf, inbufptr)) {
+        if (timestamp) stamptime();
+        fwrite(inbuf, inbufptr, 1, stdout);
+        inbufptr=0;
+      }
+    }
+  } else if(verbose==4) {
+    if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
+      fwrite(&c, 1, 1, stdout);
+      if(c=='\n') if(timestamp) stamptime();
+    }
+  }
+}
+
+/*
+ * Read from serial, when we have a packet write it to tun. Reads all
+ * that is available and decodes it in one pass; an escape split over
+ * two reads is carried over.
+ */
+void
+serial_to_tun(int infd, int outfd)
+{
+  static unsigned char chunk[4096];
+  static int escaped = 0;
+  unsigned char c;
+  int ret, i, run;
+
+  ret = read(infd, chunk, sizeof(chunk));
+  if(ret == -1) {
+    if(errno == EAGAIN || errno == EINTR) {
       return;
     }
+    err(1, "serial_to_tun: read");
+  }
+#ifdef linux
+  if(ret == 0) err(1, "serial_to_tun: read");
+#endif
+  PROGRESS(".");
+
+  for(i = 0; i < ret; i++) {
+    c = chunk[i];
+    if(escaped) {
+      escaped = 0;
+      switch(c) {
+      case SLIP_ESC_END:
+        c = SLIP_END;
+        break;
+      case SLIP_ESC_ESC:
+        c = SLIP_ESC;
+        break;
+      case SLIP_ESC_XON:
+        c = XON;
+        break;
+      case SLIP_ESC_XOFF:
+        c = XOFF;
+        break;
+      }
+      frame_append_char(c);
+      continue;
+    }
 
     switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
-    case SLIP_ESC_XON:
-      c = XON;
+    case SLIP_END:
+      if(inbufptr > 0) {
+        frame_input(outfd);
+        inbufptr = 0;
+      }
       break;
-    case SLIP_ESC_XOFF:
-      c = XOFF;
+
+    case SLIP_ESC:
+      escaped = 1;
       break;
-    }
-    /* FALLTHROUGH */
-  default:
-    uip.inbuf[inbufptr++] = c;
-
-    /* Echo lines as they are received for verbose=2,3,5+ */
-    /* Echo all printable characters for verbose==4 */
-    if((verbose==2) || (verbose==3) || (verbose>4)) {
-      if(c=='\n') {
-        if(is_sensible_string(uip.inbuf, inbufptr)) {
-          if (timestamp) stamptime();
-          fwrite(uip.inbuf, inbufptr, 1, stdout);
-          inbufptr=0;
-        }
+
+    default:
+      if(verbose >= 2) {
+        frame_append_char(c);
+        break;
       }
-    } else if(verbose==4) {
-      if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
-	fwrite(&c, 1, 1, stdout);
-        if(c=='\n') if(timestamp) stamptime();
+      /* Copy the run of plain bytes at once */
+      for(run = i + 1; run < ret; run++) {
+        if(chunk[run] == SLIP_END || chunk[run] == SLIP_ESC) {
+          break;
+        }
       }
+      frame_append(chunk + i, run - i);
+      i = run - 1;
+      break;
     }
-
-    break;
   }
-
-  goto read_more;
 }
 
-unsigned char slip_buf[2000];
+unsigned char slip_buf[SLIP_BUF_SIZE];
 int slip_end, slip_begin;
 
-void
-slip_send_char(int fd, unsigned char c)
+/*
+ * Escape len bytes into dst and terminate the frame. dst must have room
+ * for 2 * len + 1 bytes. Returns the encoded length.
+ */
+int
+slip_encode(unsigned char *dst, const unsigned char *p, int len)
 {
-  switch(c) {
-  case SLIP_END:
-    slip_send(fd, SLIP_ESC);
-    slip_send(fd, SLIP_ESC_END);
-    break;
-  case SLIP_ESC:
-    slip_send(fd, SLIP_ESC);
-    slip_send(fd, SLIP_ESC_ESC);
-    break;
-  case XON:
-    if(flowcontrol_xonxoff) {
-      slip_send(fd, SLIP_ESC);
-      slip_send(fd, SLIP_ESC_XON);
-    } else {
-      slip_send(fd, c);
-    }
-    break;
-  case XOFF:
-    if(flowcontrol_xonxoff) {
-      slip_send(fd, SLIP_ESC);
-      slip_send(fd, SLIP_ESC_XOFF);
-    } else {
-      slip_send(fd, c);
+  unsigned char *d = dst;
+  int i;
+
+  for(i = 0; i < len; i++) {
+    switch(p[i]) {
+    case SLIP_END:
+      *d++ = SLIP_ESC;
+      *d++ = SLIP_ESC_END;
+      break;
+    case SLIP_ESC:
+      *d++ = SLIP_ESC;
+      *d++ = SLIP_ESC_ESC;
+      break;
+    case XON:
+      if(flowcontrol_xonxoff) {
+        *d++ = SLIP_ESC;
+        *d++ = SLIP_ESC_XON;
+      } else {
+        *d++ = p[i];
+      }
+      break;
+    case XOFF:
+      if(flowcontrol_xonxoff) {
+        *d++ = SLIP_ESC;
+        *d++ = SLIP_ESC_XOFF;
+      } else {
+        *d++ = p[i];
+      }
+      break;
+    default:
+      *d++ = p[i];
+      break;
     }
-    break;
-  default:
-    slip_send(fd, c);
-    break;
   }
+  *d++ = SLIP_END;
+  return d - dst;
 }
 
 void
@@ -412,8 +480,86 @@ slip_flushbuf(int fd)
   }
 }
 
+/*
+ * With -R, frames for serial produced by the reader thread are passed
+ * to the main thread, which owns slip_buf, through a single-producer,
+ * single-consumer ring. A pipe wakes up the main thread.
+ */
+#define CTRL_RING_SIZE 256 /* Power of two */
+static unsigned char ctrl_ring[CTRL_RING_SIZE];
+static atomic_uint ctrl_head, ctrl_tail;
+static int wakefd[2] = { -1, -1 };
+
 void
-write_to_serial(int outfd, void *inbuf, int len)
+queue_to_serial(const unsigned char *p, int len)
+{
+  unsigned head, tail;
+  int i;
+
+  if(!threaded) {
+    if((int)sizeof(slip_buf) - slip_end < len) {
+      err(1, "slip_send overflow");
+    }
+    memcpy(slip_buf + slip_end, p, len);
+    slip_end += len;
+    return;
+  }
+
+  head = atomic_load_explicit(&ctrl_head, memory_order_relaxed);
+  tail = atomic_load_explicit(&ctrl_tail, memory_order_acquire);
+  if(CTRL_RING_SIZE - (head - tail) < (unsigned)len) {
+    fprintf(stderr, "*** dropping %d byte frame for serial\n", len);
+    return;
+  }
+  for(i = 0; i < len; i++) {
+    ctrl_ring[(head + i) & (CTRL_RING_SIZE - 1)] = p[i];
+  }
+  atomic_store_explicit(&ctrl_head, head + len, memory_order_release);
+  if(write(wakefd[1], "", 1) < 0) {
+    /* The pipe is full, so the main thread is already woken up */
+  }
+}
+
+/*
+ * Move queued frames from the reader thread into slip_buf.
+ */
+static void
+dequeue_to_serial(void)
+{
+  unsigned head, tail;
+  char c;
+
+  while(read(wakefd[0], &c, 1) > 0);
+
+  head = atomic_load_explicit(&ctrl_head, memory_order_acquire);
+  tail = atomic_load_explicit(&ctrl_tail, memory_order_relaxed);
+  while(tail != head && slip_end < (int)sizeof(slip_buf)) {
+    slip_buf[slip_end++] = ctrl_ring[tail & (CTRL_RING_SIZE - 1)];
+    tail++;
+  }
+  atomic_store_explicit(&ctrl_tail, tail, memory_order_release);
+}
+
+static void *
+serial_reader(void *arg)
+{
+  int tunfd = *(int *)arg;
+  struct pollfd pfd;
+
+  pfd.fd = slipfd;
+  pfd.events = POLLIN;
+  while(1) {
+    if(poll(&pfd, 1, -1) > 0) {
+      serial_to_tun(slipfd, tunfd);
+    } else if(errno != EINTR) {
+      err(1, "poll");
+    }
+  }
+  return NULL;
+}
+
+void
+write_to_serial(void *inbuf, int len)
 {
   u_int8_t *p = inbuf;
   int i;
@@ -440,59 +586,39 @@ write_to_serial(int outfd, void *inbuf, int len)
   /* It would be ``nice'' to send a SLIP_END here but it's not
    * really necessary.
    */
-  /* slip_send(outfd, SLIP_END); */
+  /* slip_send(slipfd, SLIP_END); */
 
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_ESC);
-      break;
-    case XON:
-      if(flowcontrol_xonxoff) {
-        slip_send(outfd, SLIP_ESC);
-        slip_send(outfd, SLIP_ESC_XON);
-      } else {
-        slip_send(outfd, p[i]);
-      }
-      break;
-    case XOFF:
-      if(flowcontrol_xonxoff) {
-        slip_send(outfd, SLIP_ESC);
-        slip_send(outfd, SLIP_ESC_XOFF);
-      } else {
-        slip_send(outfd, p[i]);
-      }
-      break;
-    default:
-      slip_send(outfd, p[i]);
-      break;
-    }
+  if((int)sizeof(slip_buf) - slip_end < 2 * len + 1) {
+    err(1, "slip_send overflow");
   }
-  slip_send(outfd, SLIP_END);
+  slip_end += slip_encode(slip_buf + slip_end, p, len);
   PROGRESS("t");
 }
 
 
 /*
- * Read from tun, write to slip.
+ * Read from tun, write to slip. Without an outgoing delay, all queued
+ * packets that fit in slip_buf are read, to be written out at once.
  */
 int
-tun_to_serial(int infd, int outfd)
+tun_to_serial(int infd)
 {
-  struct {
-    unsigned char inbuf[2000];
-  } uip;
-  int size;
-
-  if((size = read(infd, uip.inbuf, 2000)) == -1) err(1, "tun_to_serial: read");
-
-  write_to_serial(outfd, uip.inbuf, size);
-  return size;
+  static unsigned char buf[SLIP_FRAME_SIZE];
+  int size, total;
+
+  total = 0;
+  do {
+    if((size = read(infd, buf, sizeof(buf))) == -1) {
+      if(errno == EAGAIN || errno == EINTR) {
+        break;
+      }
+      err(1, "tun_to_serial: read");
+    }
+    write_to_serial(buf, size);
+    total += size;
+  } while(basedelay == 0 &&
+          (int)sizeof(slip_buf) - slip_end >= SLIP_MAX_ENCODED);
+  return total;
 }
 
 void
@@ -749,7 +875,7 @@ main(int argc, char **argv)
   int tunfd, maxfd;
   int ret;
   fd_set rset, wset;
-  FILE *inslip;
+  pthread_t reader;
   const char *siodev = NULL;
   const char *host = NULL;
   const char *port = NULL;
@@ -762,7 +888,7 @@ main(int argc, char **argv)
   prog = argv[0];
   setvbuf(stdout, NULL, _IOLBF, 0); /* Line buffered output. */
 
-  while((c = getopt(argc, argv, "B:HILPhXM:s:t:v::d::a:p:T")) != -1) {
+  while((c = getopt(argc, argv, "B:HILPhXM:Rs:t:v::d::a:p:T")) != -1) {
     switch(c) {
     case 'B':
       baudrate = atoi(optarg);
@@ -790,6 +916,10 @@ main(int argc, char **argv)
       showprogress=1;
       break;
 
+    case 'R':
+      threaded = 1;
+      break;
+
     case 's':
       if(strncmp("/dev/", optarg, 5) == 0) {
 	siodev = optarg + 5;
@@ -850,6 +980,7 @@ fprintf(stderr," -X             Software XON/XOFF flow control (default disabled
 fprintf(stderr," -L             Log output format (adds time stamps)\n");
 fprintf(stderr," -s siodev      Serial device (default /dev/ttyUSB0)\n");
 fprintf(stderr," -M             Interface MTU (default and min: 1280)\n");
+fprintf(stderr," -R             Read and decode serial input in a separate thread\n");
 fprintf(stderr," -T             Make tap interface (default is tun interface)\n");
 fprintf(stderr," -t tundev      Name of interface (default tap0 or tun0)\n");
 fprintf(stderr," -v[level]      Verbosity level\n");
@@ -957,11 +1088,11 @@ exit(1);
     stty_telos(slipfd);
   }
   slip_send(slipfd, SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) err(1, "main: fdopen");
 
   tunfd = tun_alloc(tundev, tap);
   if(tunfd == -1) err(1, "main: open /dev/tun");
+  /* Lets tun_to_serial() read until the queue is empty */
+  fcntl(tunfd, F_SETFL, fcntl(tunfd, F_GETFL) | O_NONBLOCK);
   if (timestamp) stamptime();
   fprintf(stderr, "opened %s device ``/dev/%s''\n",
           tap ? "tap" : "tun", tundev);
@@ -973,11 +1104,30 @@ exit(1);
   signal(SIGALRM, sigalarm);
   ifconf(tundev, ipaddr);
 
+  if(threaded) {
+    sigset_t sigs, oldsigs;
+
+    if(pipe(wakefd) == -1) err(1, "main: pipe");
+    fcntl(wakefd[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakefd[1], F_SETFL, O_NONBLOCK);
+    /* Signals are handled by the main thread only */
+    sigfillset(&sigs);
+    pthread_sigmask(SIG_BLOCK, &sigs, &oldsigs);
+    if(pthread_create(&reader, NULL, serial_reader, &tunfd) != 0) {
+      err(1, "main: pthread_create");
+    }
+    pthread_sigmask(SIG_SETMASK, &oldsigs, NULL);
+  }
+
   while(1) {
     maxfd = 0;
     FD_ZERO(&rset);
     FD_ZERO(&wset);
 
+    if(threaded) {
+      dequeue_to_serial();
+    }
+
     if(got_sigalarm && ipa_enable) {
       /* Send "?IPA". */
       slip_send(slipfd, '?');
@@ -992,7 +1142,12 @@ exit(1);
       FD_SET(slipfd, &wset);
     }
 
-    FD_SET(slipfd, &rset);	/* Read from slip ASAP! */
+    if(threaded) {
+      FD_SET(wakefd[0], &rset);
+      if(wakefd[0] > maxfd) maxfd = wakefd[0];
+    } else {
+      FD_SET(slipfd, &rset);	/* Read from slip ASAP! */
+    }
     if(slipfd > maxfd) maxfd = slipfd;
 
     /* We only have one packet at a time queued for slip output. */
@@ -1005,8 +1160,8 @@ exit(1);
     if(ret == -1 && errno != EINTR) {
       err(1, "select");
     } else if(ret > 0) {
-      if(FD_ISSET(slipfd, &rset)) {
-        serial_to_tun(inslip, tunfd);
+      if(!threaded && FD_ISSET(slipfd, &rset)) {
+        serial_to_tun(slipfd, tunfd);
       }
 
       if(FD_ISSET(slipfd, &wset)) {
@@ -1027,7 +1182,7 @@ exit(1);
       if(delaymsec==0) {
         int size;
         if(slip_empty() && FD_ISSET(tunfd, &rset)) {
-          size=tun_to_serial(tunfd, slipfd);
+          size=tun_to_serial(tunfd);
           slip_flushbuf(slipfd);
           if(ipa_enable) sigalarm_reset();
           if(basedelay) {